@@ -0,0 +1,95 @@
+#include "arena.h"
+
+#include "stdlib.h"
+#include "string.h"
+
+#include "gamealloc.h"
+
+// NOTE: This file must not include raylib.h, windows.h clashes with it
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+static void* OsAllocate(size_t size)
+{
+#if defined(_WIN32)
+    // NOTE: MEM_LARGE_PAGES needs SeLockMemoryPrivilege, regular pages are used instead
+    return VirtualAlloc(NULL, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+    void* memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED)
+    {
+        return NULL;
+    }
+#if defined(MADV_HUGEPAGE)
+    madvise(memory, size, MADV_HUGEPAGE);
+#endif
+    return memory;
+#endif
+}
+
+static void OsFree(void* memory, size_t size)
+{
+#if defined(_WIN32)
+    (void)size;
+    VirtualFree(memory, 0, MEM_RELEASE);
+#else
+    munmap(memory, size);
+#endif
+}
+
+bool ArenaInit(Arena* arena, size_t capacity)
+{
+    memset(arena, 0, sizeof(*arena));
+    if (capacity == 0)
+    {
+        return true;
+    }
+
+    // Arenas are only ever replaced by larger ones, so every block counts as geometric growth
+    arena->osBacked = capacity >= ARENA_HUGE_PAGE_THRESHOLD;
+    GameCountAllocation(true);
+    arena->base = arena->osBacked ? (uint8_t*)OsAllocate(capacity) : (uint8_t*)malloc(capacity);
+    if (arena->base == NULL)
+    {
+        return false;
+    }
+    arena->capacity = capacity;
+    return true;
+}
+
+void ArenaRelease(Arena* arena)
+{
+    if (arena->base != NULL)
+    {
+        if (arena->osBacked)
+        {
+            OsFree(arena->base, arena->capacity);
+        }
+        else
+        {
+            free(arena->base);
+        }
+    }
+    memset(arena, 0, sizeof(*arena));
+}
+
+void* ArenaPush(Arena* arena, size_t size, size_t alignment)
+{
+    const size_t start = (arena->used + alignment - 1) & ~(alignment - 1);
+    if (start + size > arena->capacity)
+    {
+        return NULL;
+    }
+    arena->used = start + size;
+    return arena->base + start;
+}
+
+void ArenaReset(Arena* arena)
+{
+    arena->used = 0;
+}
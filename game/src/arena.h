@@ -0,0 +1,22 @@
+#pragma once
+
+#include "stdbool.h"
+#include "stddef.h"
+#include "stdint.h"
+
+// Linear allocator over a single block. Blocks above ARENA_HUGE_PAGE_THRESHOLD come straight
+// from the OS and are hinted for transparent huge pages where that is available.
+#define ARENA_HUGE_PAGE_THRESHOLD (2u * 1024u * 1024u)
+
+typedef struct Arena_t
+{
+    uint8_t* base;
+    size_t capacity;
+    size_t used;
+    bool osBacked;
+} Arena;
+
+bool ArenaInit(Arena* arena, size_t capacity);
+void ArenaRelease(Arena* arena);
+void* ArenaPush(Arena* arena, size_t size, size_t alignment); // Returns NULL if the arena is exhausted
+void ArenaReset(Arena* arena);
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "stdbool.h"
+#include "stddef.h"
+#include "stdint.h"
+
+// Helpers for bit-packed sequences, bit i lives in word i / 64 at position i % 64
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_AMD64))
+#include <intrin.h>
+#endif
+
+static inline int Popcount64(uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(word);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_AMD64))
+    return (int)__popcnt64(word);
+#else
+    word = word - ((word >> 1) & 0x5555555555555555ull);
+    word = (word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull);
+    word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0full;
+    return (int)((word * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+// Index of the lowest set bit, word must not be 0
+static inline int CountTrailingZeros64(uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_AMD64))
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return (int)index;
+#else
+    int count = 0;
+    while ((word & 1) == 0)
+    {
+        word >>= 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+static inline size_t BitWordCount(size_t bitCount) { return (bitCount + 63) / 64; }
+
+static inline bool BitGet(const uint64_t* words, size_t index)
+{
+    return (words[index >> 6] >> (index & 63)) & 1;
+}
+
+static inline void BitSet(uint64_t* words, size_t index, bool value)
+{
+    const uint64_t mask = 1ull << (index & 63);
+    words[index >> 6] = value ? (words[index >> 6] | mask) : (words[index >> 6] & ~mask);
+}
+
+// Number of set bits in [start, start + count)
+static inline int PopcountRange(const uint64_t* words, size_t start, size_t count)
+{
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    const size_t end = start + count;
+    const size_t firstWord = start >> 6;
+    const size_t lastWord = (end - 1) >> 6;
+    const uint64_t firstMask = ~0ull << (start & 63);
+    const uint64_t lastMask = ~0ull >> (63 - ((end - 1) & 63));
+    if (firstWord == lastWord)
+    {
+        return Popcount64(words[firstWord] & firstMask & lastMask);
+    }
+
+    int result = Popcount64(words[firstWord] & firstMask);
+    for (size_t i = firstWord + 1; i < lastWord; ++i)
+    {
+        result += Popcount64(words[i]);
+    }
+    return result + Popcount64(words[lastWord] & lastMask);
+}
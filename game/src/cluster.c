@@ -0,0 +1,225 @@
+#include "cluster.h"
+
+#include "stdio.h"
+#include "string.h"
+
+// NOTE: This file must not include raylib.h, windows.h clashes with it
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#if defined(_MSC_VER)
+#pragma comment(lib, "ws2_32.lib")
+#endif
+typedef SOCKET SocketHandle;
+#define INVALID_SOCKET_HANDLE INVALID_SOCKET
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+typedef int SocketHandle;
+#define INVALID_SOCKET_HANDLE (-1)
+#endif
+
+static bool ParseAddress(const char* text, uint32_t* address, uint16_t* port)
+{
+    unsigned int a, b, c, d, p;
+    if (sscanf(text, "%u.%u.%u.%u:%u", &a, &b, &c, &d, &p) != 5 || a > 255 || b > 255 || c > 255 || d > 255 || p == 0 || p > 65535)
+    {
+        return false;
+    }
+    *address = (a << 24) | (b << 16) | (c << 8) | d;
+    *port = (uint16_t)p;
+    return true;
+}
+
+static bool IsMulticast(uint32_t address)
+{
+    return (address >> 28) == 0xe;
+}
+
+static uint32_t InterfaceAddress(const char* text)
+{
+    unsigned int a, b, c, d;
+    if (text == NULL || sscanf(text, "%u.%u.%u.%u", &a, &b, &c, &d) != 4)
+    {
+        return INADDR_ANY;
+    }
+    return (a << 24) | (b << 16) | (c << 8) | d;
+}
+
+static struct sockaddr_in SocketAddress(uint32_t address, uint16_t port)
+{
+    struct sockaddr_in socketAddress;
+    memset(&socketAddress, 0, sizeof(socketAddress));
+    socketAddress.sin_family = AF_INET;
+    socketAddress.sin_addr.s_addr = htonl(address);
+    socketAddress.sin_port = htons(port);
+    return socketAddress;
+}
+
+static SocketHandle OpenSocket(void)
+{
+#if defined(_WIN32)
+    WSADATA data;
+    if (WSAStartup(MAKEWORD(2, 2), &data) != 0)
+    {
+        return INVALID_SOCKET_HANDLE;
+    }
+#endif
+
+    SocketHandle handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (handle == INVALID_SOCKET_HANDLE)
+    {
+        return handle;
+    }
+
+#if defined(_WIN32)
+    u_long nonBlocking = 1;
+    ioctlsocket(handle, FIONBIO, &nonBlocking);
+#else
+    fcntl(handle, F_SETFL, fcntl(handle, F_GETFL, 0) | O_NONBLOCK);
+#endif
+    return handle;
+}
+
+static void CloseSocket(SocketHandle handle)
+{
+#if defined(_WIN32)
+    closesocket(handle);
+    WSACleanup();
+#else
+    close(handle);
+#endif
+}
+
+bool ClusterOpenCoordinator(ClusterSocket* cluster, const char* destinations, const char* interfaceAddress, uint64_t session)
+{
+    memset(cluster, 0, sizeof(*cluster));
+    cluster->session = session;
+    bool multicast = false;
+    for (const char* destination = destinations; destination != NULL && cluster->destinationCount < CLUSTER_MAX_DESTINATIONS;)
+    {
+        const int index = cluster->destinationCount;
+        if (!ParseAddress(destination, &cluster->destinationAddresses[index], &cluster->destinationPorts[index]))
+        {
+            return false;
+        }
+        multicast |= IsMulticast(cluster->destinationAddresses[index]);
+        cluster->destinationCount++;
+        destination = strchr(destination, ',');
+        destination = destination != NULL ? destination + 1 : NULL;
+    }
+
+    SocketHandle handle = cluster->destinationCount > 0 ? OpenSocket() : INVALID_SOCKET_HANDLE;
+    if (handle == INVALID_SOCKET_HANDLE)
+    {
+        return false;
+    }
+
+    if (multicast)
+    {
+        // One hop, and copies for the receivers on this machine
+        const unsigned char ttl = 1;
+        const unsigned char loop = 1;
+        struct in_addr multicastInterface;
+        multicastInterface.s_addr = htonl(InterfaceAddress(interfaceAddress));
+        setsockopt(handle, IPPROTO_IP, IP_MULTICAST_TTL, (const char*)&ttl, sizeof(ttl));
+        setsockopt(handle, IPPROTO_IP, IP_MULTICAST_LOOP, (const char*)&loop, sizeof(loop));
+        setsockopt(handle, IPPROTO_IP, IP_MULTICAST_IF, (const char*)&multicastInterface, sizeof(multicastInterface));
+    }
+    cluster->handle = (intptr_t)handle;
+    return true;
+}
+
+bool ClusterOpenNode(ClusterSocket* cluster, const char* address, const char* interfaceAddress)
+{
+    memset(cluster, 0, sizeof(*cluster));
+    uint32_t groupAddress;
+    uint16_t port;
+    if (!ParseAddress(address, &groupAddress, &port))
+    {
+        return false;
+    }
+
+    SocketHandle handle = OpenSocket();
+    if (handle == INVALID_SOCKET_HANDLE)
+    {
+        return false;
+    }
+
+    // Several nodes on one machine share the port, every one of them gets each multicast datagram
+    const int reuse = 1;
+    setsockopt(handle, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse));
+    const bool multicast = IsMulticast(groupAddress);
+    const struct sockaddr_in bindAddress = SocketAddress(multicast ? INADDR_ANY : groupAddress, port);
+    bool opened = bind(handle, (const struct sockaddr*)&bindAddress, sizeof(bindAddress)) == 0;
+    if (opened && multicast)
+    {
+        struct ip_mreq membership;
+        membership.imr_multiaddr.s_addr = htonl(groupAddress);
+        membership.imr_interface.s_addr = htonl(InterfaceAddress(interfaceAddress));
+        opened = setsockopt(handle, IPPROTO_IP, IP_ADD_MEMBERSHIP, (const char*)&membership, sizeof(membership)) == 0;
+    }
+    if (!opened)
+    {
+        CloseSocket(handle);
+        return false;
+    }
+
+    cluster->handle = (intptr_t)handle;
+    return true;
+}
+
+bool ClusterSend(ClusterSocket* cluster, ClusterMessage* message)
+{
+    memcpy(message->magic, CLUSTER_MAGIC, sizeof(message->magic));
+    message->version = CLUSTER_VERSION;
+    message->size = sizeof(ClusterMessage);
+    message->session = cluster->session;
+    message->sequence = ++cluster->sequence;
+
+    bool sent = true;
+    for (int i = 0; i < cluster->destinationCount; ++i)
+    {
+        const struct sockaddr_in destination = SocketAddress(cluster->destinationAddresses[i], cluster->destinationPorts[i]);
+        sent &= sendto((SocketHandle)cluster->handle, (const char*)message, sizeof(*message), 0,
+            (const struct sockaddr*)&destination, sizeof(destination)) == (int)sizeof(*message);
+    }
+    return sent;
+}
+
+bool ClusterReceive(ClusterSocket* cluster, ClusterMessage* message)
+{
+    while (true)
+    {
+        const int received = (int)recv((SocketHandle)cluster->handle, (char*)message, sizeof(*message), 0);
+        if (received < 0)
+        {
+            return false; // Nothing queued, or an error that the next frame will see again
+        }
+
+        const bool valid = received == (int)sizeof(*message) && memcmp(message->magic, CLUSTER_MAGIC, sizeof(message->magic)) == 0
+            && message->version == CLUSTER_VERSION && message->size == sizeof(ClusterMessage);
+        const bool newer = !cluster->received || message->session != cluster->session || message->sequence > cluster->sequence;
+        if (valid && newer)
+        {
+            cluster->received = true;
+            cluster->session = message->session;
+            cluster->sequence = message->sequence;
+            return true;
+        }
+    }
+}
+
+void ClusterClose(ClusterSocket* cluster)
+{
+    if (cluster->handle != 0)
+    {
+        CloseSocket((SocketHandle)cluster->handle);
+    }
+    memset(cluster, 0, sizeof(*cluster));
+}
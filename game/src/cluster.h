@@ -0,0 +1,56 @@
+#pragma once
+
+#include "stdbool.h"
+#include "stdint.h"
+
+// Display wall sync. The coordinator sends the whole generator state of the global grid in one UDP
+// datagram every frame, and every node rebuilds its slice from it. Stitches are a function of
+// (seed, global index - origin), so a node needs no history. A lost datagram only delays that node
+// by a frame, and a node that joins late is in sync after its first datagram.
+#define CLUSTER_MAGIC "HTMZ"
+#define CLUSTER_VERSION 1
+#define CLUSTER_MAX_DESTINATIONS 16
+
+typedef struct ClusterMessage_t
+{
+    char magic[4];
+    uint16_t version;
+    uint16_t size;
+    uint64_t session;  // Random per coordinator run, so a restarted coordinator is not taken for an old one
+    uint64_t sequence; // Datagram counter, older datagrams that arrive late are dropped
+    uint64_t tick;     // Pattern updates so far
+
+    uint64_t seed;
+    int64_t horizontalOrigin; // Global grid, a node subtracts its own offset
+    int64_t verticalOrigin;
+    uint32_t horizontalProbability; // Raw float bits
+    uint32_t verticalProbability;
+    int32_t cellSize;
+    int32_t lodShift;
+    int32_t updateType;
+    int32_t originIsland; // Island of global cell (0, 0), 0 while nothing was colored yet
+    uint8_t horizontalFlipped;
+    uint8_t verticalFlipped;
+    uint8_t diagonalScrollDirection;
+    uint8_t colored;
+    uint32_t reserved;
+} ClusterMessage;
+
+typedef struct ClusterSocket_t
+{
+    intptr_t handle;
+    int destinationCount;
+    uint32_t destinationAddresses[CLUSTER_MAX_DESTINATIONS]; // IPv4, host byte order
+    uint16_t destinationPorts[CLUSTER_MAX_DESTINATIONS];
+    uint64_t session;  // Sent by the coordinator, last one seen by a node
+    uint64_t sequence; // Last sent or accepted
+    bool received;
+} ClusterSocket;
+
+// Addresses are "a.b.c.d:port", a multicast group is joined on the given interface (NULL for any,
+// 127.0.0.1 to run several processes on one machine). The coordinator takes a comma separated list.
+bool ClusterOpenCoordinator(ClusterSocket* cluster, const char* destinations, const char* interfaceAddress, uint64_t session);
+bool ClusterOpenNode(ClusterSocket* cluster, const char* address, const char* interfaceAddress);
+bool ClusterSend(ClusterSocket* cluster, ClusterMessage* message); // Fills in the header fields
+bool ClusterReceive(ClusterSocket* cluster, ClusterMessage* message); // Next valid datagram, false when none is queued
+void ClusterClose(ClusterSocket* cluster);
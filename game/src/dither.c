@@ -0,0 +1,657 @@
+#include "dither.h"
+
+#include "stdarg.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+#include "raylib.h"
+
+#include "bits.h"
+#include "gamealloc.h"
+#include "generator.h"
+#include "islandmap.h"
+#include "patternfile.h"
+#include "timer.h"
+#include "workpool.h"
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+#define DITHER_LINE_SIZE 1024
+#define DITHER_TOKEN_SIZE 32
+#define DITHER_ODD_COLUMNS 0xaaaaaaaaaaaaaaaaull
+#define DITHER_BAND_CELLS 64 // Cell rows per band, one word of every target column
+
+typedef enum
+{
+    DITHER_PHASE_SUMS,
+    DITHER_PHASE_TARGET,
+    DITHER_PHASE_RENDER,
+} DitherPhase;
+
+typedef struct Dither_t
+{
+    const DitherConfig* config;
+    int frameWidth; // Pixels
+    int frameHeight;
+    char frameRate[DITHER_TOKEN_SIZE]; // Y4M header tokens passed on to the output
+    char aspect[DITHER_TOKEN_SIZE];
+    size_t chromaBytes; // Skipped after the luma plane of every input frame
+
+    int gridWidth; // Cells
+    int gridHeight;
+    size_t rowWords;
+    size_t columnWords;
+    int bandCount;
+    int threadCount;
+    DitherPhase phase; // Job the bands run
+    uint32_t* cellSums;
+    uint64_t* bandTotals; // Luma of every band
+    uint64_t frameTotal;
+    uint64_t* targetRows; // Red where the cell is dark, with the checkerboard of IslandMapFill folded in
+    uint64_t* targetColumns; // The same transposed
+    uint64_t* columnParities; // A, kept from frame to frame
+    uint64_t* rowParities; // B
+    bool* horizontalSequence;
+    bool* verticalSequence;
+    int originIsland;
+    IslandMap islands;
+    uint64_t* islandPrefix; // Scratch of IslandMapFill
+
+    uint8_t* luma; // Input frame
+    uint8_t* chroma;
+    int* pixelCells; // Cell column of every pixel column
+    uint8_t* redMask; // Output frame, one byte per pixel
+    uint8_t* output; // Y4M planes
+    int colorY[2]; // Green and red
+    int colorCb[2];
+    int colorCr[2];
+
+    // Totals for the summary
+    int64_t frameCount;
+    int64_t passCount;
+    int64_t mismatchCount;
+    uint64_t targetNs;
+    uint64_t solveNs;
+    uint64_t renderNs;
+} Dither;
+
+static void LogToStderr(int logLevel, const char* text, va_list args)
+{
+    static const char* prefixes[] = { "", "TRACE: ", "DEBUG: ", "INFO: ", "WARNING: ", "ERROR: ", "FATAL: " };
+    fputs(logLevel >= 0 && logLevel < (int)(sizeof(prefixes) / sizeof(prefixes[0])) ? prefixes[logLevel] : "", stderr);
+    vfprintf(stderr, text, args);
+    fputc('\n', stderr);
+}
+
+static bool ReadLine(FILE* file, char* line, size_t size)
+{
+    size_t length = 0;
+    int c;
+    while ((c = fgetc(file)) != EOF && c != '\n')
+    {
+        if (length + 1 >= size)
+        {
+            return false;
+        }
+        line[length++] = (char)c;
+    }
+    line[length] = '\0';
+    return c == '\n';
+}
+
+static bool ChromaBytes(const char* colorspace, int width, int height, size_t* bytes)
+{
+    const size_t halfWidth = (size_t)(width + 1) / 2;
+    const size_t halfHeight = (size_t)(height + 1) / 2;
+    if (strcmp(colorspace, "420") == 0 || strcmp(colorspace, "420jpeg") == 0 || strcmp(colorspace, "420paldv") == 0 || strcmp(colorspace, "420mpeg2") == 0)
+    {
+        *bytes = 2 * halfWidth * halfHeight;
+    }
+    else if (strcmp(colorspace, "422") == 0)
+    {
+        *bytes = 2 * halfWidth * (size_t)height;
+    }
+    else if (strcmp(colorspace, "444") == 0)
+    {
+        *bytes = 2 * (size_t)width * height;
+    }
+    else if (strcmp(colorspace, "444alpha") == 0)
+    {
+        *bytes = 3 * (size_t)width * height;
+    }
+    else if (strcmp(colorspace, "mono") == 0)
+    {
+        *bytes = 0;
+    }
+    else
+    {
+        return false; // Deeper than 8 bits
+    }
+    return true;
+}
+
+static bool ReadVideoHeader(Dither* dither, FILE* input)
+{
+    char line[DITHER_LINE_SIZE];
+    if (!ReadLine(input, line, sizeof(line)) || strncmp(line, "YUV4MPEG2 ", 10) != 0)
+    {
+        TraceLog(LOG_WARNING, "DITHER: Input is not a Y4M stream");
+        return false;
+    }
+
+    const char* colorspace = "420";
+    for (char* token = strtok(line + 10, " "); token != NULL; token = strtok(NULL, " "))
+    {
+        switch (token[0])
+        {
+        case 'W': dither->frameWidth = atoi(token + 1); break;
+        case 'H': dither->frameHeight = atoi(token + 1); break;
+        case 'C': colorspace = token + 1; break;
+        case 'F': snprintf(dither->frameRate, sizeof(dither->frameRate), "%s", token); break;
+        case 'A': snprintf(dither->aspect, sizeof(dither->aspect), "%s", token); break;
+        default: break;
+        }
+    }
+    if (dither->frameWidth <= 0 || dither->frameHeight <= 0 || !ChromaBytes(colorspace, dither->frameWidth, dither->frameHeight, &dither->chromaBytes))
+    {
+        TraceLog(LOG_WARNING, "DITHER: Unsupported Y4M stream %dx%d C%s", dither->frameWidth, dither->frameHeight, colorspace);
+        return false;
+    }
+    return true;
+}
+
+// False at the end of the stream
+static bool ReadVideoFrame(Dither* dither, FILE* input)
+{
+    char line[DITHER_LINE_SIZE];
+    if (!ReadLine(input, line, sizeof(line)))
+    {
+        return false;
+    }
+    const size_t lumaBytes = (size_t)dither->frameWidth * dither->frameHeight;
+    if (strncmp(line, "FRAME", 5) != 0 || fread(dither->luma, 1, lumaBytes, input) != lumaBytes
+        || fread(dither->chroma, 1, dither->chromaBytes, input) != dither->chromaBytes)
+    {
+        TraceLog(LOG_WARNING, "DITHER: Truncated Y4M frame %lld", (long long)dither->frameCount);
+        return false;
+    }
+    return true;
+}
+
+static bool AllocateDither(Dither* dither)
+{
+    const int cellPixels = dither->config->cellPixels;
+    dither->gridWidth = (dither->frameWidth + cellPixels - 1) / cellPixels;
+    dither->gridHeight = (dither->frameHeight + cellPixels - 1) / cellPixels;
+    dither->rowWords = BitWordCount((size_t)dither->gridWidth);
+    dither->columnWords = BitWordCount((size_t)dither->gridHeight);
+    dither->bandCount = (dither->gridHeight + DITHER_BAND_CELLS - 1) / DITHER_BAND_CELLS;
+    dither->threadCount = dither->config->threadCount > 0 ? dither->config->threadCount : WorkPoolDefaultThreadCount();
+
+    const size_t pixelCount = (size_t)dither->frameWidth * dither->frameHeight;
+    const size_t outputBytes = pixelCount + 2 * (size_t)((dither->frameWidth + 1) / 2) * ((dither->frameHeight + 1) / 2);
+    dither->cellSums = (uint32_t*)GameAlloc((size_t)dither->gridWidth * dither->gridHeight * sizeof(uint32_t));
+    dither->bandTotals = (uint64_t*)GameAlloc((size_t)dither->bandCount * sizeof(uint64_t));
+    dither->targetRows = (uint64_t*)GameAlloc((size_t)dither->gridHeight * dither->rowWords * sizeof(uint64_t));
+    dither->targetColumns = (uint64_t*)GameAlloc((size_t)dither->gridWidth * dither->columnWords * sizeof(uint64_t));
+    dither->columnParities = (uint64_t*)GameCalloc(dither->rowWords, sizeof(uint64_t));
+    dither->rowParities = (uint64_t*)GameCalloc(dither->columnWords, sizeof(uint64_t));
+    dither->horizontalSequence = (bool*)GameAlloc((size_t)dither->gridWidth * sizeof(bool));
+    dither->verticalSequence = (bool*)GameAlloc((size_t)dither->gridHeight * sizeof(bool));
+    uint64_t* tiles = (uint64_t*)GameAlloc(IslandMapWordCount(dither->gridWidth, dither->gridHeight) * sizeof(uint64_t));
+    dither->islandPrefix = (uint64_t*)GameAlloc(dither->rowWords * sizeof(uint64_t));
+    dither->luma = (uint8_t*)GameAlloc(pixelCount);
+    dither->chroma = (uint8_t*)GameAlloc(dither->chromaBytes > 0 ? dither->chromaBytes : 1);
+    dither->pixelCells = (int*)GameAlloc((size_t)dither->frameWidth * sizeof(int));
+    dither->redMask = (uint8_t*)GameAlloc(pixelCount);
+    dither->output = (uint8_t*)GameAlloc(outputBytes);
+    IslandMapInit(&dither->islands, tiles, dither->gridWidth, dither->gridHeight);
+    for (int x = 0; dither->pixelCells != NULL && x < dither->frameWidth; ++x)
+    {
+        dither->pixelCells[x] = x / cellPixels;
+    }
+
+    return dither->cellSums != NULL && dither->bandTotals != NULL && dither->targetRows != NULL && dither->targetColumns != NULL && dither->columnParities != NULL
+        && dither->rowParities != NULL && dither->horizontalSequence != NULL && dither->verticalSequence != NULL && tiles != NULL
+        && dither->islandPrefix != NULL && dither->luma != NULL && dither->chroma != NULL && dither->pixelCells != NULL && dither->redMask != NULL && dither->output != NULL;
+}
+
+static void FreeDither(Dither* dither)
+{
+    free(dither->cellSums);
+    free(dither->bandTotals);
+    free(dither->targetRows);
+    free(dither->targetColumns);
+    free(dither->columnParities);
+    free(dither->rowParities);
+    free(dither->horizontalSequence);
+    free(dither->verticalSequence);
+    free(dither->islands.tiles);
+    free(dither->islandPrefix);
+    free(dither->luma);
+    free(dither->chroma);
+    free(dither->pixelCells);
+    free(dither->redMask);
+    free(dither->output);
+}
+
+// Transposes a 64x64 bit block in place, bit j of word i swaps with bit i of word j
+static void Transpose64(uint64_t* block)
+{
+    uint64_t mask = 0x00000000ffffffffull;
+    for (int j = 32; j != 0; j >>= 1, mask ^= mask << j)
+    {
+        for (int k = 0; k < 64; k = ((k | j) + 1) & ~j)
+        {
+            const uint64_t swapped = ((block[k] >> j) ^ block[k | j]) & mask;
+            block[k] ^= swapped << j;
+            block[k | j] ^= swapped;
+        }
+    }
+}
+
+static void SumBand(Dither* dither, int band)
+{
+    const int cellPixels = dither->config->cellPixels;
+    const int firstCell = band * DITHER_BAND_CELLS;
+    const int lastCell = firstCell + DITHER_BAND_CELLS < dither->gridHeight ? firstCell + DITHER_BAND_CELLS : dither->gridHeight;
+    uint64_t total = 0;
+    for (int cellY = firstCell; cellY < lastCell; ++cellY)
+    {
+        const int top = cellY * cellPixels;
+        const int bottom = top + cellPixels < dither->frameHeight ? top + cellPixels : dither->frameHeight;
+        uint32_t* sums = dither->cellSums + (size_t)cellY * dither->gridWidth;
+        memset(sums, 0, (size_t)dither->gridWidth * sizeof(uint32_t));
+        for (int y = top; y < bottom; ++y)
+        {
+            const uint8_t* row = dither->luma + (size_t)y * dither->frameWidth;
+            for (int x = 0; x < dither->frameWidth; ++x)
+            {
+                sums[dither->pixelCells[x]] += row[x];
+            }
+        }
+        for (int cellX = 0; cellX < dither->gridWidth; ++cellX)
+        {
+            total += sums[cellX];
+        }
+    }
+    dither->bandTotals[band] = total;
+}
+
+// Marks the cells darker than the frame's mean red. Sums are compared with the mean scaled to the cell's area,
+// so edge cells need no special case and no cell a division. The band's rows are then transposed a 64x64
+// block at a time into its word of every target column.
+static void BuildTargetBand(Dither* dither, int band)
+{
+    const int cellPixels = dither->config->cellPixels;
+    const uint64_t pixelCount = (uint64_t)dither->frameWidth * dither->frameHeight;
+    const int firstCell = band * DITHER_BAND_CELLS;
+    const int lastCell = firstCell + DITHER_BAND_CELLS < dither->gridHeight ? firstCell + DITHER_BAND_CELLS : dither->gridHeight;
+    for (int y = firstCell; y < lastCell; ++y)
+    {
+        const uint32_t* sums = dither->cellSums + (size_t)y * dither->gridWidth;
+        const int cellHeight = (y + 1) * cellPixels < dither->frameHeight ? cellPixels : dither->frameHeight - y * cellPixels;
+        const uint64_t checkerboard = (y & 1) == 0 ? DITHER_ODD_COLUMNS : 0;
+        uint64_t* row = dither->targetRows + (size_t)y * dither->rowWords;
+        for (size_t word = 0; word < dither->rowWords; ++word)
+        {
+            const int left = (int)word * 64;
+            const int right = left + 64 < dither->gridWidth ? left + 64 : dither->gridWidth;
+            uint64_t bits = 0;
+            for (int x = left; x < right; ++x)
+            {
+                const int cellWidth = (x + 1) * cellPixels < dither->frameWidth ? cellPixels : dither->frameWidth - x * cellPixels;
+                const uint64_t dark = (uint64_t)sums[x] * pixelCount < dither->frameTotal * (uint64_t)(cellWidth * cellHeight);
+                bits |= dark << (x - left);
+            }
+            row[word] = bits ^ (right - left == 64 ? checkerboard : checkerboard & ((1ull << (right - left)) - 1));
+        }
+    }
+
+    uint64_t block[64];
+    for (size_t word = 0; word < dither->rowWords; ++word)
+    {
+        for (int i = 0; i < 64; ++i)
+        {
+            block[i] = firstCell + i < lastCell ? dither->targetRows[(size_t)(firstCell + i) * dither->rowWords + word] : 0;
+        }
+        Transpose64(block);
+        for (int i = 0; i < 64 && (int)word * 64 + i < dither->gridWidth; ++i)
+        {
+            dither->targetColumns[((size_t)word * 64 + i) * dither->columnWords + (size_t)band] = block[i];
+        }
+    }
+}
+
+// Gives every parity the value that mismatches fewer of its targets with the other side fixed, ties keep the
+// current one so passes can't cycle. Returns how many changed.
+static int64_t UpdateParities(uint64_t* parities, int count, const uint64_t* targets, size_t words, int length, const uint64_t* other)
+{
+    int64_t changed = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        const uint64_t* target = targets + (size_t)i * words;
+        int mismatches = 0; // With parity 0, length - mismatches with parity 1
+        for (size_t word = 0; word < words; ++word)
+        {
+            mismatches += Popcount64(target[word] ^ other[word]);
+        }
+        const bool current = BitGet(parities, (size_t)i);
+        const bool best = 2 * mismatches == length ? current : 2 * mismatches > length;
+        if (best != current)
+        {
+            BitSet(parities, (size_t)i, best);
+            changed++;
+        }
+    }
+    return changed;
+}
+
+static void FlipBits(uint64_t* words, int count)
+{
+    for (size_t word = 0; word < BitWordCount((size_t)count); ++word)
+    {
+        words[word] = ~words[word];
+    }
+    if ((count & 63) != 0)
+    {
+        words[count >> 6] &= (1ull << (count & 63)) - 1;
+    }
+}
+
+static void SolveFrame(Dither* dither)
+{
+    int passes = 0;
+    while (passes < dither->config->maxPasses)
+    {
+        passes++;
+        const int64_t changed = UpdateParities(dither->columnParities, dither->gridWidth, dither->targetColumns, dither->columnWords, dither->gridHeight, dither->rowParities)
+            + UpdateParities(dither->rowParities, dither->gridHeight, dither->targetRows, dither->rowWords, dither->gridWidth, dither->columnParities);
+        if (changed == 0)
+        {
+            break;
+        }
+    }
+    dither->passCount += passes;
+
+    for (int y = 0; y < dither->gridHeight; ++y)
+    {
+        const uint64_t* row = dither->targetRows + (size_t)y * dither->rowWords;
+        int mismatches = 0;
+        for (size_t word = 0; word < dither->rowWords; ++word)
+        {
+            mismatches += Popcount64(row[word] ^ dither->columnParities[word]);
+        }
+        dither->mismatchCount += BitGet(dither->rowParities, (size_t)y) ? dither->gridWidth - mismatches : mismatches;
+    }
+
+    // Column 0 always has an even prefix, flipping both sides leaves every cell as it is
+    if (BitGet(dither->columnParities, 0))
+    {
+        FlipBits(dither->columnParities, dither->gridWidth);
+        FlipBits(dither->rowParities, dither->gridHeight);
+    }
+
+    // Stitch x flips the prefix parity of column x, and a gap at row y flips the parity of row y
+    dither->horizontalSequence[0] = false;
+    for (int x = 1; x < dither->gridWidth; ++x)
+    {
+        dither->horizontalSequence[x] = BitGet(dither->columnParities, (size_t)x) != BitGet(dither->columnParities, (size_t)x - 1);
+    }
+    dither->verticalSequence[0] = false;
+    for (int y = 1; y < dither->gridHeight; ++y)
+    {
+        dither->verticalSequence[y] = BitGet(dither->rowParities, (size_t)y) == BitGet(dither->rowParities, (size_t)y - 1);
+    }
+    dither->originIsland = BitGet(dither->rowParities, 0) ? 2 : 4;
+    IslandMapFill(&dither->islands, dither->horizontalSequence, dither->verticalSequence, dither->islandPrefix, dither->originIsland, NULL, NULL);
+}
+
+static void ToYCbCr(Color color, int* y, int* cb, int* cr)
+{
+    // Full range BT.601, as Y4M's 420jpeg expects
+    *y = (299 * color.r + 587 * color.g + 114 * color.b + 500) / 1000;
+    *cb = 128 + (-168736 * color.r - 331264 * color.g + 500000 * color.b + 500000) / 1000000;
+    *cr = 128 + (500000 * color.r - 418688 * color.g - 81312 * color.b + 500000) / 1000000;
+}
+
+static bool WriteVideoHeader(const Dither* dither, FILE* output)
+{
+    return fprintf(output, "YUV4MPEG2 W%d H%d %s Ip%s%s C420jpeg\n", dither->frameWidth, dither->frameHeight,
+        dither->frameRate[0] != '\0' ? dither->frameRate : "F25:1", dither->aspect[0] != '\0' ? " " : "", dither->aspect) > 0;
+}
+
+// The islands of a band at the input size in the colors of the colored view, chroma is averaged over 2x2
+// pixels. Bands are an even number of pixels high, so no chroma row straddles two of them.
+static void RenderBand(Dither* dither, int band)
+{
+    const int width = dither->frameWidth;
+    const int height = dither->frameHeight;
+    const int cellPixels = dither->config->cellPixels;
+    const int top = band * DITHER_BAND_CELLS * cellPixels;
+    const int bottom = top + DITHER_BAND_CELLS * cellPixels < height ? top + DITHER_BAND_CELLS * cellPixels : height;
+    uint8_t* lumaPlane = dither->output;
+    for (int y = top; y < bottom; ++y)
+    {
+        // Word x / 64 of the cell row is in tile x / 64, ISLAND_MAP_TILE_SIDE words further per tile
+        const uint64_t* cells = IslandMapTileRow(&dither->islands, 0, y / cellPixels);
+        uint8_t* mask = dither->redMask + (size_t)y * width;
+        uint8_t* luma = lumaPlane + (size_t)y * width;
+        for (int x = 0; x < width; ++x)
+        {
+            const int cell = dither->pixelCells[x];
+            mask[x] = (uint8_t)((cells[(size_t)(cell >> 6) * ISLAND_MAP_TILE_SIDE] >> (cell & 63)) & 1);
+            luma[x] = (uint8_t)dither->colorY[mask[x]];
+        }
+    }
+
+    const int chromaWidth = (width + 1) / 2;
+    const int chromaHeight = (height + 1) / 2;
+    uint8_t* cbPlane = lumaPlane + (size_t)width * height;
+    uint8_t* crPlane = cbPlane + (size_t)chromaWidth * chromaHeight;
+    for (int y = top / 2; y < (bottom + 1) / 2; ++y)
+    {
+        for (int x = 0; x < chromaWidth; ++x)
+        {
+            int count = 0;
+            int reds = 0;
+            for (int py = 2 * y; py < 2 * y + 2 && py < height; ++py)
+            {
+                for (int px = 2 * x; px < 2 * x + 2 && px < width; ++px)
+                {
+                    reds += dither->redMask[(size_t)py * width + px];
+                    count++;
+                }
+            }
+            const int greens = count - reds;
+            cbPlane[(size_t)y * chromaWidth + x] = (uint8_t)((reds * dither->colorCb[1] + greens * dither->colorCb[0] + count / 2) / count);
+            crPlane[(size_t)y * chromaWidth + x] = (uint8_t)((reds * dither->colorCr[1] + greens * dither->colorCr[0] + count / 2) / count);
+        }
+    }
+}
+
+static void RunBand(void* context, int jobIndex, int threadIndex)
+{
+    (void)threadIndex;
+    Dither* dither = (Dither*)context;
+    switch (dither->phase)
+    {
+    case DITHER_PHASE_SUMS: SumBand(dither, jobIndex); break;
+    case DITHER_PHASE_TARGET: BuildTargetBand(dither, jobIndex); break;
+    case DITHER_PHASE_RENDER: RenderBand(dither, jobIndex); break;
+    }
+}
+
+// Bands write disjoint rows, words and planes, so a phase is one parallel loop over them
+static void RunPhase(Dither* dither, DitherPhase phase)
+{
+    dither->phase = phase;
+    WorkPool pool;
+    if (dither->threadCount > 1 && dither->bandCount > 1 && WorkPoolStart(&pool, dither->threadCount, dither->bandCount, RunBand, dither))
+    {
+        WorkPoolWait(&pool, false);
+        return;
+    }
+    for (int band = 0; band < dither->bandCount; ++band)
+    {
+        RunBand(dither, band, 0);
+    }
+}
+
+static void BuildTarget(Dither* dither)
+{
+    RunPhase(dither, DITHER_PHASE_SUMS);
+    dither->frameTotal = 0;
+    for (int band = 0; band < dither->bandCount; ++band)
+    {
+        dither->frameTotal += dither->bandTotals[band];
+    }
+    RunPhase(dither, DITHER_PHASE_TARGET);
+}
+
+static bool WriteVideoFrame(const Dither* dither, FILE* output)
+{
+    const size_t frameBytes = (size_t)dither->frameWidth * dither->frameHeight + 2 * (size_t)((dither->frameWidth + 1) / 2) * ((dither->frameHeight + 1) / 2);
+    return fputs("FRAME\n", output) >= 0 && fwrite(dither->output, 1, frameBytes, output) == frameBytes;
+}
+
+static void ReadIslandRow(void* context, uint64_t y, uint64_t* bits)
+{
+    IslandMapReadRow((const IslandMap*)context, (int64_t)y, bits);
+}
+
+static bool SaveDitherPattern(const Dither* dither, const char* fileName)
+{
+    const PatternFileHeader parameters = {
+        .generator = GENERATOR_NONE,
+        .gridWidth = (uint64_t)dither->gridWidth,
+        .gridHeight = (uint64_t)dither->gridHeight,
+        .horizontalProbability = 0.5f,
+        .verticalProbability = 0.5f,
+        .cellSize = dither->config->cellPixels,
+        .colored = true,
+        .originRed = dither->originIsland == 2,
+    };
+    return PatternFileSave(fileName, &parameters, dither->horizontalSequence, dither->verticalSequence, ReadIslandRow, (void*)&dither->islands);
+}
+
+bool DitherRun(const DitherConfig* config)
+{
+    const bool toStdout = config->outputFileName != NULL && strcmp(config->outputFileName, "-") == 0;
+    if (toStdout)
+    {
+        SetTraceLogCallback(LogToStderr); // stdout carries the video
+    }
+    if (config->cellPixels < 1 || config->maxPasses < 1)
+    {
+        TraceLog(LOG_WARNING, "DITHER: Cells need at least one pixel and frames at least one pass");
+        return false;
+    }
+
+    Dither dither = { .config = config };
+    ToYCbCr(GREEN, &dither.colorY[0], &dither.colorCb[0], &dither.colorCr[0]);
+    ToYCbCr(RED, &dither.colorY[1], &dither.colorCb[1], &dither.colorCr[1]);
+    const bool video = strcmp(config->inputFileName, "-") == 0;
+    Image image = { 0 };
+    bool ok;
+    if (video)
+    {
+#if defined(_WIN32)
+        _setmode(_fileno(stdin), _O_BINARY);
+#endif
+        ok = ReadVideoHeader(&dither, stdin);
+    }
+    else
+    {
+        image = LoadImage(config->inputFileName);
+        ok = image.data != NULL;
+        if (!ok)
+        {
+            TraceLog(LOG_WARNING, "DITHER: Could not load %s", config->inputFileName);
+        }
+        else
+        {
+            ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_GRAYSCALE);
+            dither.frameWidth = image.width;
+            dither.frameHeight = image.height;
+        }
+    }
+    ok = ok && AllocateDither(&dither);
+    if (ok && !video)
+    {
+        memcpy(dither.luma, image.data, (size_t)dither.frameWidth * dither.frameHeight);
+    }
+    UnloadImage(image);
+
+    FILE* output = NULL;
+    if (ok && config->outputFileName != NULL)
+    {
+#if defined(_WIN32)
+        if (toStdout)
+        {
+            _setmode(_fileno(stdout), _O_BINARY);
+        }
+#endif
+        output = toStdout ? stdout : fopen(config->outputFileName, "wb");
+        ok = output != NULL && WriteVideoHeader(&dither, output);
+        if (!ok)
+        {
+            TraceLog(LOG_WARNING, "DITHER: Could not write %s", config->outputFileName);
+        }
+    }
+
+    while (ok && (video ? ReadVideoFrame(&dither, stdin) : dither.frameCount == 0))
+    {
+        const uint64_t startNs = GetMonotonicTimeNs();
+        BuildTarget(&dither);
+        const uint64_t targetNs = GetMonotonicTimeNs();
+        SolveFrame(&dither);
+        dither.targetNs += targetNs - startNs;
+        dither.solveNs += GetMonotonicTimeNs() - targetNs;
+        dither.frameCount++;
+
+        if (output != NULL)
+        {
+            const uint64_t renderStartNs = GetMonotonicTimeNs();
+            RunPhase(&dither, DITHER_PHASE_RENDER);
+            dither.renderNs += GetMonotonicTimeNs() - renderStartNs;
+        }
+        if (output != NULL && !WriteVideoFrame(&dither, output))
+        {
+            TraceLog(LOG_WARNING, "DITHER: Could not write frame %lld", (long long)dither.frameCount);
+            ok = false;
+        }
+    }
+
+    if (output != NULL && output != stdout)
+    {
+        ok = fclose(output) == 0 && ok;
+    }
+    else if (output != NULL)
+    {
+        fflush(output);
+    }
+    if (ok && dither.frameCount > 0 && config->patternFileName != NULL)
+    {
+        ok = SaveDitherPattern(&dither, config->patternFileName);
+        TraceLog(ok ? LOG_INFO : LOG_WARNING, ok ? "DITHER: Saved the last frame to %s" : "DITHER: Could not save %s", config->patternFileName);
+    }
+
+    if (dither.frameCount > 0)
+    {
+        const double frames = (double)dither.frameCount;
+        TraceLog(LOG_INFO, "DITHER: %lld frames of %dx%d cells, target %.3f ms, solve %.3f ms and render %.3f ms per frame, %.2f passes, %.2f%% of cells off target",
+            (long long)dither.frameCount, dither.gridWidth, dither.gridHeight, (double)dither.targetNs / frames / 1e6, (double)dither.solveNs / frames / 1e6,
+            (double)dither.renderNs / frames / 1e6, (double)dither.passCount / frames, 100.0 * (double)dither.mismatchCount / (frames * dither.gridWidth * dither.gridHeight));
+    }
+    FreeDither(&dither);
+    if (toStdout)
+    {
+        SetTraceLogCallback(NULL);
+    }
+    return ok && dither.frameCount > 0;
+}
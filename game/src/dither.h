@@ -0,0 +1,23 @@
+#pragma once
+
+#include "stdbool.h"
+#include "stdint.h"
+
+// Headless conversion of photos and video to colored hitomezashi. A cell of the island map is red exactly
+// when A[x] ^ B[y] ^ (x odd and y even), A being the stitch prefix parities of its column and B those of
+// its row (see IslandMapFill), so matching a target that is red where the image is dark is a rank-one binary
+// approximation. The solver alternates between the two sides: with B fixed every column takes the parity
+// that mismatches fewer of its cells, counted with XOR and popcount over the bit-packed target column, then
+// the rows do the same against A. No pass raises the mismatch count, and the solver stops once no single
+// parity flip lowers it. Video is read as Y4M, every frame starting from the solution of the previous one.
+typedef struct DitherConfig_t
+{
+    const char* inputFileName;   // "-" for Y4M on stdin, an image file otherwise
+    const char* outputFileName;  // Y4M of the colored islands at the input size, "-" for stdout, NULL for none
+    const char* patternFileName; // Pattern file of the last frame, NULL for none
+    int cellPixels;              // Input pixels per cell side
+    int maxPasses;               // Per frame, a pass updates every column and then every row
+    int threadCount;             // For the per-pixel work, 0 for one per CPU
+} DitherConfig;
+
+bool DitherRun(const DitherConfig* config);
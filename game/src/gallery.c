@@ -0,0 +1,275 @@
+#include "gallery.h"
+
+#include "stdlib.h"
+#include "string.h"
+
+#include "gamealloc.h"
+#include "generator.h"
+
+#define GALLERY_BACKGROUND LIGHTGRAY
+
+static int AtlasWidth(const GallerySweep* sweep)
+{
+    return sweep->columns * GALLERY_THUMBNAIL_SIZE;
+}
+
+float GalleryHorizontalProbability(const GallerySweep* sweep, int column)
+{
+    return sweep->horizontalMin + (sweep->horizontalMax - sweep->horizontalMin) * ((float)column + 0.5f) / (float)sweep->columns;
+}
+
+float GalleryVerticalProbability(const GallerySweep* sweep, int row)
+{
+    return sweep->verticalMin + (sweep->verticalMax - sweep->verticalMin) * ((float)row + 0.5f) / (float)sweep->rows;
+}
+
+static void FillCell(Color* origin, int stride, int x, int y, Color color)
+{
+    for (int py = 0; py < GALLERY_THUMBNAIL_CELL_SIZE; ++py)
+    {
+        Color* pixel = origin + (size_t)(y * GALLERY_THUMBNAIL_CELL_SIZE + py) * stride + x * GALLERY_THUMBNAIL_CELL_SIZE;
+        for (int px = 0; px < GALLERY_THUMBNAIL_CELL_SIZE; ++px)
+        {
+            pixel[px] = color;
+        }
+    }
+}
+
+// Same picture as the primitive renderer: islands 2 are red with cell (0, 0) in island 2, stitches are one pixel lines
+static void RenderThumbnail(const GallerySweep* sweep, int column, int row, Color* slot, int stride)
+{
+    const uint64_t seed = SplitMix64(sweep->seed);
+    const float horizontalProbability = GalleryHorizontalProbability(sweep, column);
+    const float verticalProbability = GalleryVerticalProbability(sweep, row);
+    bool horizontalSequence[GALLERY_THUMBNAIL_CELLS];
+    bool verticalSequence[GALLERY_THUMBNAIL_CELLS];
+    for (int i = 0; i < GALLERY_THUMBNAIL_CELLS; ++i)
+    {
+        horizontalSequence[i] = GeneratorStitch(seed, SEQUENCE_HORIZONTAL, i, horizontalProbability);
+        verticalSequence[i] = GeneratorStitch(seed, SEQUENCE_VERTICAL, i, verticalProbability);
+    }
+
+    for (int y = 0; y < GALLERY_THUMBNAIL_SIZE; ++y)
+    {
+        Color* pixel = slot + (size_t)y * stride;
+        for (int x = 0; x < GALLERY_THUMBNAIL_SIZE; ++x)
+        {
+            pixel[x] = GALLERY_BACKGROUND;
+        }
+    }
+
+    const int side = GALLERY_THUMBNAIL_CELLS * GALLERY_THUMBNAIL_CELL_SIZE;
+    Color* origin = slot + (size_t)GALLERY_THUMBNAIL_MARGIN * stride + GALLERY_THUMBNAIL_MARGIN;
+    if (sweep->colored)
+    {
+        bool rowStartRed = true;
+        for (int y = 0; y < GALLERY_THUMBNAIL_CELLS; ++y)
+        {
+            const bool yOdd = (y & 1) == 1;
+            rowStartRed = y == 0 || verticalSequence[y] ? rowStartRed : !rowStartRed;
+            bool red = rowStartRed;
+            for (int x = 0; x < GALLERY_THUMBNAIL_CELLS; ++x)
+            {
+                red = x == 0 || yOdd != horizontalSequence[x] ? red : !red;
+                FillCell(origin, stride, x, y, red ? RED : GREEN);
+            }
+        }
+        return;
+    }
+
+    for (int y = 0; y < side; ++y)
+    {
+        Color* pixel = origin + (size_t)y * stride;
+        for (int x = 0; x < side; ++x)
+        {
+            pixel[x] = WHITE;
+        }
+    }
+    for (int x = 0; x < GALLERY_THUMBNAIL_CELLS; ++x)
+    {
+        for (int y = horizontalSequence[x] ? 1 : 0; y < GALLERY_THUMBNAIL_CELLS; y += 2)
+        {
+            for (int py = 0; py < GALLERY_THUMBNAIL_CELL_SIZE; ++py)
+            {
+                origin[(size_t)(y * GALLERY_THUMBNAIL_CELL_SIZE + py) * stride + x * GALLERY_THUMBNAIL_CELL_SIZE] = BLACK;
+            }
+        }
+    }
+    for (int y = 0; y < GALLERY_THUMBNAIL_CELLS; ++y)
+    {
+        Color* line = origin + (size_t)y * GALLERY_THUMBNAIL_CELL_SIZE * stride;
+        for (int x = verticalSequence[y] ? 1 : 0; x < GALLERY_THUMBNAIL_CELLS; x += 2)
+        {
+            for (int px = 0; px < GALLERY_THUMBNAIL_CELL_SIZE; ++px)
+            {
+                line[x * GALLERY_THUMBNAIL_CELL_SIZE + px] = BLACK;
+            }
+        }
+    }
+}
+
+static void RenderThumbnailJob(void* context, int jobIndex, int threadIndex)
+{
+    (void)threadIndex;
+    Gallery* gallery = (Gallery*)context;
+    const int column = jobIndex % gallery->sweep.columns;
+    const int row = jobIndex / gallery->sweep.columns;
+    const int stride = AtlasWidth(&gallery->sweep);
+    Color* slot = gallery->pixels + (size_t)row * GALLERY_THUMBNAIL_SIZE * stride + (size_t)column * GALLERY_THUMBNAIL_SIZE;
+    RenderThumbnail(&gallery->sweep, column, row, slot, stride);
+    WorkPoolAdd(&gallery->rowDone[row], 1); // Publishes the pixels to the uploading thread
+}
+
+bool GalleryBegin(Gallery* gallery, const GallerySweep* sweep)
+{
+    if (gallery->running)
+    {
+        WorkPoolWait(&gallery->pool, true);
+        gallery->running = false;
+    }
+    if (sweep->columns < 1 || sweep->rows < 1 || sweep->columns > GALLERY_MAX_SIDE || sweep->rows > GALLERY_MAX_SIDE)
+    {
+        return false;
+    }
+
+    const int width = sweep->columns * GALLERY_THUMBNAIL_SIZE;
+    const int height = sweep->rows * GALLERY_THUMBNAIL_SIZE;
+    const size_t pixelCount = (size_t)width * height;
+    if (pixelCount > gallery->pixelCapacity)
+    {
+        Color* pixels = (Color*)GameRealloc(gallery->pixels, pixelCount * sizeof(Color));
+        volatile long* rowDone = (volatile long*)GameRealloc((void*)gallery->rowDone, GALLERY_MAX_SIDE * sizeof(long));
+        bool* rowUploaded = (bool*)GameRealloc(gallery->rowUploaded, GALLERY_MAX_SIDE * sizeof(bool));
+        gallery->pixels = pixels != NULL ? pixels : gallery->pixels;
+        gallery->rowDone = rowDone != NULL ? rowDone : gallery->rowDone;
+        gallery->rowUploaded = rowUploaded != NULL ? rowUploaded : gallery->rowUploaded;
+        if (pixels == NULL || rowDone == NULL || rowUploaded == NULL)
+        {
+            return false;
+        }
+        gallery->pixelCapacity = pixelCount;
+    }
+
+    gallery->sweep = *sweep;
+    for (size_t i = 0; i < pixelCount; ++i)
+    {
+        gallery->pixels[i] = GALLERY_BACKGROUND;
+    }
+    if (gallery->texture.width != width || gallery->texture.height != height)
+    {
+        if (gallery->texture.id != 0)
+        {
+            UnloadTexture(gallery->texture);
+        }
+        const Image image = {
+            .data = gallery->pixels,
+            .width = width,
+            .height = height,
+            .mipmaps = 1,
+            .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8,
+        };
+        gallery->texture = LoadTextureFromImage(image);
+        SetTextureFilter(gallery->texture, TEXTURE_FILTER_BILINEAR);
+    }
+    else
+    {
+        UpdateTexture(gallery->texture, gallery->pixels); // Clears the previous sweep
+    }
+
+    for (int row = 0; row < sweep->rows; ++row)
+    {
+        gallery->rowDone[row] = 0;
+        gallery->rowUploaded[row] = false;
+    }
+    gallery->uploadedRows = 0;
+    gallery->startTime = GetTime();
+    gallery->running = WorkPoolStart(&gallery->pool, 0, sweep->columns * sweep->rows, RenderThumbnailJob, gallery);
+    return gallery->running;
+}
+
+void GalleryUpdate(Gallery* gallery)
+{
+    if (!gallery->running)
+    {
+        return;
+    }
+
+    const int stride = AtlasWidth(&gallery->sweep);
+    for (int row = 0; row < gallery->sweep.rows; ++row)
+    {
+        if (!gallery->rowUploaded[row] && WorkPoolLoad(&gallery->rowDone[row]) == gallery->sweep.columns)
+        {
+            const Rectangle rows = { 0, (float)(row * GALLERY_THUMBNAIL_SIZE), (float)stride, GALLERY_THUMBNAIL_SIZE };
+            UpdateTextureRec(gallery->texture, rows, gallery->pixels + (size_t)row * GALLERY_THUMBNAIL_SIZE * stride);
+            gallery->rowUploaded[row] = true;
+            gallery->uploadedRows++;
+        }
+    }
+
+    if (gallery->uploadedRows == gallery->sweep.rows)
+    {
+        WorkPoolWait(&gallery->pool, false);
+        gallery->running = false;
+        TraceLog(LOG_INFO, "GALLERY: %dx%d sweep filled in %.1f ms", gallery->sweep.columns, gallery->sweep.rows,
+            (GetTime() - gallery->startTime) * 1000.0);
+    }
+}
+
+// The atlas scaled to fit the bounds, anchored at the top-left like the pattern
+static Rectangle AtlasBounds(const Gallery* gallery, Rectangle bounds)
+{
+    const float scaleX = bounds.width / (float)gallery->texture.width;
+    const float scaleY = bounds.height / (float)gallery->texture.height;
+    const float scale = scaleX < scaleY ? scaleX : scaleY;
+    return (Rectangle){ bounds.x, bounds.y, gallery->texture.width * scale, gallery->texture.height * scale };
+}
+
+void GalleryDraw(const Gallery* gallery, Rectangle bounds)
+{
+    if (gallery->texture.id == 0)
+    {
+        return;
+    }
+
+    const Rectangle source = { 0, 0, (float)gallery->texture.width, (float)gallery->texture.height };
+    DrawTexturePro(gallery->texture, source, AtlasBounds(gallery, bounds), (Vector2){ 0, 0 }, 0.0f, WHITE);
+}
+
+Rectangle GalleryThumbnailBounds(const Gallery* gallery, Rectangle bounds, int column, int row)
+{
+    const Rectangle atlas = AtlasBounds(gallery, bounds);
+    const float width = atlas.width / gallery->sweep.columns;
+    const float height = atlas.height / gallery->sweep.rows;
+    return (Rectangle){ atlas.x + column * width, atlas.y + row * height, width, height };
+}
+
+bool GalleryPick(const Gallery* gallery, Rectangle bounds, Vector2 point, int* column, int* row)
+{
+    const Rectangle atlas = AtlasBounds(gallery, bounds);
+    if (gallery->texture.id == 0 || !CheckCollisionPointRec(point, atlas))
+    {
+        return false;
+    }
+
+    *column = (int)((point.x - atlas.x) / atlas.width * gallery->sweep.columns);
+    *row = (int)((point.y - atlas.y) / atlas.height * gallery->sweep.rows);
+    *column = *column < gallery->sweep.columns ? *column : gallery->sweep.columns - 1;
+    *row = *row < gallery->sweep.rows ? *row : gallery->sweep.rows - 1;
+    return true;
+}
+
+void GalleryUnload(Gallery* gallery)
+{
+    if (gallery->running)
+    {
+        WorkPoolWait(&gallery->pool, true);
+    }
+    if (gallery->texture.id != 0)
+    {
+        UnloadTexture(gallery->texture);
+    }
+    free(gallery->pixels);
+    free((void*)gallery->rowDone);
+    free(gallery->rowUploaded);
+    memset(gallery, 0, sizeof(*gallery));
+}
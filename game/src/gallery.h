@@ -0,0 +1,52 @@
+#pragma once
+
+#include "stdbool.h"
+#include "stddef.h"
+#include "stdint.h"
+
+#include "raylib.h"
+#include "workpool.h"
+
+// Parameter sweep: a grid of thumbnails, horizontal probability across the columns and vertical probability
+// down the rows. Workers rasterize thumbnails straight into a CPU copy of one atlas texture and every row
+// of thumbnails is uploaded with a single UpdateTextureRec as soon as its last thumbnail is done.
+#define GALLERY_THUMBNAIL_SIZE 128
+#define GALLERY_THUMBNAIL_MARGIN 2
+#define GALLERY_THUMBNAIL_CELL_SIZE 4
+#define GALLERY_THUMBNAIL_CELLS ((GALLERY_THUMBNAIL_SIZE - 2 * GALLERY_THUMBNAIL_MARGIN) / GALLERY_THUMBNAIL_CELL_SIZE)
+#define GALLERY_MAX_SIDE 16
+
+typedef struct GallerySweep_t
+{
+    int columns;
+    int rows;
+    float horizontalMin;
+    float horizontalMax;
+    float verticalMin;
+    float verticalMax;
+    uint64_t seed; // Thumbnails show the pattern RegenerateSequences makes from this seed
+    bool colored;
+} GallerySweep;
+
+typedef struct Gallery_t
+{
+    GallerySweep sweep;
+    Color* pixels;
+    size_t pixelCapacity;
+    Texture2D texture;
+    volatile long* rowDone; // Finished thumbnails per row, written by the workers
+    bool* rowUploaded;
+    int uploadedRows;
+    WorkPool pool;
+    bool running;
+    double startTime;
+} Gallery;
+
+bool GalleryBegin(Gallery* gallery, const GallerySweep* sweep); // Cancels a sweep still in progress
+void GalleryUpdate(Gallery* gallery); // Uploads the finished rows, main thread only
+void GalleryDraw(const Gallery* gallery, Rectangle bounds);
+bool GalleryPick(const Gallery* gallery, Rectangle bounds, Vector2 point, int* column, int* row);
+Rectangle GalleryThumbnailBounds(const Gallery* gallery, Rectangle bounds, int column, int row);
+float GalleryHorizontalProbability(const GallerySweep* sweep, int column);
+float GalleryVerticalProbability(const GallerySweep* sweep, int row);
+void GalleryUnload(Gallery* gallery);
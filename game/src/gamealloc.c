@@ -0,0 +1,39 @@
+#include "gamealloc.h"
+
+// NOTE: This file must not include raylib.h, windows.h clashes with it
+
+#if !defined(NDEBUG)
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define AllocationCountIncrement(ptr) _InterlockedIncrement((volatile long*)(ptr))
+#define AllocationCountLoad(ptr) _InterlockedOr((volatile long*)(ptr), 0)
+#else
+#define AllocationCountIncrement(ptr) __atomic_add_fetch((ptr), 1, __ATOMIC_RELAXED)
+#define AllocationCountLoad(ptr) __atomic_load_n((ptr), __ATOMIC_RELAXED)
+#endif
+
+// Workers allocate too, so the counts are atomic
+static volatile long gameAllocationCount = 0;
+static volatile long gameGrowthCount = 0;
+
+void GameCountAllocation(bool growth)
+{
+    AllocationCountIncrement(&gameAllocationCount);
+    if (growth)
+    {
+        AllocationCountIncrement(&gameGrowthCount);
+    }
+}
+
+long GameGetAllocationCount(void)
+{
+    return AllocationCountLoad(&gameAllocationCount);
+}
+
+long GameGetGrowthCount(void)
+{
+    return AllocationCountLoad(&gameGrowthCount);
+}
+
+#endif
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "stdbool.h"
+#include "stddef.h"
+#include "stdlib.h"
+
+// Every heap allocation of the game goes through these, so debug builds can count them and check that steady
+// state frames don't allocate. Release builds call the C runtime directly. Memory is released with free().
+#if !defined(NDEBUG)
+void GameCountAllocation(bool growth); // For allocators built on top, like arenas
+long GameGetAllocationCount(void);
+long GameGetGrowthCount(void); // The part of the allocations made by GameGrow
+#else
+static inline void GameCountAllocation(bool growth) { (void)growth; }
+#endif
+
+static inline void* GameAlloc(size_t size)
+{
+    GameCountAllocation(false);
+    return malloc(size);
+}
+
+static inline void* GameCalloc(size_t count, size_t size)
+{
+    GameCountAllocation(false);
+    return calloc(count, size);
+}
+
+static inline void* GameRealloc(void* memory, size_t size)
+{
+    GameCountAllocation(false);
+    return realloc(memory, size);
+}
+
+// For buffers that fill up with use, like histories, and grow geometrically, so their cost amortizes over frames
+static inline void* GameGrow(void* memory, size_t size)
+{
+    GameCountAllocation(true);
+    return realloc(memory, size);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "stdbool.h"
+#include "stdint.h"
+
+// Counter-based stitch generator: every stitch is a pure function of (seed, sequence, index), so any
+// part of a pattern can be regenerated without replaying the ones before it
+typedef enum
+{
+    GENERATOR_NONE = 0, // Sequences were not produced by a known generator, only the stored bits are valid
+    GENERATOR_SPLITMIX64 = 1,
+} GeneratorId;
+
+typedef enum
+{
+    SEQUENCE_HORIZONTAL = 0,
+    SEQUENCE_VERTICAL = 1,
+} SequenceAxis;
+
+static inline uint64_t SplitMix64(uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+static inline bool GeneratorStitch(uint64_t seed, SequenceAxis axis, int64_t index, float probability)
+{
+    const uint64_t bits = SplitMix64(seed ^ SplitMix64(((uint64_t)index << 1) | (uint64_t)axis));
+    return (double)(bits >> 11) * (1.0 / 9007199254740992.0) < (double)probability;
+}
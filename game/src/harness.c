@@ -0,0 +1,392 @@
+#include "harness.h"
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+#include "gamealloc.h"
+#include "rlgl.h"
+#include "timer.h"
+
+#define HARNESS_REPORT_MAGIC "# hitomezashi harness report 1"
+
+static int CompareU64(const void* a, const void* b)
+{
+    const uint64_t lhs = *(const uint64_t*)a;
+    const uint64_t rhs = *(const uint64_t*)b;
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+static double NsToMs(uint64_t ns) { return (double)ns / 1000000.0; }
+
+static Rectangle GetScreenPixelRect(void)
+{
+    const Vector2 scale = GetWindowScaleDPI();
+    return (Rectangle){ 0, 0, (float)(int)(GetScreenWidth() * scale.x), (float)(int)(GetScreenHeight() * scale.y) };
+}
+
+// Checkpoint frames only grow the readback buffer when the window grew
+static bool EnsureScreenCapacity(Harness* harness, size_t size)
+{
+    if (size > harness->screenCapacity)
+    {
+        free(harness->screenPixels);
+        harness->screenPixels = (unsigned char*)GameAlloc(size);
+        harness->screenCapacity = harness->screenPixels != NULL ? size : 0;
+    }
+    return harness->screenPixels != NULL;
+}
+
+bool HarnessBegin(Harness* harness, const HarnessConfig* config)
+{
+    memset(harness, 0, sizeof(*harness));
+    harness->config = *config;
+    if (harness->config.checkpointInterval < 1)
+    {
+        harness->config.checkpointInterval = HARNESS_CHECKPOINT_INTERVAL;
+    }
+
+    if (!FileExists(config->inputFileName))
+    {
+        TraceLog(LOG_WARNING, "HARNESS: Input file %s not found", config->inputFileName);
+        return false;
+    }
+    harness->events = LoadAutomationEventList(config->inputFileName);
+    if (harness->events.count == 0)
+    {
+        TraceLog(LOG_WARNING, "HARNESS: %s holds no events", config->inputFileName);
+        UnloadAutomationEventList(harness->events);
+        return false;
+    }
+    harness->lastEventFrame = harness->events.events[harness->events.count - 1].frame;
+
+    const size_t frameCount = (size_t)harness->lastEventFrame + 1;
+    harness->frames = (HarnessFrame*)GameCalloc(frameCount, sizeof(HarnessFrame));
+    harness->checkpoints = (HarnessCheckpoint*)GameCalloc(HARNESS_MAX_CHECKPOINTS, sizeof(HarnessCheckpoint));
+    if (harness->frames == NULL || harness->checkpoints == NULL)
+    {
+        free(harness->frames);
+        free(harness->checkpoints);
+        UnloadAutomationEventList(harness->events);
+        return false;
+    }
+    harness->frameCapacity = frameCount;
+    const Rectangle screen = GetScreenPixelRect();
+    EnsureScreenCapacity(harness, (size_t)screen.width * (size_t)screen.height * 4);
+
+    harness->gpuTiming = rlIsTimerQuerySupported();
+    for (int i = 0; i < HARNESS_GPU_QUERY_COUNT && harness->gpuTiming; ++i)
+    {
+        harness->queries[i] = rlLoadTimerQuery();
+    }
+
+    TraceLog(LOG_INFO, "HARNESS: Replaying %u events over %u frames from %s%s", harness->events.count, harness->lastEventFrame + 1,
+        config->inputFileName, harness->gpuTiming ? "" : ", no GPU timer queries");
+    return true;
+}
+
+bool HarnessDone(const Harness* harness)
+{
+    return harness->frame > harness->lastEventFrame;
+}
+
+double HarnessTime(const Harness* harness)
+{
+    return (double)harness->frame / HARNESS_FRAMES_PER_SECOND;
+}
+
+// Result of the query issued HARNESS_GPU_QUERY_COUNT frames ago, by now it is ready and reading it does not stall
+static void CollectGpuTime(Harness* harness, uint64_t frame)
+{
+    if (harness->gpuTiming && frame < harness->frameCapacity)
+    {
+        harness->frames[frame].gpuNs = rlGetTimerQueryResult(harness->queries[frame % HARNESS_GPU_QUERY_COUNT]);
+    }
+}
+
+void HarnessBeginFrame(Harness* harness)
+{
+    // Events recorded on a frame describe the input that frame saw, so they go in before its update
+    while (harness->nextEvent < harness->events.count && harness->events.events[harness->nextEvent].frame <= harness->frame)
+    {
+        PlayAutomationEvent(harness->events.events[harness->nextEvent]);
+        harness->nextEvent++;
+    }
+
+    if (harness->frame >= HARNESS_GPU_QUERY_COUNT)
+    {
+        CollectGpuTime(harness, harness->frame - HARNESS_GPU_QUERY_COUNT);
+    }
+    rlResetRenderStats();
+    harness->frameStartNs = GetMonotonicTimeNs();
+    if (harness->gpuTiming)
+    {
+        rlBeginTimerQuery(harness->queries[harness->frame % HARNESS_GPU_QUERY_COUNT]);
+    }
+}
+
+void HarnessCapture(Harness* harness)
+{
+    if (harness->frame >= harness->frameCapacity)
+    {
+        return;
+    }
+
+    // EndDrawing would submit the rest of the batch, it is counted here instead
+    rlDrawRenderBatchActive();
+    const rlRenderStats stats = rlGetRenderStats();
+    harness->frames[harness->frame].drawCalls = stats.drawCalls;
+    harness->frames[harness->frame].vertexCount = stats.vertexCount;
+
+    const bool checkpoint = harness->frame % harness->config.checkpointInterval == 0 || harness->frame == harness->lastEventFrame;
+    if (!checkpoint || harness->checkpointCount == HARNESS_MAX_CHECKPOINTS)
+    {
+        return;
+    }
+
+    // FNV-1a over the back buffer, before the swap leaves it undefined
+    const Rectangle screen = GetScreenPixelRect();
+    const size_t size = (size_t)screen.width * (size_t)screen.height * 4;
+    if (!EnsureScreenCapacity(harness, size))
+    {
+        return;
+    }
+    ReadScreenPixels(screen, harness->screenPixels);
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash = (hash ^ harness->screenPixels[i]) * 0x100000001b3ull;
+    }
+
+    harness->checkpoints[harness->checkpointCount++] = (HarnessCheckpoint){ .frame = harness->frame, .hash = hash };
+}
+
+void HarnessEndFrame(Harness* harness)
+{
+    if (harness->gpuTiming)
+    {
+        rlEndTimerQuery();
+    }
+    if (harness->frame < harness->frameCapacity)
+    {
+        harness->frames[harness->frame].cpuNs = GetMonotonicTimeNs() - harness->frameStartNs;
+    }
+    harness->frame++;
+}
+
+static uint64_t Percentile(const uint64_t* sorted, uint64_t count, int percent)
+{
+    return count > 0 ? sorted[(count * percent - 1) / 100] : 0;
+}
+
+static void Summarize(const Harness* harness, HarnessSummary* summary)
+{
+    memset(summary, 0, sizeof(*summary));
+    summary->seed = harness->config.seed;
+    summary->frameCount = harness->frame < harness->frameCapacity ? harness->frame : harness->frameCapacity;
+
+    uint64_t* sorted = (uint64_t*)GameAlloc((summary->frameCount + 1) * sizeof(uint64_t));
+    if (sorted != NULL)
+    {
+        for (uint64_t i = 0; i < summary->frameCount; ++i)
+        {
+            sorted[i] = harness->frames[i].cpuNs;
+        }
+        qsort(sorted, summary->frameCount, sizeof(uint64_t), CompareU64);
+        summary->cpuP50Ns = Percentile(sorted, summary->frameCount, 50);
+        summary->cpuP95Ns = Percentile(sorted, summary->frameCount, 95);
+
+        for (uint64_t i = 0; i < summary->frameCount; ++i)
+        {
+            sorted[i] = harness->frames[i].gpuNs;
+        }
+        qsort(sorted, summary->frameCount, sizeof(uint64_t), CompareU64);
+        summary->gpuP50Ns = Percentile(sorted, summary->frameCount, 50);
+        summary->gpuP95Ns = Percentile(sorted, summary->frameCount, 95);
+        free(sorted);
+    }
+
+    for (uint64_t i = 0; i < summary->frameCount; ++i)
+    {
+        summary->drawCalls += (uint64_t)harness->frames[i].drawCalls;
+    }
+    summary->checkpointCount = harness->checkpointCount;
+    memcpy(summary->checkpoints, harness->checkpoints, harness->checkpointCount * sizeof(HarnessCheckpoint));
+}
+
+static bool WriteReport(const Harness* harness, const HarnessSummary* summary, const char* fileName)
+{
+    FILE* file = fopen(fileName, "w");
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    fprintf(file, "%s\n", HARNESS_REPORT_MAGIC);
+    fprintf(file, "input %s\n", harness->config.inputFileName);
+    fprintf(file, "seed %llu\n", (unsigned long long)summary->seed);
+    fprintf(file, "frames %llu\n", (unsigned long long)summary->frameCount);
+    fprintf(file, "cpu_ns %llu %llu\n", (unsigned long long)summary->cpuP50Ns, (unsigned long long)summary->cpuP95Ns);
+    fprintf(file, "gpu_ns %llu %llu\n", (unsigned long long)summary->gpuP50Ns, (unsigned long long)summary->gpuP95Ns);
+    fprintf(file, "draw_calls %llu\n", (unsigned long long)summary->drawCalls);
+    for (int i = 0; i < summary->checkpointCount; ++i)
+    {
+        fprintf(file, "checkpoint %llu %016llx\n", (unsigned long long)summary->checkpoints[i].frame, (unsigned long long)summary->checkpoints[i].hash);
+    }
+
+    // Per frame rows, only for plotting, a baseline read skips them
+    fprintf(file, "# frame cpu_ns gpu_ns draw_calls vertices\n");
+    for (uint64_t i = 0; i < summary->frameCount; ++i)
+    {
+        const HarnessFrame* frame = &harness->frames[i];
+        fprintf(file, "frame %llu %llu %llu %d %d\n", (unsigned long long)i, (unsigned long long)frame->cpuNs,
+            (unsigned long long)frame->gpuNs, frame->drawCalls, frame->vertexCount);
+    }
+
+    const bool written = ferror(file) == 0;
+    return fclose(file) == 0 && written;
+}
+
+static bool ReadReport(const char* fileName, HarnessSummary* summary)
+{
+    memset(summary, 0, sizeof(*summary));
+    FILE* file = fopen(fileName, "r");
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    char line[512];
+    bool valid = fgets(line, sizeof(line), file) != NULL && strncmp(line, HARNESS_REPORT_MAGIC, strlen(HARNESS_REPORT_MAGIC)) == 0;
+    while (valid && fgets(line, sizeof(line), file) != NULL)
+    {
+        unsigned long long a = 0;
+        unsigned long long b = 0;
+        if (sscanf(line, "seed %llu", &a) == 1) summary->seed = a;
+        else if (sscanf(line, "frames %llu", &a) == 1) summary->frameCount = a;
+        else if (sscanf(line, "cpu_ns %llu %llu", &a, &b) == 2) { summary->cpuP50Ns = a; summary->cpuP95Ns = b; }
+        else if (sscanf(line, "gpu_ns %llu %llu", &a, &b) == 2) { summary->gpuP50Ns = a; summary->gpuP95Ns = b; }
+        else if (sscanf(line, "draw_calls %llu", &a) == 1) summary->drawCalls = a;
+        else if (sscanf(line, "checkpoint %llu %llx", &a, &b) == 2 && summary->checkpointCount < HARNESS_MAX_CHECKPOINTS)
+        {
+            summary->checkpoints[summary->checkpointCount++] = (HarnessCheckpoint){ .frame = a, .hash = b };
+        }
+    }
+    fclose(file);
+    return valid;
+}
+
+static bool CompareTiming(const char* name, uint64_t value, uint64_t baseline, float tolerance)
+{
+    const uint64_t limit = (uint64_t)((double)baseline * (1.0 + tolerance)) + HARNESS_TIMING_SLACK_NS;
+    const bool passed = value <= limit;
+    TraceLog(passed ? LOG_INFO : LOG_WARNING, "HARNESS: %-7s %8.3f ms, baseline %8.3f ms (%+.1f%%)%s", name, NsToMs(value), NsToMs(baseline),
+        baseline > 0 ? ((double)value / (double)baseline - 1.0) * 100.0 : 0.0, passed ? "" : "  REGRESSION");
+    return passed;
+}
+
+static bool CompareSummaries(const HarnessSummary* current, const HarnessSummary* baseline, float tolerance, bool gpuTiming)
+{
+    if (current->seed != baseline->seed || current->frameCount != baseline->frameCount)
+    {
+        TraceLog(LOG_WARNING, "HARNESS: Baseline is from another run (seed %llu, %llu frames)",
+            (unsigned long long)baseline->seed, (unsigned long long)baseline->frameCount);
+        return false;
+    }
+
+    bool passed = true;
+    int mismatches = 0;
+    for (int i = 0; i < current->checkpointCount; ++i)
+    {
+        for (int j = 0; j < baseline->checkpointCount; ++j)
+        {
+            if (baseline->checkpoints[j].frame == current->checkpoints[i].frame && baseline->checkpoints[j].hash != current->checkpoints[i].hash)
+            {
+                if (mismatches++ == 0)
+                {
+                    TraceLog(LOG_WARNING, "HARNESS: Frame %llu differs from the baseline", (unsigned long long)current->checkpoints[i].frame);
+                }
+            }
+        }
+    }
+    if (mismatches > 0)
+    {
+        TraceLog(LOG_WARNING, "HARNESS: %d of %d checkpoints differ", mismatches, current->checkpointCount);
+        passed = false;
+    }
+    if (current->drawCalls != baseline->drawCalls)
+    {
+        TraceLog(LOG_WARNING, "HARNESS: %llu draw calls, baseline %llu", (unsigned long long)current->drawCalls, (unsigned long long)baseline->drawCalls);
+        passed = false;
+    }
+
+    passed &= CompareTiming("CPU p50", current->cpuP50Ns, baseline->cpuP50Ns, tolerance);
+    passed &= CompareTiming("CPU p95", current->cpuP95Ns, baseline->cpuP95Ns, tolerance);
+    if (gpuTiming && baseline->gpuP50Ns > 0)
+    {
+        passed &= CompareTiming("GPU p50", current->gpuP50Ns, baseline->gpuP50Ns, tolerance);
+        passed &= CompareTiming("GPU p95", current->gpuP95Ns, baseline->gpuP95Ns, tolerance);
+    }
+    return passed;
+}
+
+bool HarnessFinish(Harness* harness)
+{
+    // Queries still in flight, the last frames wait for the GPU here
+    const uint64_t pending = harness->frame < HARNESS_GPU_QUERY_COUNT ? harness->frame : HARNESS_GPU_QUERY_COUNT;
+    for (uint64_t frame = harness->frame - pending; frame < harness->frame; ++frame)
+    {
+        CollectGpuTime(harness, frame);
+    }
+
+    HarnessSummary* current = (HarnessSummary*)GameAlloc(sizeof(HarnessSummary));
+    HarnessSummary* baseline = (HarnessSummary*)GameAlloc(sizeof(HarnessSummary));
+    bool passed = current != NULL && baseline != NULL;
+    if (passed)
+    {
+        Summarize(harness, current);
+        TraceLog(LOG_INFO, "HARNESS: %llu frames, CPU p50 %.3f ms p95 %.3f ms, GPU p50 %.3f ms p95 %.3f ms, %llu draw calls, %d checkpoints",
+            (unsigned long long)current->frameCount, NsToMs(current->cpuP50Ns), NsToMs(current->cpuP95Ns),
+            NsToMs(current->gpuP50Ns), NsToMs(current->gpuP95Ns), (unsigned long long)current->drawCalls, current->checkpointCount);
+
+        if (harness->config.reportFileName != NULL)
+        {
+            if (WriteReport(harness, current, harness->config.reportFileName))
+            {
+                TraceLog(LOG_INFO, "HARNESS: Report written to %s", harness->config.reportFileName);
+            }
+            else
+            {
+                TraceLog(LOG_WARNING, "HARNESS: Failed to write %s", harness->config.reportFileName);
+                passed = false;
+            }
+        }
+
+        if (harness->config.baselineFileName != NULL)
+        {
+            if (!ReadReport(harness->config.baselineFileName, baseline))
+            {
+                TraceLog(LOG_WARNING, "HARNESS: Failed to read baseline %s", harness->config.baselineFileName);
+                passed = false;
+            }
+            else
+            {
+                passed &= CompareSummaries(current, baseline, harness->config.tolerance, harness->gpuTiming);
+                TraceLog(passed ? LOG_INFO : LOG_WARNING, "HARNESS: %s against %s", passed ? "Passed" : "Failed", harness->config.baselineFileName);
+            }
+        }
+    }
+    free(current);
+    free(baseline);
+
+    for (int i = 0; i < HARNESS_GPU_QUERY_COUNT; ++i)
+    {
+        rlUnloadTimerQuery(harness->queries[i]);
+    }
+    UnloadAutomationEventList(harness->events);
+    free(harness->frames);
+    free(harness->checkpoints);
+    free(harness->screenPixels);
+    memset(harness, 0, sizeof(*harness));
+    return passed;
+}
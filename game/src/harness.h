@@ -0,0 +1,89 @@
+#pragma once
+
+#include "stdbool.h"
+#include "stddef.h"
+#include "stdint.h"
+
+#include "raylib.h"
+
+// Input replay performance harness. A raylib automation event list, recorded from launch with
+// --record-input, is played against the normal frame loop on a fixed 60 Hz virtual timestep. Every
+// frame's CPU time, GPU time (timer queries, read a few frames late so they never stall) and draw calls
+// are kept, and the framebuffer is hashed every checkpointInterval frames. The report is a text file
+// the harness also reads back as a baseline: hashes and draw calls must match, the timing percentiles
+// may grow by the tolerance.
+#define HARNESS_FRAMES_PER_SECOND 60
+#define HARNESS_GPU_QUERY_COUNT 4
+#define HARNESS_CHECKPOINT_INTERVAL 60
+#define HARNESS_MAX_CHECKPOINTS 4096
+#define HARNESS_TIMING_SLACK_NS 100000 // Allowed on top of the tolerance, sub-millisecond timings are mostly noise
+#define HARNESS_EVENT_WINDOW_CLOSE 18   // WINDOW_CLOSE of raylib's AutomationEventType, which rcore.c keeps private
+
+typedef struct HarnessConfig_t
+{
+    const char* inputFileName;
+    const char* reportFileName;   // NULL to skip the report
+    const char* baselineFileName; // NULL to skip the comparison
+    int checkpointInterval;
+    float tolerance; // Allowed relative growth of the timing percentiles, 0.1 for 10%
+    uint64_t seed;   // Pattern seed, a baseline made from another seed is rejected
+} HarnessConfig;
+
+typedef struct HarnessFrame_t
+{
+    uint64_t cpuNs;
+    uint64_t gpuNs;
+    int drawCalls;
+    int vertexCount;
+} HarnessFrame;
+
+typedef struct HarnessCheckpoint_t
+{
+    uint64_t frame;
+    uint64_t hash;
+} HarnessCheckpoint;
+
+typedef struct HarnessSummary_t
+{
+    uint64_t seed;
+    uint64_t frameCount;
+    uint64_t cpuP50Ns;
+    uint64_t cpuP95Ns;
+    uint64_t gpuP50Ns;
+    uint64_t gpuP95Ns;
+    uint64_t drawCalls; // Whole run
+    int checkpointCount;
+    HarnessCheckpoint checkpoints[HARNESS_MAX_CHECKPOINTS];
+} HarnessSummary;
+
+typedef struct Harness_t
+{
+    HarnessConfig config;
+    AutomationEventList events;
+    unsigned int nextEvent;
+    unsigned int lastEventFrame;
+
+    uint64_t frame;
+    uint64_t frameStartNs;
+    HarnessFrame* frames;
+    size_t frameCapacity;
+    HarnessCheckpoint* checkpoints;
+    int checkpointCount;
+    unsigned char* screenPixels; // Checkpoint readback, kept between checkpoints
+    size_t screenCapacity;
+
+    bool gpuTiming;
+    unsigned int queries[HARNESS_GPU_QUERY_COUNT]; // Query of frame f is queries[f % HARNESS_GPU_QUERY_COUNT]
+} Harness;
+
+// Call after InitWindow, the event list is loaded and the timer queries are created
+bool HarnessBegin(Harness* harness, const HarnessConfig* config);
+bool HarnessDone(const Harness* harness); // True after the frame of the last event
+double HarnessTime(const Harness* harness); // Virtual time of the current frame
+
+void HarnessBeginFrame(Harness* harness); // Before the frame, plays its events and starts the timers
+void HarnessCapture(Harness* harness);    // Right before EndDrawing, draw calls and checkpoint hash
+void HarnessEndFrame(Harness* harness);   // After EndDrawing
+
+// Writes the report and compares it against the baseline, false on any regression
+bool HarnessFinish(Harness* harness);
@@ -0,0 +1,376 @@
+#include "islandmap.h"
+
+#include "stdio.h"
+#include "stdlib.h"
+
+#include "raylib.h"
+
+#include "bits.h"
+#include "gamealloc.h"
+#include "generator.h"
+#include "timer.h"
+
+#if defined(__linux__)
+#include <string.h>
+#include <unistd.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+#define ISLAND_BENCH_ODD_COLUMNS 0xaaaaaaaaaaaaaaaaull
+
+typedef struct IslandBench_t
+{
+    const IslandBenchmarkConfig* config;
+    bool* horizontalSequence;
+    bool* verticalSequence;
+
+    int* cells; // Row-major, one int per cell, 2 or 4 like the map this replaced
+    uint64_t* rows; // Row-major bits, rowWords words per row
+    size_t rowWords;
+    uint64_t* prefix; // Scratch row for FillRows
+    IslandMap map;
+} IslandBench;
+
+typedef struct IslandBenchLayout_t
+{
+    const char* name;
+    void (*fill)(IslandBench* bench);
+    uint64_t (*columnWalk)(const IslandBench* bench);
+    uint64_t (*blockWalk)(const IslandBench* bench);
+} IslandBenchLayout;
+
+// Cache misses of the calling thread, where the kernel lets us count them
+#if defined(__linux__)
+static int OpenCacheMissCounter(void)
+{
+    struct perf_event_attr attributes;
+    memset(&attributes, 0, sizeof(attributes));
+    attributes.type = PERF_TYPE_HARDWARE;
+    attributes.size = sizeof(attributes);
+    attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+    attributes.disabled = 1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+}
+
+static void StartCounter(int counter)
+{
+    if (counter >= 0)
+    {
+        ioctl(counter, PERF_EVENT_IOC_RESET, 0);
+        ioctl(counter, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+static int64_t StopCounter(int counter)
+{
+    uint64_t count;
+    if (counter < 0 || ioctl(counter, PERF_EVENT_IOC_DISABLE, 0) != 0 || read(counter, &count, sizeof(count)) != sizeof(count))
+    {
+        return -1;
+    }
+    return (int64_t)count;
+}
+
+static void CloseCounter(int counter)
+{
+    if (counter >= 0)
+    {
+        close(counter);
+    }
+}
+#else
+static int OpenCacheMissCounter(void) { return -1; }
+static void StartCounter(int counter) { (void)counter; }
+static int64_t StopCounter(int counter) { (void)counter; return -1; }
+static void CloseCounter(int counter) { (void)counter; }
+#endif
+
+// Row-major int map, filled the way the app did before the tiled map: every cell from its left neighbour
+static void FillCells(IslandBench* bench)
+{
+    const int64_t width = bench->config->width;
+    for (int64_t y = 0; y < bench->config->height; ++y)
+    {
+        const bool yOdd = (y & 1) == 1;
+        int* row = bench->cells + (size_t)y * width;
+        row[0] = y == 0 ? 2 : (bench->verticalSequence[y] ? row[-width] : row[-width] ^ 6);
+        for (int64_t x = 1; x < width; ++x)
+        {
+            const bool keep = yOdd != bench->horizontalSequence[x];
+            row[x] = keep ? row[x - 1] : row[x - 1] ^ 6;
+        }
+    }
+}
+
+static uint64_t ColumnWalkCells(const IslandBench* bench)
+{
+    const int64_t width = bench->config->width;
+    uint64_t changes = 0;
+    for (int64_t x = 0; x < width; ++x)
+    {
+        for (int64_t y = 1; y < bench->config->height; ++y)
+        {
+            changes += bench->cells[(size_t)y * width + x] != bench->cells[(size_t)(y - 1) * width + x];
+        }
+    }
+    return changes;
+}
+
+static uint64_t BlockWalkCells(const IslandBench* bench)
+{
+    const int64_t width = bench->config->width;
+    const int64_t height = bench->config->height;
+    uint64_t changes = 0;
+    for (int64_t top = 0; top < height; top += ISLAND_MAP_TILE_SIDE)
+    {
+        for (int64_t left = 0; left < width; left += ISLAND_MAP_TILE_SIDE)
+        {
+            for (int64_t x = left; x < left + ISLAND_MAP_TILE_SIDE && x < width; ++x)
+            {
+                for (int64_t y = top > 0 ? top : 1; y < top + ISLAND_MAP_TILE_SIDE && y < height; ++y)
+                {
+                    changes += bench->cells[(size_t)y * width + x] != bench->cells[(size_t)(y - 1) * width + x];
+                }
+            }
+        }
+    }
+    return changes;
+}
+
+// Row-major bits with the same closed-form fill as IslandMapFill
+static void FillRows(IslandBench* bench)
+{
+    bool prefixParity = false;
+    for (size_t word = 0; word < bench->rowWords; ++word)
+    {
+        bench->prefix[word] = 0;
+    }
+    for (int64_t x = 1; x < bench->config->width; ++x)
+    {
+        prefixParity ^= bench->horizontalSequence[x];
+        BitSet(bench->prefix, (size_t)x, prefixParity);
+    }
+
+    bool columnParity = false;
+    for (int64_t y = 0; y < bench->config->height; ++y)
+    {
+        columnParity ^= y > 0 && !bench->verticalSequence[y];
+        const uint64_t flips = (columnParity ? 0 : ~0ull) ^ ((y & 1) == 0 ? ISLAND_BENCH_ODD_COLUMNS : 0);
+        uint64_t* row = bench->rows + (size_t)y * bench->rowWords;
+        for (size_t word = 0; word < bench->rowWords; ++word)
+        {
+            row[word] = bench->prefix[word] ^ flips;
+        }
+    }
+}
+
+static uint64_t ColumnWalkRows(const IslandBench* bench)
+{
+    uint64_t changes = 0;
+    for (int64_t x = 0; x < bench->config->width; ++x)
+    {
+        for (int64_t y = 1; y < bench->config->height; ++y)
+        {
+            changes += BitGet(bench->rows + (size_t)y * bench->rowWords, (size_t)x) != BitGet(bench->rows + (size_t)(y - 1) * bench->rowWords, (size_t)x);
+        }
+    }
+    return changes;
+}
+
+static uint64_t BlockWalkRows(const IslandBench* bench)
+{
+    const int64_t width = bench->config->width;
+    const int64_t height = bench->config->height;
+    uint64_t changes = 0;
+    for (int64_t top = 0; top < height; top += ISLAND_MAP_TILE_SIDE)
+    {
+        for (int64_t left = 0; left < width; left += ISLAND_MAP_TILE_SIDE)
+        {
+            for (int64_t x = left; x < left + ISLAND_MAP_TILE_SIDE && x < width; ++x)
+            {
+                // Blocks are word aligned, so a block column is one bit of one word in every row
+                const uint64_t* word = bench->rows + (size_t)(left / 64);
+                const int bit = (int)(x - left);
+                for (int64_t y = top > 0 ? top : 1; y < top + ISLAND_MAP_TILE_SIDE && y < height; ++y)
+                {
+                    changes += ((word[(size_t)y * bench->rowWords] ^ word[(size_t)(y - 1) * bench->rowWords]) >> bit) & 1;
+                }
+            }
+        }
+    }
+    return changes;
+}
+
+static void FillTiles(IslandBench* bench)
+{
+    IslandMapFill(&bench->map, bench->horizontalSequence, bench->verticalSequence, bench->prefix, 2, NULL, NULL);
+}
+
+static uint64_t ColumnWalkTiles(const IslandBench* bench)
+{
+    uint64_t changes = 0;
+    for (int64_t x = 0; x < bench->config->width; ++x)
+    {
+        for (int64_t y = 1; y < bench->config->height; ++y)
+        {
+            changes += IslandMapIsRed(&bench->map, x, y) != IslandMapIsRed(&bench->map, x, y - 1);
+        }
+    }
+    return changes;
+}
+
+static uint64_t BlockWalkTiles(const IslandBench* bench)
+{
+    const int64_t width = bench->config->width;
+    const int64_t height = bench->config->height;
+    uint64_t changes = 0;
+    for (int64_t top = 0; top < height; top += ISLAND_MAP_TILE_SIDE)
+    {
+        for (int64_t left = 0; left < width; left += ISLAND_MAP_TILE_SIDE)
+        {
+            for (int64_t x = left; x < left + ISLAND_MAP_TILE_SIDE && x < width; ++x)
+            {
+                // The block is one tile, only its top row looks into the tile above
+                const uint64_t* tile = IslandMapTileRow(&bench->map, left / ISLAND_MAP_TILE_SIDE, top);
+                const int bit = (int)(x - left);
+                if (top > 0)
+                {
+                    changes += IslandMapIsRed(&bench->map, x, top) != IslandMapIsRed(&bench->map, x, top - 1);
+                }
+                for (int64_t y = top + 1; y < top + ISLAND_MAP_TILE_SIDE && y < height; ++y)
+                {
+                    changes += ((tile[y - top] ^ tile[y - top - 1]) >> bit) & 1;
+                }
+            }
+        }
+    }
+    return changes;
+}
+
+static const char* FormatMisses(int64_t misses, double cellCount, char* buffer, size_t size)
+{
+    if (misses < 0)
+    {
+        return "n/a";
+    }
+    snprintf(buffer, size, "%.4f", (double)misses / cellCount);
+    return buffer;
+}
+
+// Best of the repeats, so page faults of the first touch and other noise don't count
+static uint64_t Measure(IslandBench* bench, const IslandBenchLayout* layout, const char* operation, int counter)
+{
+    uint64_t checksum = 0;
+    const double cellCount = (double)bench->config->width * (double)bench->config->height;
+    uint64_t bestNs = UINT64_MAX;
+    int64_t bestMisses = -1;
+    for (int repeat = 0; repeat < bench->config->repeats; ++repeat)
+    {
+        StartCounter(counter);
+        const uint64_t startNs = GetMonotonicTimeNs();
+        if (operation[0] == 'f')
+        {
+            layout->fill(bench);
+        }
+        else
+        {
+            checksum = operation[0] == 'c' ? layout->columnWalk(bench) : layout->blockWalk(bench);
+        }
+        const uint64_t elapsedNs = GetMonotonicTimeNs() - startNs;
+        const int64_t misses = StopCounter(counter);
+        if (elapsedNs < bestNs)
+        {
+            bestNs = elapsedNs;
+            bestMisses = misses;
+        }
+    }
+
+    char missBuffer[32];
+    TraceLog(LOG_INFO, "ISLANDS: %-10s %-7s %8.3f ns/cell, %s cache misses/cell", layout->name, operation,
+        (double)bestNs / cellCount, FormatMisses(bestMisses, cellCount, missBuffer, sizeof(missBuffer)));
+    return checksum;
+}
+
+bool IslandBenchmarkRun(const IslandBenchmarkConfig* config)
+{
+    if (config->width <= 0 || config->height <= 0 || config->repeats <= 0)
+    {
+        TraceLog(LOG_WARNING, "ISLANDS: Invalid benchmark size %lldx%lld", (long long)config->width, (long long)config->height);
+        return false;
+    }
+
+    const size_t cellCount = (size_t)config->width * (size_t)config->height;
+    IslandBench bench = { .config = config, .rowWords = BitWordCount((size_t)config->width) };
+    bench.horizontalSequence = (bool*)GameAlloc((size_t)config->width * sizeof(bool));
+    bench.verticalSequence = (bool*)GameAlloc((size_t)config->height * sizeof(bool));
+    bench.cells = (int*)GameAlloc(cellCount * sizeof(int));
+    bench.rows = (uint64_t*)GameAlloc(bench.rowWords * (size_t)config->height * sizeof(uint64_t));
+    bench.prefix = (uint64_t*)GameAlloc(bench.rowWords * sizeof(uint64_t));
+    uint64_t* tiles = (uint64_t*)GameAlloc(IslandMapWordCount(config->width, config->height) * sizeof(uint64_t));
+    if (bench.horizontalSequence == NULL || bench.verticalSequence == NULL || bench.cells == NULL || bench.rows == NULL || bench.prefix == NULL || tiles == NULL)
+    {
+        TraceLog(LOG_WARNING, "ISLANDS: Could not allocate a %lldx%lld grid in every layout", (long long)config->width, (long long)config->height);
+        free(bench.horizontalSequence);
+        free(bench.verticalSequence);
+        free(bench.cells);
+        free(bench.rows);
+        free(bench.prefix);
+        free(tiles);
+        return false;
+    }
+    IslandMapInit(&bench.map, tiles, config->width, config->height);
+
+    for (int64_t x = 0; x < config->width; ++x)
+    {
+        bench.horizontalSequence[x] = GeneratorStitch(config->seed, SEQUENCE_HORIZONTAL, x, 0.5f);
+    }
+    for (int64_t y = 0; y < config->height; ++y)
+    {
+        bench.verticalSequence[y] = GeneratorStitch(config->seed, SEQUENCE_VERTICAL, y, 0.5f);
+    }
+
+    static const IslandBenchLayout layouts[] = {
+        { "int rows", FillCells, ColumnWalkCells, BlockWalkCells },
+        { "bit rows", FillRows, ColumnWalkRows, BlockWalkRows },
+        { "bit tiles", FillTiles, ColumnWalkTiles, BlockWalkTiles },
+    };
+    static const char* operations[] = { "fill", "columns", "blocks" };
+
+    const int counter = OpenCacheMissCounter();
+    TraceLog(LOG_INFO, "ISLANDS: %lldx%lld grid, best of %d, cache misses %s", (long long)config->width, (long long)config->height,
+        config->repeats, counter >= 0 ? "counted" : "not readable");
+
+    // Every layout walks the same cells, so the vertical change counts must agree
+    bool agree = true;
+    uint64_t expected = 0;
+    for (size_t i = 0; i < sizeof(layouts) / sizeof(layouts[0]); ++i)
+    {
+        for (size_t j = 0; j < sizeof(operations) / sizeof(operations[0]); ++j)
+        {
+            const uint64_t changes = Measure(&bench, &layouts[i], operations[j], counter);
+            if (j == 0)
+            {
+                continue;
+            }
+            expected = i == 0 && j == 1 ? changes : expected;
+            agree = agree && changes == expected;
+        }
+    }
+    CloseCounter(counter);
+    if (!agree)
+    {
+        TraceLog(LOG_WARNING, "ISLANDS: Layouts disagree on the grid");
+    }
+
+    free(bench.horizontalSequence);
+    free(bench.verticalSequence);
+    free(bench.cells);
+    free(bench.rows);
+    free(bench.prefix);
+    free(tiles);
+    return agree;
+}
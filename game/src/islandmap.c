@@ -0,0 +1,147 @@
+#include "islandmap.h"
+
+#include "string.h"
+
+#include "bits.h"
+
+#define ISLAND_ODD_COLUMNS 0xaaaaaaaaaaaaaaaaull
+
+size_t IslandMapWordCount(int64_t gridWidth, int64_t gridHeight)
+{
+    const size_t tileColumns = (size_t)((gridWidth + ISLAND_MAP_TILE_SIDE - 1) / ISLAND_MAP_TILE_SIDE);
+    const size_t tileRows = (size_t)((gridHeight + ISLAND_MAP_TILE_SIDE - 1) / ISLAND_MAP_TILE_SIDE);
+    return tileColumns * tileRows * ISLAND_MAP_TILE_SIDE;
+}
+
+void IslandMapInit(IslandMap* map, uint64_t* tiles, int64_t gridWidth, int64_t gridHeight)
+{
+    map->tiles = tiles;
+    map->gridWidth = gridWidth;
+    map->gridHeight = gridHeight;
+    map->tileColumns = (gridWidth + ISLAND_MAP_TILE_SIDE - 1) / ISLAND_MAP_TILE_SIDE;
+    map->tileRows = (gridHeight + ISLAND_MAP_TILE_SIDE - 1) / ISLAND_MAP_TILE_SIDE;
+}
+
+static uint64_t LastWordMask(const IslandMap* map)
+{
+    return (map->gridWidth & 63) != 0 ? (1ull << (map->gridWidth & 63)) - 1 : ~0ull;
+}
+
+void IslandMapFill(IslandMap* map, const bool* horizontalSequence, const bool* verticalSequence, uint64_t* prefix, int originIsland, IslandMapBandDone bandDone, void* context)
+{
+    // Bit x of the prefix is the parity of the stitches of columns 1 to x. An odd row changes island at every
+    // stitch it crosses and an even row at every gap, which is the prefix with the odd columns flipped.
+    const size_t rowWords = (size_t)map->tileColumns;
+    memset(prefix, 0, rowWords * sizeof(uint64_t));
+    bool prefixParity = false;
+    for (int64_t x = 1; x < map->gridWidth; ++x)
+    {
+        prefixParity ^= horizontalSequence[x];
+        BitSet(prefix, (size_t)x, prefixParity);
+    }
+    if (rowWords > 0)
+    {
+        prefix[rowWords - 1] &= LastWordMask(map);
+    }
+
+    // Column 0 changes island at every gap of the vertical sequence
+    bool columnParity = false;
+    uint64_t rowFlips[ISLAND_MAP_TILE_SIDE];
+    for (int64_t band = 0; band < map->tileRows; ++band)
+    {
+        const int64_t yStart = band * ISLAND_MAP_TILE_SIDE;
+        const int rowCount = map->gridHeight - yStart < ISLAND_MAP_TILE_SIDE ? (int)(map->gridHeight - yStart) : ISLAND_MAP_TILE_SIDE;
+        for (int row = 0; row < rowCount; ++row)
+        {
+            const int64_t y = yStart + row;
+            columnParity ^= y > 0 && !verticalSequence[y];
+            const bool red = (originIsland == 2) != columnParity;
+            rowFlips[row] = (red ? ~0ull : 0) ^ ((y & 1) == 0 ? ISLAND_ODD_COLUMNS : 0);
+        }
+
+        uint64_t* tile = map->tiles + (size_t)(band * map->tileColumns) * ISLAND_MAP_TILE_SIDE;
+        for (size_t column = 0; column < rowWords; ++column)
+        {
+            const uint64_t mask = column + 1 == rowWords ? LastWordMask(map) : ~0ull;
+            for (int row = 0; row < ISLAND_MAP_TILE_SIDE; ++row)
+            {
+                tile[row] = row < rowCount ? (prefix[column] ^ rowFlips[row]) & mask : 0;
+            }
+            tile += ISLAND_MAP_TILE_SIDE;
+        }
+
+        if (bandDone != NULL)
+        {
+            bandDone(context, band);
+        }
+    }
+}
+
+void IslandMapReadRow(const IslandMap* map, int64_t y, uint64_t* bits)
+{
+    const uint64_t* row = IslandMapTileRow(map, 0, y);
+    for (int64_t word = 0; word < map->tileColumns; ++word)
+    {
+        bits[word] = row[word * ISLAND_MAP_TILE_SIDE];
+    }
+}
+
+void IslandMapWriteRow(IslandMap* map, int64_t y, const uint64_t* bits)
+{
+    uint64_t* row = IslandMapTileRow(map, 0, y);
+    for (int64_t word = 0; word < map->tileColumns; ++word)
+    {
+        row[word * ISLAND_MAP_TILE_SIDE] = bits[word];
+    }
+    if (map->tileColumns > 0)
+    {
+        row[(map->tileColumns - 1) * ISLAND_MAP_TILE_SIDE] &= LastWordMask(map);
+    }
+}
+
+IslandMapIterator IslandMapIterate(const IslandMap* map, int64_t x, int64_t y, int64_t width, int64_t height)
+{
+    IslandMapIterator iterator = {
+        .map = map,
+        .left = x < 0 ? 0 : x,
+        .top = y < 0 ? 0 : y,
+        .right = x + width < map->gridWidth ? x + width : map->gridWidth,
+        .bottom = y + height < map->gridHeight ? y + height : map->gridHeight,
+    };
+    const bool empty = iterator.left >= iterator.right || iterator.top >= iterator.bottom;
+    iterator.tileX = iterator.left / ISLAND_MAP_TILE_SIDE;
+    iterator.tileY = empty ? iterator.bottom / ISLAND_MAP_TILE_SIDE + 1 : iterator.top / ISLAND_MAP_TILE_SIDE;
+    iterator.y = iterator.top;
+    return iterator;
+}
+
+bool IslandMapNext(IslandMapIterator* iterator, IslandMapSpan* span)
+{
+    while (iterator->tileY * ISLAND_MAP_TILE_SIDE < iterator->bottom)
+    {
+        const int64_t tileBottom = (iterator->tileY + 1) * ISLAND_MAP_TILE_SIDE;
+        if (iterator->y < (tileBottom < iterator->bottom ? tileBottom : iterator->bottom))
+        {
+            const int64_t tileLeft = iterator->tileX * ISLAND_MAP_TILE_SIDE;
+            const int64_t start = iterator->left > tileLeft ? iterator->left : tileLeft;
+            const int64_t end = iterator->right < tileLeft + ISLAND_MAP_TILE_SIDE ? iterator->right : tileLeft + ISLAND_MAP_TILE_SIDE;
+            span->x = start;
+            span->y = iterator->y;
+            span->count = (int)(end - start);
+            span->red = *IslandMapTileRow(iterator->map, iterator->tileX, iterator->y) >> (start - tileLeft);
+            iterator->y++;
+            return true;
+        }
+
+        // Next tile to the right, or the first one of the next band
+        iterator->tileX++;
+        if (iterator->tileX * ISLAND_MAP_TILE_SIDE >= iterator->right)
+        {
+            iterator->tileX = iterator->left / ISLAND_MAP_TILE_SIDE;
+            iterator->tileY++;
+        }
+        const int64_t tileTop = iterator->tileY * ISLAND_MAP_TILE_SIDE;
+        iterator->y = iterator->top > tileTop ? iterator->top : tileTop;
+    }
+    return false;
+}
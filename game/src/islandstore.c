@@ -0,0 +1,190 @@
+#include "islandstore.h"
+
+#include "string.h"
+#include "stdlib.h"
+
+#include "gamealloc.h"
+
+// NOTE: This file must not include raylib.h, windows.h clashes with it
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+static bool MapScratchFile(IslandStore* store, const char* fileName, size_t size)
+{
+#if defined(_WIN32)
+    HANDLE fileHandle = CreateFileA(fileName, GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_ALWAYS,
+        FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, NULL);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    HANDLE mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READWRITE, (DWORD)((uint64_t)size >> 32), (DWORD)size, NULL);
+    void* mapping = mappingHandle != NULL ? MapViewOfFile(mappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, size) : NULL;
+    if (mapping == NULL)
+    {
+        if (mappingHandle != NULL)
+        {
+            CloseHandle(mappingHandle);
+        }
+        CloseHandle(fileHandle);
+        return false;
+    }
+
+    store->map.tiles = (uint64_t*)mapping;
+    store->fileHandle = fileHandle;
+    store->mappingHandle = mappingHandle;
+    return true;
+#else
+    const int descriptor = open(fileName, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (descriptor < 0)
+    {
+        return false;
+    }
+
+    // The file stays sparse until it is written, and is unlinked at once so it never outlives the mapping
+    void* mapping = ftruncate(descriptor, (off_t)size) == 0 ? mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0) : MAP_FAILED;
+    unlink(fileName);
+    close(descriptor);
+    if (mapping == MAP_FAILED)
+    {
+        return false;
+    }
+
+    store->map.tiles = (uint64_t*)mapping;
+    return true;
+#endif
+}
+
+// Page-aligned byte range of a band, partial pages at its top are shared with the band above
+static void BandRange(const IslandStore* store, int64_t band, uint8_t** start, size_t* size)
+{
+    const size_t bandBytes = (size_t)store->map.tileColumns * ISLAND_MAP_TILE_SIDE * sizeof(uint64_t);
+    const size_t first = ((size_t)band * bandBytes) & ~(store->pageSize - 1);
+    *start = (uint8_t*)store->map.tiles + first;
+    *size = (size_t)(band + 1) * bandBytes - first;
+}
+
+static void PrefetchBand(const IslandStore* store, int64_t band)
+{
+#if !defined(_WIN32) && defined(MADV_WILLNEED)
+    if (band >= 0 && band < store->map.tileRows)
+    {
+        uint8_t* start;
+        size_t size;
+        BandRange(store, band, &start, &size);
+        madvise(start, size, MADV_WILLNEED);
+    }
+#else
+    (void)store;
+    (void)band;
+#endif
+}
+
+// Starts the write-back of a band and drops it from the process, the page cache still holds it until it is
+// written, so a page shared with the next band only faults back in
+static void ReleaseBand(const IslandStore* store, int64_t band, bool written)
+{
+    uint8_t* start;
+    size_t size;
+    BandRange(store, band, &start, &size);
+#if defined(_WIN32)
+    if (written)
+    {
+        FlushViewOfFile(start, size);
+    }
+    VirtualUnlock(start, size); // NOTE: Unlocking pages that are not locked trims them from the working set
+#else
+    if (written)
+    {
+        msync(start, size, MS_ASYNC);
+    }
+    madvise(start, size, MADV_DONTNEED);
+#endif
+}
+
+static void ReleaseFilledBand(void* context, int64_t band)
+{
+    ReleaseBand((const IslandStore*)context, band, true);
+}
+
+bool IslandStoreCreate(IslandStore* store, const char* fileName, int64_t gridWidth, int64_t gridHeight)
+{
+    memset(store, 0, sizeof(*store));
+    if (gridWidth <= 0 || gridHeight <= 0 || (uint64_t)gridWidth > ISLAND_STORE_MAX_CELLS / (uint64_t)gridHeight)
+    {
+        return false;
+    }
+
+    const uint64_t size = (uint64_t)IslandMapWordCount(gridWidth, gridHeight) * sizeof(uint64_t);
+    if ((uint64_t)(size_t)size != size || !MapScratchFile(store, fileName, (size_t)size))
+    {
+        return false;
+    }
+
+    IslandMapInit(&store->map, store->map.tiles, gridWidth, gridHeight);
+    store->mappingSize = (size_t)size;
+    store->residentBand = -1;
+#if defined(_WIN32)
+    SYSTEM_INFO system;
+    GetSystemInfo(&system);
+    store->pageSize = system.dwPageSize;
+#else
+    store->pageSize = (size_t)sysconf(_SC_PAGESIZE);
+#if defined(MADV_SEQUENTIAL)
+    madvise(store->map.tiles, store->mappingSize, MADV_SEQUENTIAL);
+#endif
+#endif
+    return true;
+}
+
+void IslandStoreClose(IslandStore* store)
+{
+    if (store->map.tiles != NULL)
+    {
+#if defined(_WIN32)
+        UnmapViewOfFile(store->map.tiles);
+        CloseHandle(store->mappingHandle);
+        CloseHandle(store->fileHandle);
+#else
+        munmap(store->map.tiles, store->mappingSize);
+#endif
+    }
+    memset(store, 0, sizeof(*store));
+}
+
+bool IslandStoreFill(IslandStore* store, const bool* horizontalSequence, const bool* verticalSequence, int originIsland)
+{
+    // A store is filled once per export, so the column parities take a short-lived allocation
+    uint64_t* prefix = (uint64_t*)GameCalloc(store->map.tileColumns > 0 ? (size_t)store->map.tileColumns : 1, sizeof(uint64_t));
+    if (prefix == NULL)
+    {
+        return false;
+    }
+    store->residentBand = -1;
+    IslandMapFill(&store->map, horizontalSequence, verticalSequence, prefix, originIsland, ReleaseFilledBand, store);
+    free(prefix);
+    return true;
+}
+
+void IslandStoreReadRow(IslandStore* store, int64_t y, uint64_t* bits)
+{
+    const int64_t band = y / ISLAND_MAP_TILE_SIDE;
+    if (band != store->residentBand)
+    {
+        if (store->residentBand >= 0)
+        {
+            ReleaseBand(store, store->residentBand, false);
+        }
+        PrefetchBand(store, band + 1);
+        store->residentBand = band;
+    }
+    IslandMapReadRow(&store->map, y, bits);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "stdbool.h"
+#include "stddef.h"
+#include "stdint.h"
+
+#include "islandmap.h"
+
+// Out-of-core island map for grids that don't fit in memory: an IslandMap whose tiles live in a shared
+// mapping of a scratch file, so the page cache decides what stays resident. Tiles are stored band by band,
+// a band being one row of tiles, and fills and row reads walk the bands from the top, prefetching the next
+// band and dropping the finished one, so only a couple of bands are ever held by the process.
+#define ISLAND_STORE_MAX_CELLS (1ull << 36) // 8 GiB of tiles
+
+typedef struct IslandStore_t
+{
+    IslandMap map; // Tiles point into the mapping
+    size_t mappingSize;
+    size_t pageSize;
+    int64_t residentBand; // Band IslandStoreReadRow last read from, -1 if none
+
+    void* fileHandle;
+    void* mappingHandle;
+} IslandStore;
+
+// Creates the scratch file and maps it, the file is deleted again when the store is closed
+bool IslandStoreCreate(IslandStore* store, const char* fileName, int64_t gridWidth, int64_t gridHeight);
+void IslandStoreClose(IslandStore* store);
+
+bool IslandStoreFill(IslandStore* store, const bool* horizontalSequence, const bool* verticalSequence, int originIsland);
+void IslandStoreReadRow(IslandStore* store, int64_t y, uint64_t* bits); // Rows read in order stream through the bands
@@ -0,0 +1,216 @@
+#include "lod.h"
+
+#include "assert.h"
+#include "stdint.h"
+
+#include "bits.h"
+
+// The 2-coloring has a closed form. With H(x) = h[1] ^ ... ^ h[x] and V(y) = v[1] ^ ... ^ v[y]
+// a cell differs from cell (0, 0) when
+//     (y & 1) ^ V(y) ^ H(x) ^ ((x & 1) & !(y & 1))
+// so it splits into a per-column term, picked by row parity, and a per-row term. The red cells
+// of a texel are then counted from column popcounts and row tallies without visiting cells.
+
+typedef struct LodScratch_t
+{
+    uint64_t* evenRowColumnBits; // H(x) ^ (x & 1)
+    uint64_t* oddRowColumnBits;  // H(x)
+    uint64_t* horizontalBits;
+    int* evenRowColumnCounts;
+    int* oddRowColumnCounts;
+    int* horizontalCounts;
+    int* rowTallies;             // Per texel row, rows counted by [parity][row term ^ origin]
+    int* verticalCounts;
+    Color* pixels;
+} LodScratch;
+
+static size_t LodScratchSize(const LodPattern* pattern)
+{
+    const size_t alignment = 64;
+    const size_t words = BitWordCount(pattern->gridWidth);
+    return 3 * words * sizeof(uint64_t)
+        + 3 * (size_t)pattern->columns * sizeof(int)
+        + 5 * (size_t)pattern->rows * sizeof(int)
+        + (size_t)pattern->columns * pattern->rows * sizeof(Color)
+        + 9 * alignment;
+}
+
+static LodScratch AllocateScratch(Arena* arena, const LodPattern* pattern)
+{
+    const size_t required = LodScratchSize(pattern);
+    if (required > arena->capacity)
+    {
+        const size_t grown = arena->capacity + arena->capacity / 2;
+        ArenaRelease(arena);
+        const bool created = ArenaInit(arena, grown > required ? grown : required);
+        assert(created);
+        (void)created;
+    }
+    ArenaReset(arena);
+
+    const size_t words = BitWordCount(pattern->gridWidth);
+    LodScratch scratch;
+    scratch.evenRowColumnBits = (uint64_t*)ArenaPush(arena, words * sizeof(uint64_t), 64);
+    scratch.oddRowColumnBits = (uint64_t*)ArenaPush(arena, words * sizeof(uint64_t), 64);
+    scratch.horizontalBits = (uint64_t*)ArenaPush(arena, words * sizeof(uint64_t), 64);
+    scratch.evenRowColumnCounts = (int*)ArenaPush(arena, pattern->columns * sizeof(int), 64);
+    scratch.oddRowColumnCounts = (int*)ArenaPush(arena, pattern->columns * sizeof(int), 64);
+    scratch.horizontalCounts = (int*)ArenaPush(arena, pattern->columns * sizeof(int), 64);
+    scratch.rowTallies = (int*)ArenaPush(arena, 4 * (size_t)pattern->rows * sizeof(int), 64);
+    scratch.verticalCounts = (int*)ArenaPush(arena, pattern->rows * sizeof(int), 64);
+    scratch.pixels = (Color*)ArenaPush(arena, (size_t)pattern->columns * pattern->rows * sizeof(Color), 64);
+    return scratch;
+}
+
+static void PackColumns(const LodScratch* scratch, const LodPattern* pattern)
+{
+    bool parity = false;
+    uint64_t evenWord = 0;
+    uint64_t oddWord = 0;
+    uint64_t horizontalWord = 0;
+    for (int x = 0; x < pattern->gridWidth; ++x)
+    {
+        const bool stitch = pattern->horizontalSequence[x];
+        if (x > 0)
+        {
+            parity ^= stitch;
+        }
+
+        const int bit = x & 63;
+        oddWord |= (uint64_t)parity << bit;
+        evenWord |= (uint64_t)(parity ^ (x & 1)) << bit;
+        horizontalWord |= (uint64_t)stitch << bit;
+        if (bit == 63 || x + 1 == pattern->gridWidth)
+        {
+            scratch->evenRowColumnBits[x >> 6] = evenWord;
+            scratch->oddRowColumnBits[x >> 6] = oddWord;
+            scratch->horizontalBits[x >> 6] = horizontalWord;
+            evenWord = oddWord = horizontalWord = 0;
+        }
+    }
+
+    const int cellsPerTexel = 1 << pattern->shift;
+    for (int column = 0; column < pattern->columns; ++column)
+    {
+        const size_t start = (size_t)column * cellsPerTexel;
+        scratch->evenRowColumnCounts[column] = PopcountRange(scratch->evenRowColumnBits, start, cellsPerTexel);
+        scratch->oddRowColumnCounts[column] = PopcountRange(scratch->oddRowColumnBits, start, cellsPerTexel);
+        scratch->horizontalCounts[column] = PopcountRange(scratch->horizontalBits, start, cellsPerTexel);
+    }
+}
+
+static void TallyRows(const LodScratch* scratch, const LodPattern* pattern)
+{
+    const int cellsPerTexel = 1 << pattern->shift;
+    const bool originRed = pattern->originIsland == 2;
+    bool parity = false;
+    for (int row = 0; row < pattern->rows; ++row)
+    {
+        int* tallies = scratch->rowTallies + row * 4;
+        tallies[0] = tallies[1] = tallies[2] = tallies[3] = 0;
+        scratch->verticalCounts[row] = 0;
+        for (int y = row * cellsPerTexel; y < (row + 1) * cellsPerTexel; ++y)
+        {
+            const bool stitch = pattern->verticalSequence[y];
+            if (y > 0)
+            {
+                parity ^= stitch;
+            }
+            const bool yOdd = (y & 1) == 1;
+            const bool term = yOdd ^ parity ^ originRed;
+            tallies[yOdd * 2 + term]++;
+            scratch->verticalCounts[row] += stitch;
+        }
+    }
+}
+
+static Color LerpColor(Color from, Color to, float amount)
+{
+    return (Color){
+        (unsigned char)(from.r + (to.r - from.r) * amount),
+        (unsigned char)(from.g + (to.g - from.g) * amount),
+        (unsigned char)(from.b + (to.b - from.b) * amount),
+        255,
+    };
+}
+
+static void ShadeTexels(const LodScratch* scratch, const LodPattern* pattern)
+{
+    const int64_t cellsPerTexel = (int64_t)1 << pattern->shift;
+    const float invCells = 1.0f / (float)(cellsPerTexel * cellsPerTexel);
+    for (int row = 0; row < pattern->rows; ++row)
+    {
+        const int* tallies = scratch->rowTallies + row * 4;
+        Color* pixels = scratch->pixels + (size_t)row * pattern->columns;
+        if (pattern->colored)
+        {
+            // A cell is red when its column term differs from the row term, see the comment on top
+            for (int column = 0; column < pattern->columns; ++column)
+            {
+                const int64_t even = scratch->evenRowColumnCounts[column];
+                const int64_t odd = scratch->oddRowColumnCounts[column];
+                const int64_t red = tallies[0] * even + tallies[1] * (cellsPerTexel - even)
+                    + tallies[2] * odd + tallies[3] * (cellsPerTexel - odd);
+                pixels[column] = LerpColor(GREEN, RED, red * invCells);
+            }
+        }
+        else
+        {
+            // Column x has vertical stitches on rows of parity h[x], row y horizontal ones on columns of parity v[y]
+            const int64_t rowsEven = cellsPerTexel > 1 ? cellsPerTexel / 2 : (row & 1) == 0;
+            const int64_t rowsOdd = cellsPerTexel - rowsEven;
+            const int64_t vertical = scratch->verticalCounts[row];
+            for (int column = 0; column < pattern->columns; ++column)
+            {
+                const int64_t columnsEven = cellsPerTexel > 1 ? cellsPerTexel / 2 : (column & 1) == 0;
+                const int64_t columnsOdd = cellsPerTexel - columnsEven;
+                const int64_t horizontal = scratch->horizontalCounts[column];
+                const int64_t stitches = horizontal * rowsOdd + (cellsPerTexel - horizontal) * rowsEven
+                    + vertical * columnsOdd + (cellsPerTexel - vertical) * columnsEven;
+                pixels[column] = LerpColor(WHITE, BLACK, stitches * invCells * 0.5f);
+            }
+        }
+    }
+}
+
+void LodUpdate(LodRenderer* lod, const LodPattern* pattern)
+{
+    if (pattern->columns <= 0 || pattern->rows <= 0)
+    {
+        return;
+    }
+
+    const LodScratch scratch = AllocateScratch(&lod->scratch, pattern);
+    PackColumns(&scratch, pattern);
+    TallyRows(&scratch, pattern);
+    ShadeTexels(&scratch, pattern);
+
+    if (lod->texture.id == 0 || lod->texture.width != pattern->columns || lod->texture.height != pattern->rows)
+    {
+        UnloadTexture(lod->texture);
+        const Image image = {
+            .data = scratch.pixels,
+            .width = pattern->columns,
+            .height = pattern->rows,
+            .mipmaps = 1,
+            .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8,
+        };
+        lod->texture = LoadTextureFromImage(image);
+    }
+    else
+    {
+        UpdateTexture(lod->texture, scratch.pixels);
+    }
+}
+
+void LodDraw(const LodRenderer* lod, int cellSize)
+{
+    DrawTextureEx(lod->texture, (Vector2){ 0.0f, 0.0f }, 0.0f, (float)cellSize, WHITE);
+}
+
+void LodUnload(LodRenderer* lod)
+{
+    UnloadTexture(lod->texture);
+    ArenaRelease(&lod->scratch);
+    lod->texture = (Texture2D){ 0 };
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "stdbool.h"
+
+#include "raylib.h"
+#include "arena.h"
+
+// Zoomed out rendering, below LOD_MIN_PRIMITIVE_CELL_SIZE or when several cells share a pixel the
+// pattern is reduced to a coverage texture instead of one primitive per stitch or cell
+#define LOD_MIN_PRIMITIVE_CELL_SIZE 2
+#define LOD_MAX_SHIFT 10
+
+typedef struct LodPattern_t
+{
+    const bool* horizontalSequence;
+    int gridWidth;
+    const bool* verticalSequence;
+    int gridHeight;
+
+    int shift; // Every texel covers (1 << shift) x (1 << shift) cells
+    int columns;
+    int rows;
+    bool colored;
+    int originIsland; // Island of cell (0, 0), 2 or 4
+} LodPattern;
+
+typedef struct LodRenderer_t
+{
+    Arena scratch;
+    Texture2D texture;
+} LodRenderer;
+
+void LodUpdate(LodRenderer* lod, const LodPattern* pattern);
+void LodDraw(const LodRenderer* lod, int cellSize);
+void LodUnload(LodRenderer* lod);
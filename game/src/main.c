@@ -1,255 +1,1970 @@
+#include "limits.h"
+#include "stddef.h"
 #include "stdint.h"
+#include "stdio.h"
 #include "stdlib.h"
+#include "string.h"
 #include "math.h"
 #include "assert.h"
 
 #include "raylib.h"
+#include "rlgl.h"
 #define RAYGUI_IMPLEMENTATION
 #include "raygui.h"
 
+#include "arena.h"
+#include "bits.h"
+#include "cluster.h"
+#include "dither.h"
+#include "gallery.h"
+#include "gamealloc.h"
+#include "generator.h"
+#include "harness.h"
+#include "islandmap.h"
+#include "islandstore.h"
+#include "lod.h"
+#include "patternfile.h"
+#include "patterngif.h"
+#include "profiler.h"
+#include "regions.h"
+#include "replay.h"
+#include "stats.h"
+#include "tileserver.h"
+#include "timeline.h"
+#include "trace.h"
+
 // TODO: add emscripten back
 
-typedef enum
-{
-    UPDATE_REGENERATE,
-    UPDATE_SHIFT,
-    UPDATE_SCROLL,
-} UpdateType;
+typedef enum
+{
+    UPDATE_REGENERATE,
+    UPDATE_SHIFT,
+    UPDATE_SCROLL,
+} UpdateType;
+
+typedef enum
+{
+    CLUSTER_NONE,
+    CLUSTER_COORDINATOR, // Runs the pattern and shows the top-left slice of the wall
+    CLUSTER_NODE,        // Shows the slice at its viewport, driven only by the coordinator
+} ClusterRole;
+
+// Everything the control panel shows, the cached panel is redrawn when any of it changes
+typedef struct UIPanelKey_t
+{
+    int windowWidth;
+    int windowHeight;
+    int cellSize;
+    int lodShift;
+    float horizontalProbability;
+    float verticalProbability;
+    float updateSpeed;
+    int updateType;
+    uint64_t timelineStep;
+    uint64_t timelineStepCount;
+    bool colored;
+    bool showRegions;
+    bool galleryOpen;
+    bool showFPS;
+    bool showProfiler;
+    bool disabled;
+} UIPanelKey;
+
+// Stitch parity between a node's first column or row and the global one, see StitchParity
+typedef struct ClusterParity_t
+{
+    bool valid;
+    uint64_t seed;
+    float probability;
+    int64_t offset;
+    int64_t origin;
+    bool parity;
+} ClusterParity;
+
+typedef struct AppState_t
+{
+    int windowWidth;
+    int windowHeight;
+
+    float verticalProbability;
+    float horizontalProbability;
+
+    // Stitch i of a sequence is GeneratorStitch(seed, axis, i - origin) ^ flipped, scrolling moves the
+    // origin and flips the other sequence, so the pattern is always reproducible from these fields
+    int generator; // GeneratorId, GENERATOR_NONE when the sequences were loaded from a file that has none
+    uint64_t seed;
+    int64_t horizontalOrigin;
+    int64_t verticalOrigin;
+    bool horizontalFlipped;
+    bool verticalFlipped;
+
+    int cellSize;
+    int lodShift; // Zoom out, every texel of the LOD texture covers (1 << lodShift)^2 cells
+    int gridWidth;
+    int gridHeight;
+    bool* verticalSequence;
+    bool* horizontalSequence;
+    IslandMap islands; // Only kept for primitive rendering, see IsLodActive
+    uint64_t* islandPrefix; // Scratch of IslandMapFill, a bit per column
+
+    // All pattern buffers live in one arena that only ever grows, regeneration overwrites in place
+    Arena patternArena;
+    int horizontalCapacity;
+    int verticalCapacity;
+    size_t islandsCapacity; // Words
+
+    // Derived state is rebuilt lazily, every cache keeps the generation of the inputs it was built from
+    uint64_t sequenceGeneration; // Bumped whenever a stitch changes
+    uint64_t patternGeneration;  // Bumped with the stitches, the coloring and the origin island
+    uint64_t islandsGeneration;  // patternGeneration the island map was filled for
+    LodRenderer lod;
+    uint64_t lodGeneration;
+    int lodTextureShift;
+    RegionLabels regions;
+    uint64_t regionsGeneration; // sequenceGeneration the labels were computed for
+    bool showRegions;
+
+    int old00Island;
+
+    double lastUpdateTime;
+    float updateSpeed; // How many time per second to update
+    int updateType;
+    bool updateTypeEditMode;
+    bool showFPS;
+    bool showProfiler;
+    bool colored;
+
+    // The panel is drawn into its own texture while the mouse is away from it, and only redrawn when what it shows changes
+    RenderTexture2D panelTexture;
+    UIPanelKey panelKey;
+    bool panelCached;
+
+    int diagonalScrollDirection;
+
+    // Scroll history since the pattern was last replaced, scrubbing seeks into it and the next update drops the steps after it
+    Timeline timeline;
+    uint64_t timelineStep;
+
+    double traceStopTime; // Auto stop time of a trace capture started from the command line, 0 if none
+    int traceCaptureCounter;
+
+    PatternGif patternGif;
+    uint64_t patternGifGeneration; // patternGeneration of the last recorded frame
+    bool patternGifRecording;
+    int patternGifCounter;
+
+    int patternFileCounter;
+
+    uint64_t frameIndex;
+    bool frameAllocates; // Set by actions that allocate on purpose, debug builds check the other frames don't
+    ReplayWriter replayWriter;
+    bool replayRecording;
+    uint64_t replayStartFrame;
+    int replayCounter;
+    ReplayReader replayReader;
+    bool replaying;
+    double replayFrame;   // Position in the log, advances by replaySpeed every frame
+    float replaySpeed;
+    ReplayEvent replayNext;
+    bool replayHasNext;
+
+    Gallery gallery;
+    bool galleryOpen;
+    int gallerySide; // Thumbnails per row and column
+
+    int clusterRole; // ClusterRole
+    ClusterSocket cluster;
+    int clusterViewportX; // Pixel offset of a node's slice on the wall
+    int clusterViewportY;
+    uint64_t clusterTick;
+    ClusterMessage clusterLast;
+    bool clusterHasState;
+    ClusterParity clusterColumnParity;
+    ClusterParity clusterRowParity;
+
+    // Input recorded from launch for the performance harness, or the harness replaying such a recording
+    AutomationEventList inputEvents;
+    bool inputRecording;
+    const char* inputFileName;
+    Harness harness;
+    bool harnessing;
+} AppState;
+
+typedef struct UIUpdateResult_t
+{
+	int renderAreaWidth;
+    bool shouldRegenerate;
+} UIUpdateResult;
+
+static void UpdateDrawFrame(AppState* state);
+static bool StartReplay(AppState* state, const char* fileName);
+static void StopReplayRecording(AppState* state);
+static bool ReplayToGif(AppState* state, const char* replayFileName, const char* gifFileName, int pixelsPerCell);
+static UIUpdateResult UpdateDrawUI(AppState* state); // Returns the x coordinate of the beginning of the UI blockhorizontalSequence
+static UIUpdateResult UpdateDrawPanel(AppState* state);
+static int GrowCapacity(int capacity, int required)
+{
+    const int grown = capacity + capacity / 2;
+    return grown > required ? grown : required;
+}
+
+// Zoomed out patterns are drawn from the sequences alone, the island map is only kept for primitive rendering
+static bool IsLodZoom(int cellSize, int lodShift)
+{
+    return lodShift > 0 || cellSize < LOD_MIN_PRIMITIVE_CELL_SIZE;
+}
+
+static bool IsLodActive(const AppState* state)
+{
+    return IsLodZoom(state->cellSize, state->lodShift);
+}
+
+// Pattern files and replay logs come from outside, their sizes are clamped to what the UI allows
+static int ClampCellSize(int64_t cellSize)
+{
+    return cellSize < 1 ? 1 : (cellSize > 60 ? 60 : (int)cellSize);
+}
+
+static int ClampLodShift(int64_t lodShift)
+{
+    return lodShift < 0 ? 0 : (lodShift > LOD_MAX_SHIFT ? LOD_MAX_SHIFT : (int)lodShift);
+}
+
+// Makes sure the pattern arena can hold a grid of the given size, existing contents are kept
+static void EnsurePatternCapacity(AppState* state, int gridWidth, int gridHeight, size_t islandWords)
+{
+    if (gridWidth <= state->horizontalCapacity && gridHeight <= state->verticalCapacity && islandWords <= state->islandsCapacity)
+    {
+        return;
+    }
+
+    const int horizontalCapacity = GrowCapacity(state->horizontalCapacity, gridWidth);
+    const int verticalCapacity = GrowCapacity(state->verticalCapacity, gridHeight);
+    const size_t grownIslandsCapacity = state->islandsCapacity + state->islandsCapacity / 2;
+    const size_t islandsCapacity = islandWords <= state->islandsCapacity ? state->islandsCapacity
+        : (grownIslandsCapacity > islandWords ? grownIslandsCapacity : islandWords);
+    const size_t alignment = 64;
+    const size_t prefixWords = BitWordCount((size_t)horizontalCapacity);
+    const size_t arenaSize = islandsCapacity * sizeof(uint64_t) + horizontalCapacity + verticalCapacity + prefixWords * sizeof(uint64_t) + 4 * alignment;
+
+    Arena arena;
+    const bool arenaCreated = ArenaInit(&arena, arenaSize);
+    assert(arenaCreated);
+    (void)arenaCreated;
+    uint64_t* islands = (uint64_t*)ArenaPush(&arena, islandsCapacity * sizeof(uint64_t), alignment);
+    bool* horizontalSequence = (bool*)ArenaPush(&arena, horizontalCapacity * sizeof(bool), alignment);
+    bool* verticalSequence = (bool*)ArenaPush(&arena, verticalCapacity * sizeof(bool), alignment);
+    uint64_t* islandPrefix = (uint64_t*)ArenaPush(&arena, prefixWords * sizeof(uint64_t), alignment);
+
+    if (state->patternArena.base != NULL)
+    {
+        memcpy(islands, state->islands.tiles, state->islandsCapacity * sizeof(uint64_t));
+        memcpy(horizontalSequence, state->horizontalSequence, state->horizontalCapacity * sizeof(bool));
+        memcpy(verticalSequence, state->verticalSequence, state->verticalCapacity * sizeof(bool));
+        ArenaRelease(&state->patternArena);
+    }
+
+    state->patternArena = arena;
+    state->islands.tiles = islands;
+    state->horizontalSequence = horizontalSequence;
+    state->verticalSequence = verticalSequence;
+    state->islandPrefix = islandPrefix;
+    state->horizontalCapacity = horizontalCapacity;
+    state->verticalCapacity = verticalCapacity;
+    state->islandsCapacity = islandsCapacity;
+}
+
+static bool HorizontalStitch(const AppState* state, int64_t i)
+{
+    return GeneratorStitch(state->seed, SEQUENCE_HORIZONTAL, i - state->horizontalOrigin, state->horizontalProbability) ^ state->horizontalFlipped;
+}
+
+static bool VerticalStitch(const AppState* state, int64_t i)
+{
+    return GeneratorStitch(state->seed, SEQUENCE_VERTICAL, i - state->verticalOrigin, state->verticalProbability) ^ state->verticalFlipped;
+}
+
+// The harness runs on a fixed timestep, so timed updates land on the same frames on every run
+static double GetAppTime(const AppState* state)
+{
+    return state->harnessing ? HarnessTime(&state->harness) : GetTime();
+}
+
+// Any change that is not a scroll step starts a new history
+static void ResetTimeline(AppState* state)
+{
+    TimelineRelease(&state->timeline);
+    state->timelineStep = 0;
+}
+
+// Grid that fills the window at the current cell size and zoom
+static void FitGridToWindow(AppState* state, int* gridWidth, int* gridHeight)
+{
+    state->windowWidth = GetRenderWidth();
+    state->windowHeight = GetRenderHeight();
+    *gridWidth = (state->windowWidth / state->cellSize) << state->lodShift;
+    *gridHeight = (state->windowHeight / state->cellSize) << state->lodShift;
+}
+
+static void MarkSequencesChanged(AppState* state)
+{
+    state->sequenceGeneration++;
+    state->patternGeneration++;
+}
+
+// Coloring starts with cell (0, 0) red, the island map follows the next time it is needed
+static void MarkColoringChanged(AppState* state)
+{
+    if (state->colored && state->old00Island == 0)
+    {
+        state->old00Island = 2;
+    }
+    state->patternGeneration++;
+}
+
+static bool AreIslandsCurrent(const AppState* state)
+{
+    return state->islandsGeneration == state->patternGeneration;
+}
+
+static void RegenerateSequences(AppState* state, int gridWidth, int gridHeight)
+{
+    TRACE_BEGIN("RegenerateSequences");
+    ResetTimeline(state);
+    state->gridWidth = gridWidth;
+    state->gridHeight = gridHeight;
+    const bool withIslands = !IsLodActive(state);
+    EnsurePatternCapacity(state, state->gridWidth, state->gridHeight, withIslands ? IslandMapWordCount(state->gridWidth, state->gridHeight) : 0);
+
+    state->generator = GENERATOR_SPLITMIX64;
+    state->seed = SplitMix64(state->seed);
+    state->horizontalOrigin = 0;
+    state->verticalOrigin = 0;
+    state->horizontalFlipped = false;
+    state->verticalFlipped = false;
+	for (int i = 0; i < state->gridWidth; ++i)
+	{
+		state->horizontalSequence[i] = HorizontalStitch(state, i);
+	}
+
+    for (int i = 0; i < state->gridHeight; ++i)
+    {
+        state->verticalSequence[i] = VerticalStitch(state, i);
+    }
+    MarkSequencesChanged(state);
+    TRACE_END("RegenerateSequences");
+}
+
+// Fills the island map if the pattern changed since it was last filled, the LOD texture never reads it
+static void EnsureIslands(AppState* state)
+{
+    if (IsLodActive(state) || AreIslandsCurrent(state))
+    {
+        return;
+    }
+
+    PROFILE_BEGIN(PROFILE_PHASE_FILL);
+    TRACE_BEGIN("FillIslands");
+    EnsurePatternCapacity(state, state->gridWidth, state->gridHeight, IslandMapWordCount(state->gridWidth, state->gridHeight));
+    IslandMapInit(&state->islands, state->islands.tiles, state->gridWidth, state->gridHeight);
+    const int originIsland = state->old00Island != 0 ? state->old00Island : 2;
+    IslandMapFill(&state->islands, state->horizontalSequence, state->verticalSequence, state->islandPrefix, originIsland, NULL, NULL);
+    state->islandsGeneration = state->patternGeneration;
+    TRACE_END("FillIslands");
+    PROFILE_END(PROFILE_PHASE_FILL);
+}
+
+// Keeps the stitches that remain visible and only generates the newly exposed rows and columns, the island
+// map is filled again from the origin the next time it is needed, which costs a word per 64 cells
+static void ResizeSequences(AppState* state, int newWidth, int newHeight)
+{
+    TRACE_BEGIN("ResizeSequences");
+    ResetTimeline(state);
+    const int oldWidth = state->gridWidth;
+    const int oldHeight = state->gridHeight;
+    const bool withIslands = !IsLodActive(state);
+    EnsurePatternCapacity(state, newWidth, newHeight, withIslands ? IslandMapWordCount(newWidth, newHeight) : 0);
+
+    for (int i = oldWidth; i < newWidth; ++i)
+    {
+        state->horizontalSequence[i] = HorizontalStitch(state, i);
+    }
+    for (int i = oldHeight; i < newHeight; ++i)
+    {
+        state->verticalSequence[i] = VerticalStitch(state, i);
+    }
+
+    state->gridWidth = newWidth;
+    state->gridHeight = newHeight;
+    MarkSequencesChanged(state);
+    TRACE_END("ResizeSequences");
+}
+
+static void GenericScroll(bool* primarySequence, int primaryLength, bool newStitch, bool* secondarySequence, int secondaryLength)
+{
+    for (int i = 1; i < primaryLength; ++i)
+    {
+        primarySequence[primaryLength - i] = primarySequence[primaryLength - 1 - i];
+    }
+    primarySequence[0] = newStitch;
+
+    for (int i = 0; i < secondaryLength; ++i)
+    {
+        secondarySequence[i] = !secondarySequence[i];
+    }
+}
+
+static void ScrollHorizontal(AppState* state)
+{
+    state->horizontalOrigin++;
+    state->verticalFlipped = !state->verticalFlipped;
+    GenericScroll(state->horizontalSequence, state->gridWidth, HorizontalStitch(state, 0), state->verticalSequence, state->gridHeight);
+}
+
+static void ScrollVertical(AppState* state)
+{
+    state->verticalOrigin++;
+    state->horizontalFlipped = !state->horizontalFlipped;
+    GenericScroll(state->verticalSequence, state->gridHeight, VerticalStitch(state, 0), state->horizontalSequence, state->gridWidth);
+}
+
+static void Scroll(AppState* state)
+{
+    TRACE_BEGIN("Scroll");
+    MarkSequencesChanged(state);
+    ScrollHorizontal(state);
+    TRACE_END("Scroll");
+}
+
+static void DiagonalScroll(AppState* state)
+{
+    TRACE_BEGIN("DiagonalScroll");
+    MarkSequencesChanged(state);
+	if (state->diagonalScrollDirection == 0)
+	{
+		ScrollHorizontal(state);
+	}
+	else
+	{
+		ScrollVertical(state);
+	}
+    state->diagonalScrollDirection = !state->diagonalScrollDirection;
+    TRACE_END("DiagonalScroll");
+}
+
+static bool BeginTimeline(AppState* state)
+{
+    const TimelinePattern pattern = {
+        .horizontalSequence = state->horizontalSequence,
+        .gridWidth = state->gridWidth,
+        .verticalSequence = state->verticalSequence,
+        .gridHeight = state->gridHeight,
+        .seed = state->seed,
+        .horizontalProbability = state->horizontalProbability,
+        .verticalProbability = state->verticalProbability,
+        .colored = state->colored,
+        .diagonal = state->updateType == UPDATE_SHIFT,
+        .state = {
+            .horizontalOrigin = state->horizontalOrigin,
+            .verticalOrigin = state->verticalOrigin,
+            .horizontalFlipped = state->horizontalFlipped,
+            .verticalFlipped = state->verticalFlipped,
+            .diagonalScrollDirection = state->diagonalScrollDirection,
+            .originIsland = state->old00Island,
+        },
+    };
+    state->timelineStep = 0;
+    state->frameAllocates = true;
+    return TimelineBegin(&state->timeline, &pattern);
+}
+
+// Steps after the shown one are dropped, the pattern continues from where the timeline was scrubbed to
+static bool PrepareTimelineStep(AppState* state)
+{
+    if (state->timeline.axisBits == NULL)
+    {
+        return BeginTimeline(state);
+    }
+    TimelineTruncate(&state->timeline, state->timelineStep);
+    return true;
+}
+
+// Extends the timeline without touching the pattern, a shift update alternates the scrolled axis
+static void ExtendTimeline(AppState* state, uint64_t stepCount)
+{
+    if (!PrepareTimelineStep(state))
+    {
+        return;
+    }
+
+    Timeline* timeline = &state->timeline;
+    for (uint64_t i = 0; i < stepCount; ++i)
+    {
+        const int direction = timeline->diagonal ? timeline->start.diagonalScrollDirection ^ (int)(timeline->stepCount & 1) : 0;
+        if (!TimelineAppend(timeline, direction == 0 ? SEQUENCE_HORIZONTAL : SEQUENCE_VERTICAL))
+        {
+            break;
+        }
+    }
+}
+
+static void SeekTimeline(AppState* state, uint64_t step)
+{
+    if (state->timeline.axisBits == NULL)
+    {
+        return;
+    }
+
+    TRACE_BEGIN("SeekTimeline");
+    StopReplayRecording(state); // The log can't describe a jump through the timeline
+    const TimelineState seeked = TimelineSeek(&state->timeline, step, state->horizontalSequence, state->verticalSequence);
+    state->timelineStep = step < state->timeline.stepCount ? step : state->timeline.stepCount;
+    state->horizontalOrigin = seeked.horizontalOrigin;
+    state->verticalOrigin = seeked.verticalOrigin;
+    state->horizontalFlipped = seeked.horizontalFlipped;
+    state->verticalFlipped = seeked.verticalFlipped;
+    state->diagonalScrollDirection = seeked.diagonalScrollDirection;
+    state->old00Island = seeked.originIsland;
+    MarkSequencesChanged(state);
+    TRACE_END("SeekTimeline");
+}
+
+#define PATTERN_MAX_ISLAND_WORDS ((size_t)1 << 27) // 1 GiB of island tiles
+
+// Replaces the pattern with the one stored in the file and pauses updates so it stays on screen
+static bool LoadPatternFile(AppState* state, const char* fileName)
+{
+    PatternFile file;
+    if (!PatternFileOpen(&file, fileName))
+    {
+        TraceLog(LOG_WARNING, "PATTERN: Failed to open %s", fileName);
+        return false;
+    }
+
+    // Sides are bounded like a replay's, and a grid shown without LOD also needs its island map in the pattern arena
+    const PatternFileHeader* header = file.header;
+    const int cellSize = ClampCellSize(header->cellSize);
+    const int lodShift = ClampLodShift(header->lodShift);
+    if (header->gridWidth == 0 || header->gridHeight == 0 || header->gridWidth > REPLAY_MAX_GRID_SIDE || header->gridHeight > REPLAY_MAX_GRID_SIDE
+        || (!IsLodZoom(cellSize, lodShift) && IslandMapWordCount((int64_t)header->gridWidth, (int64_t)header->gridHeight) > PATTERN_MAX_ISLAND_WORDS))
+    {
+        TraceLog(LOG_WARNING, "PATTERN: %s is too large to load", fileName);
+        PatternFileClose(&file);
+        return false;
+    }
+
+    StopReplayRecording(state); // The log can't describe a pattern replaced from outside
+    state->horizontalProbability = header->horizontalProbability;
+    state->verticalProbability = header->verticalProbability;
+    state->cellSize = cellSize;
+    state->lodShift = lodShift;
+    state->generator = (int)header->generator;
+    state->seed = header->seed;
+    state->horizontalOrigin = header->horizontalOrigin;
+    state->verticalOrigin = header->verticalOrigin;
+    state->horizontalFlipped = header->horizontalFlipped != 0;
+    state->verticalFlipped = header->verticalFlipped != 0;
+    state->colored = header->colored != 0;
+    state->gridWidth = (int)header->gridWidth;
+    state->gridHeight = (int)header->gridHeight;
+
+    const bool withIslands = !IsLodActive(state);
+    EnsurePatternCapacity(state, state->gridWidth, state->gridHeight, withIslands ? IslandMapWordCount(state->gridWidth, state->gridHeight) : 0);
+    for (int i = 0; i < state->gridWidth; ++i)
+    {
+        state->horizontalSequence[i] = BitGet(file.horizontalBits, i);
+    }
+    for (int i = 0; i < state->gridHeight; ++i)
+    {
+        state->verticalSequence[i] = BitGet(file.verticalBits, i);
+    }
+
+    state->old00Island = state->colored ? (header->originRed ? 2 : 4) : 0;
+    MarkSequencesChanged(state);
+    if (withIslands && state->colored && file.islandBits != NULL)
+    {
+        IslandMapInit(&state->islands, state->islands.tiles, state->gridWidth, state->gridHeight);
+        for (int y = 0; y < state->gridHeight; ++y)
+        {
+            IslandMapWriteRow(&state->islands, y, file.islandBits + (size_t)y * header->islandsRowWords);
+        }
+        state->islandsGeneration = state->patternGeneration;
+    }
+
+    PatternFileClose(&file);
+    ResetTimeline(state);
+    state->updateSpeed = 0.0f;
+    TraceLog(LOG_INFO, "PATTERN: Loaded %dx%d pattern from %s", state->gridWidth, state->gridHeight, fileName);
+    return true;
+}
+
+static void ReadIslandMapRow(void* context, uint64_t y, uint64_t* bits)
+{
+    IslandMapReadRow((const IslandMap*)context, (int64_t)y, bits);
+}
+
+static void ReadIslandStoreRow(void* context, uint64_t y, uint64_t* bits)
+{
+    IslandStoreReadRow((IslandStore*)context, (int64_t)y, bits);
+}
+
+// Zoomed out grids keep no island map, their island plane is two-colored into a tiled scratch file next to
+// the pattern file and streamed from there, so it doesn't have to fit in memory
+static bool SavePatternFileOutOfCore(AppState* state, const char* fileName, const PatternFileHeader* parameters)
+{
+    TRACE_BEGIN("SavePatternFileOutOfCore");
+    IslandStore store;
+    const bool saved = IslandStoreCreate(&store, TextFormat("%s.islands", fileName), state->gridWidth, state->gridHeight)
+        && IslandStoreFill(&store, state->horizontalSequence, state->verticalSequence, state->old00Island)
+        && PatternFileSave(fileName, parameters, state->horizontalSequence, state->verticalSequence, ReadIslandStoreRow, &store);
+    IslandStoreClose(&store);
+    TRACE_END("SavePatternFileOutOfCore");
+    return saved;
+}
+
+static void SavePatternFile(AppState* state)
+{
+    if (state->colored)
+    {
+        EnsureIslands(state);
+    }
+
+    const PatternFileHeader parameters = {
+        .generator = (uint32_t)state->generator,
+        .seed = state->seed,
+        .horizontalOrigin = state->horizontalOrigin,
+        .verticalOrigin = state->verticalOrigin,
+        .gridWidth = (uint64_t)state->gridWidth,
+        .gridHeight = (uint64_t)state->gridHeight,
+        .horizontalProbability = state->horizontalProbability,
+        .verticalProbability = state->verticalProbability,
+        .cellSize = state->cellSize,
+        .lodShift = state->lodShift,
+        .horizontalFlipped = state->horizontalFlipped,
+        .verticalFlipped = state->verticalFlipped,
+        .colored = state->colored,
+        .originRed = state->old00Island != 4,
+    };
+    const bool withIslands = state->colored && state->old00Island != 0;
+    const bool inMemory = withIslands && !IsLodActive(state) && AreIslandsCurrent(state);
+    const bool outOfCore = withIslands && IsLodActive(state) && (uint64_t)state->gridWidth * state->gridHeight <= ISLAND_STORE_MAX_CELLS;
+
+    const char* fileName = TextFormat("hitomezashi_%03d" PATTERN_FILE_EXTENSION, state->patternFileCounter++);
+    const bool saved = outOfCore ? SavePatternFileOutOfCore(state, fileName, &parameters)
+        : PatternFileSave(fileName, &parameters, state->horizontalSequence, state->verticalSequence, inMemory ? ReadIslandMapRow : NULL, &state->islands);
+    if (saved)
+    {
+        TraceLog(LOG_INFO, "PATTERN: Saved to %s", fileName);
+    }
+    else
+    {
+        TraceLog(LOG_WARNING, "PATTERN: Failed to save %s", fileName);
+    }
+}
+
+// CTRL+S saves the current pattern, dropping a pattern file on the window loads it
+static void UpdatePatternFiles(AppState* state)
+{
+    if (IsKeyPressed(KEY_S) && (IsKeyDown(KEY_LEFT_CONTROL) || IsKeyDown(KEY_RIGHT_CONTROL)))
+    {
+        SavePatternFile(state);
+    }
+
+    if (IsFileDropped())
+    {
+        FilePathList droppedFiles = LoadDroppedFiles();
+        for (unsigned int i = 0; i < droppedFiles.count; ++i)
+        {
+            if (IsFileExtension(droppedFiles.paths[i], PATTERN_FILE_EXTENSION))
+            {
+                LoadPatternFile(state, droppedFiles.paths[i]);
+                break;
+            }
+        }
+        UnloadDroppedFiles(droppedFiles);
+    }
+}
+
+// Records raylib automation events from the first frame, the harness replays them with --harness.
+// Event frames are counted from the recording start, which is also where frameIndex starts.
+static bool StartInputRecording(AppState* state, const char* fileName)
+{
+    state->inputEvents = LoadAutomationEventList(NULL);
+    if (state->inputEvents.events == NULL)
+    {
+        return false;
+    }
+    SetAutomationEventList(&state->inputEvents);
+    SetAutomationEventBaseFrame(0);
+    StartAutomationEventRecording();
+    state->inputRecording = true;
+    state->inputFileName = fileName;
+    TraceLog(LOG_INFO, "HARNESS: Recording input to %s", fileName);
+    return true;
+}
+
+static void StopInputRecording(AppState* state)
+{
+    if (!state->inputRecording)
+    {
+        return;
+    }
+    StopAutomationEventRecording();
+    state->inputRecording = false;
+
+    // The closing event marks the last recorded frame, so the replay runs exactly as long as the recording
+    if (state->inputEvents.count < state->inputEvents.capacity && state->frameIndex > 0)
+    {
+        state->inputEvents.events[state->inputEvents.count++] = (AutomationEvent){ .frame = (unsigned int)(state->frameIndex - 1), .type = HARNESS_EVENT_WINDOW_CLOSE };
+    }
+    if (ExportAutomationEventList(state->inputEvents, state->inputFileName))
+    {
+        TraceLog(LOG_INFO, "HARNESS: %u input events over %llu frames written to %s", state->inputEvents.count,
+            (unsigned long long)state->frameIndex, state->inputFileName);
+    }
+    else
+    {
+        TraceLog(LOG_WARNING, "HARNESS: Failed to write %s", state->inputFileName);
+    }
+    UnloadAutomationEventList(state->inputEvents);
+}
+
+int main(int argc, char** argv)
+{
+    srand(1023);
+    const char* replayFileName = NULL;
+    const char* replayGifFileName = NULL;
+    int replayGifPixelsPerCell = 2;
+    uint64_t timelineSteps = 0;
+    const char* recordInputFileName = NULL;
+    HarnessConfig harness = { .checkpointInterval = HARNESS_CHECKPOINT_INTERVAL, .tolerance = 0.1f };
+    bool seedGiven = false;
+    const char* clusterAddress = NULL;
+    const char* clusterInterface = NULL;
+    TileServerConfig tileServer = { .cacheBytes = (size_t)256 << 20 };
+    TileBenchmarkConfig tileBenchmark = { .connectionCount = 64, .seconds = 10.0, .tileCount = 4096 };
+    StatsConfig stats = { .gridPoints = 11, .samplesPerPoint = 1000, .width = 128, .height = 128, .seed = 1 };
+    IslandBenchmarkConfig islandBenchmark = { .repeats = 3, .seed = 1 };
+    DitherConfig dither = { .cellPixels = 4, .maxPasses = 16 };
+    AppState appState = {
+        .windowWidth = 640,
+        .windowHeight = 480,
+        .verticalProbability = 0.5f,
+        .horizontalProbability = 0.5f,
+        .cellSize = 20,
+        .lodShift = 0,
+        .gridWidth = 0,
+        .gridHeight = 0,
+        .horizontalSequence = NULL,
+        .verticalSequence = NULL,
+        .islands = { 0 },
+        .patternArena = { 0 },
+        .sequenceGeneration = 1,
+        .patternGeneration = 1,
+        .old00Island = 0,
+        .lastUpdateTime = 0.0,
+        .updateSpeed = 10.0,
+        .updateType = UPDATE_REGENERATE,
+        .updateTypeEditMode = false,
+        .colored = false,
+        .diagonalScrollDirection = 0,
+        .replaySpeed = 1.0f,
+        .gallerySide = 8,
+    };
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+        {
+            replayFileName = argv[++i];
+        }
+        else if (strcmp(argv[i], "--replay-speed") == 0 && i + 1 < argc)
+        {
+            appState.replaySpeed = (float)atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--replay-gif") == 0 && i + 1 < argc)
+        {
+            replayGifFileName = argv[++i];
+        }
+        else if (strcmp(argv[i], "--gif-cell-pixels") == 0 && i + 1 < argc)
+        {
+            replayGifPixelsPerCell = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--tile-server") == 0 && i + 1 < argc)
+        {
+            tileServer.address = argv[++i];
+        }
+        else if (strcmp(argv[i], "--tile-workers") == 0 && i + 1 < argc)
+        {
+            tileServer.workerCount = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--tile-cache-mb") == 0 && i + 1 < argc)
+        {
+            tileServer.cacheBytes = (size_t)strtoull(argv[++i], NULL, 10) << 20;
+        }
+        else if (strcmp(argv[i], "--tile-bench") == 0 && i + 1 < argc)
+        {
+            tileBenchmark.address = argv[++i];
+        }
+        else if (strcmp(argv[i], "--bench-connections") == 0 && i + 1 < argc)
+        {
+            tileBenchmark.connectionCount = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--bench-seconds") == 0 && i + 1 < argc)
+        {
+            tileBenchmark.seconds = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--bench-tiles") == 0 && i + 1 < argc)
+        {
+            tileBenchmark.tileCount = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--stats") == 0 && i + 1 < argc)
+        {
+            stats.fileName = argv[++i];
+        }
+        else if (strcmp(argv[i], "--stats-grid") == 0 && i + 1 < argc)
+        {
+            stats.gridPoints = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--stats-samples") == 0 && i + 1 < argc)
+        {
+            stats.samplesPerPoint = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--stats-size") == 0 && i + 1 < argc)
+        {
+            const char* size = argv[++i];
+            if (sscanf(size, "%dx%d", &stats.width, &stats.height) != 2)
+            {
+                stats.width = stats.height = atoi(size);
+            }
+        }
+        else if (strcmp(argv[i], "--stats-seed") == 0 && i + 1 < argc)
+        {
+            stats.seed = strtoull(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argv[i], "--stats-threads") == 0 && i + 1 < argc)
+        {
+            stats.threadCount = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--island-bench") == 0 && i + 1 < argc)
+        {
+            const char* size = argv[++i];
+            long long width, height;
+            if (sscanf(size, "%lldx%lld", &width, &height) != 2)
+            {
+                width = height = atoll(size);
+            }
+            islandBenchmark.width = width;
+            islandBenchmark.height = height;
+        }
+        else if (strcmp(argv[i], "--island-bench-repeats") == 0 && i + 1 < argc)
+        {
+            islandBenchmark.repeats = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--dither") == 0 && i + 1 < argc)
+        {
+            dither.inputFileName = argv[++i];
+        }
+        else if (strcmp(argv[i], "--dither-out") == 0 && i + 1 < argc)
+        {
+            dither.outputFileName = argv[++i];
+        }
+        else if (strcmp(argv[i], "--dither-pattern") == 0 && i + 1 < argc)
+        {
+            dither.patternFileName = argv[++i];
+        }
+        else if (strcmp(argv[i], "--dither-cell") == 0 && i + 1 < argc)
+        {
+            dither.cellPixels = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--dither-passes") == 0 && i + 1 < argc)
+        {
+            dither.maxPasses = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--dither-threads") == 0 && i + 1 < argc)
+        {
+            dither.threadCount = atoi(argv[++i]);
+        }
+    }
+
+    // Headless tile serving and its load generator, the address is a UNIX socket path or a loopback TCP port
+    if (tileServer.address != NULL)
+    {
+        return TileServerRun(&tileServer) ? 0 : 1;
+    }
+    if (tileBenchmark.address != NULL)
+    {
+        return TileBenchmarkRun(&tileBenchmark) ? 0 : 1;
+    }
+
+    // Headless Monte Carlo sweep over the probability grid
+    if (stats.fileName != NULL)
+    {
+        return StatsRun(&stats) ? 0 : 1;
+    }
+
+    // Headless comparison of island map layouts
+    if (islandBenchmark.width != 0)
+    {
+        return IslandBenchmarkRun(&islandBenchmark) ? 0 : 1;
+    }
+
+    // Headless image and Y4M video conversion, "-" reads the video from stdin
+    if (dither.inputFileName != NULL)
+    {
+        return DitherRun(&dither) ? 0 : 1;
+    }
+
+    // Headless replay, renders the log straight to a GIF without opening a window
+    if (replayFileName != NULL && replayGifFileName != NULL)
+    {
+        const bool converted = ReplayToGif(&appState, replayFileName, replayGifFileName, replayGifPixelsPerCell);
+        TimelineRelease(&appState.timeline);
+        ArenaRelease(&appState.patternArena);
+        return converted ? 0 : 1;
+    }
+
+    InitWindow(appState.windowWidth, appState.windowHeight, "hitomezashi pattern generator");
+    SetWindowState(FLAG_WINDOW_RESIZABLE);
+    SetWindowMinSize(480, 480);
+    GuiSetStyle(DEFAULT, TEXT_SIZE, 20);
+
+    appState.seed = ((uint64_t)GetRandomValue(0, INT_MAX) << 32) ^ (uint64_t)GetRandomValue(0, INT_MAX);
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--trace-seconds") == 0 && i + 1 < argc)
+        {
+            appState.traceStopTime = GetTime() + atof(argv[++i]);
+            TraceStartCapture();
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            appState.seed = strtoull(argv[++i], NULL, 0);
+            seedGiven = true;
+        }
+        else if (strcmp(argv[i], "--record-input") == 0 && i + 1 < argc)
+        {
+            recordInputFileName = argv[++i];
+        }
+        else if (strcmp(argv[i], "--harness") == 0 && i + 1 < argc)
+        {
+            harness.inputFileName = argv[++i];
+        }
+        else if (strcmp(argv[i], "--harness-report") == 0 && i + 1 < argc)
+        {
+            harness.reportFileName = argv[++i];
+        }
+        else if (strcmp(argv[i], "--harness-baseline") == 0 && i + 1 < argc)
+        {
+            harness.baselineFileName = argv[++i];
+        }
+        else if (strcmp(argv[i], "--harness-checkpoint") == 0 && i + 1 < argc)
+        {
+            harness.checkpointInterval = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--harness-tolerance") == 0 && i + 1 < argc)
+        {
+            harness.tolerance = (float)atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--timeline-steps") == 0 && i + 1 < argc)
+        {
+            timelineSteps = strtoull(argv[++i], NULL, 0);
+        }
+        else if (strcmp(argv[i], "--cluster-coordinator") == 0 && i + 1 < argc)
+        {
+            clusterAddress = argv[++i];
+            appState.clusterRole = CLUSTER_COORDINATOR;
+        }
+        else if (strcmp(argv[i], "--cluster-node") == 0 && i + 1 < argc)
+        {
+            clusterAddress = argv[++i];
+            appState.clusterRole = CLUSTER_NODE;
+        }
+        else if (strcmp(argv[i], "--cluster-viewport") == 0 && i + 1 < argc)
+        {
+            sscanf(argv[++i], "%d,%d", &appState.clusterViewportX, &appState.clusterViewportY);
+        }
+        else if (strcmp(argv[i], "--cluster-interface") == 0 && i + 1 < argc)
+        {
+            clusterInterface = argv[++i];
+        }
+        else if (strcmp(argv[i], "--gallery-size") == 0 && i + 1 < argc)
+        {
+            const int side = atoi(argv[++i]);
+            appState.gallerySide = side < 1 ? 1 : (side > GALLERY_MAX_SIDE ? GALLERY_MAX_SIDE : side);
+        }
+    }
+
+    // Recording and harness start from the same pattern unless a seed is given to both
+    if (!seedGiven && (recordInputFileName != NULL || harness.inputFileName != NULL))
+    {
+        appState.seed = 1;
+    }
+
+    // Display wall, every machine runs one process and the coordinator's multicast group or address list reaches all nodes
+    if (appState.clusterRole != CLUSTER_NONE)
+    {
+        const uint64_t session = ((uint64_t)GetRandomValue(0, INT_MAX) << 32) ^ (uint64_t)GetRandomValue(0, INT_MAX);
+        const bool opened = appState.clusterRole == CLUSTER_COORDINATOR
+            ? ClusterOpenCoordinator(&appState.cluster, clusterAddress, clusterInterface, session)
+            : ClusterOpenNode(&appState.cluster, clusterAddress, clusterInterface);
+        if (opened)
+        {
+            TraceLog(LOG_INFO, "CLUSTER: %s on %s", appState.clusterRole == CLUSTER_COORDINATOR ? "Coordinator" : "Node", clusterAddress);
+        }
+        else
+        {
+            TraceLog(LOG_WARNING, "CLUSTER: Failed to open %s", clusterAddress);
+            appState.clusterRole = CLUSTER_NONE;
+        }
+    }
+
+    SetTargetFPS(60);
+    int gridWidth;
+    int gridHeight;
+    FitGridToWindow(&appState, &gridWidth, &gridHeight);
+    RegenerateSequences(&appState, gridWidth, gridHeight);
+    if (replayFileName != NULL)
+    {
+        StartReplay(&appState, replayFileName);
+    }
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--load") == 0 && i + 1 < argc)
+        {
+            LoadPatternFile(&appState, argv[++i]);
+        }
+    }
+    if (timelineSteps > 0 && !appState.replaying)
+    {
+        // Exhibition mode, a long scroll is laid out ahead and paused at its start for scrubbing
+        if (appState.updateType == UPDATE_REGENERATE)
+        {
+            appState.updateType = UPDATE_SCROLL;
+        }
+        ExtendTimeline(&appState, timelineSteps);
+        appState.updateSpeed = 0.0f;
+    }
+    if (harness.inputFileName != NULL)
+    {
+        harness.seed = appState.seed;
+        appState.harnessing = HarnessBegin(&appState.harness, &harness);
+        if (!appState.harnessing)
+        {
+            CloseWindow();
+            return 1;
+        }
+        SetTargetFPS(0); // Frames run back to back, the virtual timestep drives the updates
+    }
+    else if (recordInputFileName != NULL)
+    {
+        StartInputRecording(&appState, recordInputFileName);
+    }
+    while (!WindowShouldClose() && !(appState.harnessing && HarnessDone(&appState.harness)))
+    {
+        if (appState.harnessing)
+        {
+            HarnessBeginFrame(&appState.harness);
+        }
+        TRACE_BEGIN("Frame");
+        UpdateDrawFrame(&appState);
+        TRACE_END("Frame");
+        if (appState.harnessing)
+        {
+            HarnessEndFrame(&appState.harness);
+        }
+    }
+    const bool harnessPassed = !appState.harnessing || HarnessFinish(&appState.harness);
+
+    if (appState.patternGifRecording)
+    {
+        PatternGifEnd(&appState.patternGif, TextFormat("hitomezashi_%03d.gif", appState.patternGifCounter), GetTime());
+    }
+    StopReplayRecording(&appState);
+    StopInputRecording(&appState);
+    ReplayClose(&appState.replayReader);
+    ClusterClose(&appState.cluster);
+    GalleryUnload(&appState.gallery);
+    RegionRelease(&appState.regions);
+    LodUnload(&appState.lod);
+    UnloadRenderTexture(appState.panelTexture);
+    TimelineRelease(&appState.timeline);
+    ArenaRelease(&appState.patternArena);
+    CloseWindow();
+    return harnessPassed ? 0 : 1;
+}
+
+// Island of cell (0, 0) after an update, keeps the colors stable while the pattern scrolls
+static int NextOriginIsland(const AppState* state)
+{
+    int currentIsland = 2;
+    if (state->old00Island != 0)
+    {
+        switch (state->updateType)
+        {
+        case UPDATE_SCROLL:
+            currentIsland = state->horizontalSequence[1] ? state->old00Island : state->old00Island ^ 6;
+            break;
+        case UPDATE_SHIFT:
+            const bool keep = (state->diagonalScrollDirection == 1 && state->horizontalSequence[1]) || (state->diagonalScrollDirection == 0 && state->verticalSequence[1]);
+            currentIsland = keep ? state->old00Island : state->old00Island ^ 6;
+            break;
+        }
+    }
+    return currentIsland;
+}
+
+// F9 toggles a trace capture, stopping it writes a Chrome Trace Event JSON next to the executable
+static void UpdateTraceCapture(AppState* state)
+{
+    const bool autoStop = state->traceStopTime > 0.0 && GetTime() >= state->traceStopTime;
+    if (!IsKeyPressed(KEY_F9) && !autoStop)
+    {
+        return;
+    }
+
+    state->traceStopTime = 0.0;
+    if (!traceCapturing)
+    {
+        TraceStartCapture();
+        TraceLog(LOG_INFO, "TRACE: Capture started");
+        return;
+    }
+
+    char fileName[64];
+    snprintf(fileName, sizeof(fileName), "hitomezashi_trace_%03d.json", state->traceCaptureCounter++);
+    if (TraceStopCapture(fileName))
+    {
+        TraceLog(LOG_INFO, "TRACE: Capture written to %s", fileName);
+    }
+    else
+    {
+        TraceLog(LOG_WARNING, "TRACE: Failed to write %s", fileName);
+    }
+}
+
+// F10 toggles a GIF recording of the pattern at the on-screen scale, CTRL+F10 at one pixel per cell
+// (two for stitches). Frames come from the sequences, so the UI and overlays are not recorded.
+static void UpdatePatternRecording(AppState* state, int renderAreaWidth)
+{
+    if (IsKeyPressed(KEY_F10))
+    {
+        state->frameAllocates = true;
+        if (state->patternGifRecording)
+        {
+            const char* fileName = TextFormat("hitomezashi_%03d.gif", state->patternGifCounter++);
+            const int frameCount = state->patternGif.frameCount;
+            state->patternGifRecording = false;
+            if (PatternGifEnd(&state->patternGif, fileName, GetTime()))
+            {
+                TraceLog(LOG_INFO, "GIF: %d frames written to %s", frameCount, fileName);
+            }
+            else
+            {
+                TraceLog(LOG_WARNING, "GIF: Failed to write %s", fileName);
+            }
+        }
+        else
+        {
+            const bool compact = IsKeyDown(KEY_LEFT_CONTROL) || IsKeyDown(KEY_RIGHT_CONTROL);
+            const int pixelsPerCell = compact ? (state->colored ? 1 : 2) : state->cellSize;
+            int columns = (renderAreaWidth / state->cellSize) << state->lodShift;
+            int rows = (state->windowHeight / state->cellSize) << state->lodShift;
+            columns = columns < state->gridWidth ? columns : state->gridWidth;
+            rows = rows < state->gridHeight ? rows : state->gridHeight;
+            columns = columns < PATTERN_GIF_MAX_SIDE / pixelsPerCell ? columns : PATTERN_GIF_MAX_SIDE / pixelsPerCell;
+            rows = rows < PATTERN_GIF_MAX_SIDE / pixelsPerCell ? rows : PATTERN_GIF_MAX_SIDE / pixelsPerCell;
+            state->patternGifRecording = PatternGifBegin(&state->patternGif, columns, rows, pixelsPerCell, GetTime());
+            state->patternGifGeneration = 0;
+            if (state->patternGifRecording)
+            {
+                TraceLog(LOG_INFO, "GIF: Recording %dx%d cells at %d pixels per cell", columns, rows, pixelsPerCell);
+            }
+        }
+    }
+
+    if (!state->patternGifRecording)
+    {
+        return;
+    }
+
+    // An unchanged pattern would only be compared against the previous frame and dropped
+    if (state->patternGifGeneration != state->patternGeneration)
+    {
+        TRACE_BEGIN("PatternGifAddFrame");
+        const PatternFrame frame = {
+            .horizontalSequence = state->horizontalSequence,
+            .gridWidth = state->gridWidth,
+            .verticalSequence = state->verticalSequence,
+            .gridHeight = state->gridHeight,
+            .colored = state->colored,
+            .originIsland = state->old00Island != 0 ? state->old00Island : 2,
+        };
+        PatternGifAddFrame(&state->patternGif, &frame, GetTime());
+        state->patternGifGeneration = state->patternGeneration;
+        TRACE_END("PatternGifAddFrame");
+    }
+
+    if ((int)(GetTime() / 0.5) % 2 == 1)
+    {
+        DrawCircle(30, state->windowHeight - 20, 10, MAROON);
+        DrawText("PATTERN GIF", 50, state->windowHeight - 25, 10, RED);
+    }
+}
+
+// One timed update of the pattern, regeneration uses the given grid size
+static void UpdatePattern(AppState* state, int gridWidth, int gridHeight)
+{
+    const bool scrolls = state->updateType != UPDATE_REGENERATE;
+    const SequenceAxis axis = state->updateType == UPDATE_SHIFT && state->diagonalScrollDirection != 0 ? SEQUENCE_VERTICAL : SEQUENCE_HORIZONTAL;
+    const bool timelineReady = scrolls && PrepareTimelineStep(state);
+
+    PROFILE_BEGIN(PROFILE_PHASE_SEQUENCE_UPDATE);
+    switch (state->updateType)
+    {
+    case UPDATE_REGENERATE:
+        RegenerateSequences(state, gridWidth, gridHeight);
+        break;
+    case UPDATE_SHIFT:
+        DiagonalScroll(state);
+        break;
+    case UPDATE_SCROLL:
+        Scroll(state);
+        break;
+    }
+    if (state->colored)
+    {
+        // Only the origin is followed here, the island map is filled once something draws or saves it
+        state->old00Island = NextOriginIsland(state);
+        MarkColoringChanged(state);
+    }
+    PROFILE_END(PROFILE_PHASE_SEQUENCE_UPDATE);
+
+    if (timelineReady && TimelineAppend(&state->timeline, axis))
+    {
+        state->timelineStep = state->timeline.stepCount;
+        assert(!state->colored || state->timeline.originIsland == state->old00Island);
+    }
+    else if (scrolls)
+    {
+        ResetTimeline(state);
+    }
+    state->clusterTick++;
+}
+
+static void RegenerateFromUI(AppState* state, int gridWidth, int gridHeight)
+{
+    PROFILE_BEGIN(PROFILE_PHASE_SEQUENCE_UPDATE);
+    RegenerateSequences(state, gridWidth, gridHeight);
+    state->old00Island = 0;
+    MarkColoringChanged(state);
+    PROFILE_END(PROFILE_PHASE_SEQUENCE_UPDATE);
+}
+
+static uint32_t ReplayParameterValue(const AppState* state, ReplayParameter parameter)
+{
+    switch (parameter)
+    {
+    case REPLAY_PARAMETER_HORIZONTAL_PROBABILITY: return ReplayFloatBits(state->horizontalProbability);
+    case REPLAY_PARAMETER_VERTICAL_PROBABILITY: return ReplayFloatBits(state->verticalProbability);
+    case REPLAY_PARAMETER_CELL_SIZE: return (uint32_t)state->cellSize;
+    case REPLAY_PARAMETER_LOD_SHIFT: return (uint32_t)state->lodShift;
+    case REPLAY_PARAMETER_COLORED: return state->colored;
+    case REPLAY_PARAMETER_UPDATE_TYPE: return (uint32_t)state->updateType;
+    default: return 0;
+    }
+}
+
+static void RecordReplayParameters(AppState* state)
+{
+    if (!state->replayRecording)
+    {
+        return;
+    }
+
+    for (int parameter = 0; parameter < REPLAY_PARAMETER_COUNT; ++parameter)
+    {
+        ReplayWriteParameter(&state->replayWriter, state->frameIndex - state->replayStartFrame, parameter, ReplayParameterValue(state, parameter));
+    }
+}
+
+static void RecordReplayEvent(AppState* state, ReplayEventType type, int gridWidth, int gridHeight)
+{
+    if (!state->replayRecording)
+    {
+        return;
+    }
+
+    const ReplayEvent event = {
+        .type = type,
+        .frame = state->frameIndex - state->replayStartFrame,
+        .gridWidth = gridWidth,
+        .gridHeight = gridHeight,
+    };
+    ReplayWriteEvent(&state->replayWriter, &event);
+}
+
+static void StartReplayRecording(AppState* state)
+{
+    ReplayHeader initial = {
+        .generator = (uint32_t)state->generator,
+        .framesPerSecond = 60,
+        .seed = state->seed,
+        .horizontalOrigin = state->horizontalOrigin,
+        .verticalOrigin = state->verticalOrigin,
+        .gridWidth = state->gridWidth,
+        .gridHeight = state->gridHeight,
+        .diagonalScrollDirection = state->diagonalScrollDirection,
+        .old00Island = state->old00Island,
+        .horizontalFlipped = state->horizontalFlipped,
+        .verticalFlipped = state->verticalFlipped,
+    };
+    for (int parameter = 0; parameter < REPLAY_PARAMETER_COUNT; ++parameter)
+    {
+        initial.parameters[parameter] = ReplayParameterValue(state, parameter);
+    }
+
+    const char* fileName = TextFormat("hitomezashi_%03d" REPLAY_EXTENSION, state->replayCounter);
+    state->replayRecording = ReplayBeginRecording(&state->replayWriter, fileName, &initial, state->horizontalSequence, state->verticalSequence);
+    state->replayStartFrame = state->frameIndex;
+    if (state->replayRecording)
+    {
+        TraceLog(LOG_INFO, "REPLAY: Recording events to %s", fileName);
+    }
+    else
+    {
+        TraceLog(LOG_WARNING, "REPLAY: Failed to create %s", fileName);
+    }
+}
+
+static void StopReplayRecording(AppState* state)
+{
+    if (!state->replayRecording)
+    {
+        return;
+    }
+
+    state->replayRecording = false;
+    const char* fileName = TextFormat("hitomezashi_%03d" REPLAY_EXTENSION, state->replayCounter++);
+    const uint64_t eventCount = state->replayWriter.eventCount;
+    if (ReplayEndRecording(&state->replayWriter))
+    {
+        TraceLog(LOG_INFO, "REPLAY: %llu events written to %s", (unsigned long long)eventCount, fileName);
+    }
+    else
+    {
+        TraceLog(LOG_WARNING, "REPLAY: Failed to write %s", fileName);
+    }
+}
+
+// Logs come from outside: sizes are clamped like a loaded pattern file's, and grids may be no larger than
+// what FitGridToWindow makes of the largest window at the log's cell size and zoom
+static bool IsReplayGridValid(int cellSize, int lodShift, int gridWidth, int gridHeight)
+{
+    const int64_t maxSide = (int64_t)(REPLAY_MAX_WINDOW_SIDE / cellSize) << lodShift;
+    return gridWidth > 0 && gridHeight > 0 && gridWidth <= maxSide && gridHeight <= maxSide;
+}
+
+// Puts the pattern in the state it had when the log started, the island map is rebuilt from the sequences
+static bool ApplyReplayHeader(AppState* state, const ReplayReader* reader)
+{
+    const ReplayHeader* header = &reader->header;
+    const int cellSize = ClampCellSize(header->parameters[REPLAY_PARAMETER_CELL_SIZE]);
+    const int lodShift = ClampLodShift(header->parameters[REPLAY_PARAMETER_LOD_SHIFT]);
+    if (header->parameters[REPLAY_PARAMETER_UPDATE_TYPE] > UPDATE_SCROLL
+        || (header->old00Island != 0 && header->old00Island != 2 && header->old00Island != 4)
+        || !IsReplayGridValid(cellSize, lodShift, header->gridWidth, header->gridHeight))
+    {
+        TraceLog(LOG_WARNING, "REPLAY: Invalid starting pattern");
+        return false;
+    }
+
+    state->generator = (int)header->generator;
+    state->seed = header->seed;
+    state->horizontalOrigin = header->horizontalOrigin;
+    state->verticalOrigin = header->verticalOrigin;
+    state->horizontalFlipped = header->horizontalFlipped != 0;
+    state->verticalFlipped = header->verticalFlipped != 0;
+    state->diagonalScrollDirection = header->diagonalScrollDirection;
+    state->old00Island = header->old00Island;
+    state->horizontalProbability = ReplayBitsFloat(header->parameters[REPLAY_PARAMETER_HORIZONTAL_PROBABILITY]);
+    state->verticalProbability = ReplayBitsFloat(header->parameters[REPLAY_PARAMETER_VERTICAL_PROBABILITY]);
+    state->cellSize = cellSize;
+    state->lodShift = lodShift;
+    state->colored = header->parameters[REPLAY_PARAMETER_COLORED] != 0;
+    state->updateType = (int)header->parameters[REPLAY_PARAMETER_UPDATE_TYPE];
+    state->gridWidth = header->gridWidth;
+    state->gridHeight = header->gridHeight;
+
+    const bool withIslands = !IsLodActive(state);
+    EnsurePatternCapacity(state, state->gridWidth, state->gridHeight, withIslands ? IslandMapWordCount(state->gridWidth, state->gridHeight) : 0);
+    memcpy(state->horizontalSequence, reader->horizontalSequence, state->gridWidth * sizeof(bool));
+    memcpy(state->verticalSequence, reader->verticalSequence, state->gridHeight * sizeof(bool));
+    MarkSequencesChanged(state);
+    ResetTimeline(state);
+    return true;
+}
+
+// False for an event the state can't take, the log is not played any further
+static bool ApplyReplayEvent(AppState* state, const ReplayEvent* event)
+{
+    const bool resizes = event->type == REPLAY_EVENT_REGENERATE || event->type == REPLAY_EVENT_RESIZE
+        || (event->type == REPLAY_EVENT_TICK && event->gridWidth != 0);
+    // A smaller zoom out must still leave the current grid within bounds
+    const bool parameter = event->type == REPLAY_EVENT_PARAMETER;
+    const int cellSize = parameter && event->parameter == REPLAY_PARAMETER_CELL_SIZE ? ClampCellSize(event->value) : state->cellSize;
+    const int lodShift = parameter && event->parameter == REPLAY_PARAMETER_LOD_SHIFT ? ClampLodShift(event->value) : state->lodShift;
+    const bool rescales = cellSize != state->cellSize || lodShift != state->lodShift;
+    if ((resizes && !IsReplayGridValid(cellSize, lodShift, event->gridWidth, event->gridHeight))
+        || (rescales && !IsReplayGridValid(cellSize, lodShift, state->gridWidth, state->gridHeight))
+        || (event->type == REPLAY_EVENT_PARAMETER && event->parameter == REPLAY_PARAMETER_UPDATE_TYPE && event->value > UPDATE_SCROLL))
+    {
+        TraceLog(LOG_WARNING, "REPLAY: Invalid event at frame %llu", (unsigned long long)event->frame);
+        return false;
+    }
+
+    switch (event->type)
+    {
+    case REPLAY_EVENT_TICK:
+        UpdatePattern(state, event->gridWidth != 0 ? event->gridWidth : state->gridWidth, event->gridWidth != 0 ? event->gridHeight : state->gridHeight);
+        break;
+    case REPLAY_EVENT_REGENERATE:
+        RegenerateFromUI(state, event->gridWidth, event->gridHeight);
+        break;
+    case REPLAY_EVENT_RESIZE:
+        ResizeSequences(state, event->gridWidth, event->gridHeight);
+        break;
+    case REPLAY_EVENT_PARAMETER:
+        switch (event->parameter)
+        {
+        case REPLAY_PARAMETER_HORIZONTAL_PROBABILITY: state->horizontalProbability = ReplayBitsFloat(event->value); break;
+        case REPLAY_PARAMETER_VERTICAL_PROBABILITY: state->verticalProbability = ReplayBitsFloat(event->value); break;
+        case REPLAY_PARAMETER_CELL_SIZE: state->cellSize = cellSize; break;
+        case REPLAY_PARAMETER_LOD_SHIFT: state->lodShift = lodShift; break;
+        case REPLAY_PARAMETER_COLORED: state->colored = event->value != 0; MarkColoringChanged(state); ResetTimeline(state); break;
+        case REPLAY_PARAMETER_UPDATE_TYPE: state->updateType = (int)event->value; ResetTimeline(state); break;
+        }
+        break;
+    }
+    return true;
+}
+
+static bool StartReplay(AppState* state, const char* fileName)
+{
+    StopReplayRecording(state);
+    ReplayClose(&state->replayReader);
+    if (!ReplayOpen(&state->replayReader, fileName))
+    {
+        TraceLog(LOG_WARNING, "REPLAY: Failed to open %s", fileName);
+        return false;
+    }
+
+    if (!ApplyReplayHeader(state, &state->replayReader))
+    {
+        ReplayClose(&state->replayReader);
+        return false;
+    }
+    state->replaying = true;
+    state->replayFrame = 0.0;
+    state->replayHasNext = ReplayReadEvent(&state->replayReader, &state->replayNext);
+    TraceLog(LOG_INFO, "REPLAY: Playing %s at %.2fx", fileName, state->replaySpeed);
+    return true;
+}
+
+// Applies every event up to the current log position, timed updates are paused while a log plays
+static void UpdateReplay(AppState* state)
+{
+    bool rejected = false;
+    while (state->replayHasNext && (double)state->replayNext.frame <= state->replayFrame)
+    {
+        rejected = !ApplyReplayEvent(state, &state->replayNext);
+        state->replayHasNext = !rejected && ReplayReadEvent(&state->replayReader, &state->replayNext);
+    }
+    state->replayFrame += state->replaySpeed;
+
+    if (!state->replayHasNext)
+    {
+        rejected = rejected || state->replayReader.rejected;
+        state->replaying = false;
+        state->updateSpeed = 0.0f;
+        ReplayClose(&state->replayReader);
+        TraceLog(rejected ? LOG_WARNING : LOG_INFO, rejected ? "REPLAY: Stopped at an invalid event" : "REPLAY: Finished");
+    }
+}
+
+static bool ReplayToGif(AppState* state, const char* replayFileName, const char* gifFileName, int pixelsPerCell)
+{
+    ReplayReader reader;
+    if (!ReplayOpen(&reader, replayFileName))
+    {
+        TraceLog(LOG_WARNING, "REPLAY: Failed to open %s", replayFileName);
+        return false;
+    }
+
+    if (!ApplyReplayHeader(state, &reader))
+    {
+        ReplayClose(&reader);
+        return false;
+    }
+    const int columns = state->gridWidth < PATTERN_GIF_MAX_SIDE / pixelsPerCell ? state->gridWidth : PATTERN_GIF_MAX_SIDE / pixelsPerCell;
+    const int rows = state->gridHeight < PATTERN_GIF_MAX_SIDE / pixelsPerCell ? state->gridHeight : PATTERN_GIF_MAX_SIDE / pixelsPerCell;
+    const double secondsPerFrame = 1.0 / (reader.header.framesPerSecond != 0 ? reader.header.framesPerSecond : 60);
+    PatternGif gif;
+    if (!PatternGifBegin(&gif, columns, rows, pixelsPerCell, 0.0))
+    {
+        ReplayClose(&reader);
+        return false;
+    }
+
+    // A GIF frame is taken once every event of a log frame has been applied
+    ReplayEvent event;
+    bool hasEvent = ReplayReadEvent(&reader, &event);
+    uint64_t frame = 0;
+    while (true)
+    {
+        if (!hasEvent || event.frame != frame)
+        {
+            const PatternFrame gifFrame = {
+                .horizontalSequence = state->horizontalSequence,
+                .gridWidth = state->gridWidth,
+                .verticalSequence = state->verticalSequence,
+                .gridHeight = state->gridHeight,
+                .colored = state->colored,
+                .originIsland = state->old00Island != 0 ? state->old00Island : 2,
+            };
+            PatternGifAddFrame(&gif, &gifFrame, frame * secondsPerFrame);
+        }
+        if (!hasEvent)
+        {
+            break;
+        }
 
-typedef struct AppState_t
-{
-    int windowWidth;
-    int windowHeight;
+        frame = event.frame;
+        hasEvent = ApplyReplayEvent(state, &event) && ReplayReadEvent(&reader, &event);
+    }
+    if (reader.rejected)
+    {
+        TraceLog(LOG_WARNING, "REPLAY: Stopped at an invalid event");
+    }
 
-    float verticalProbability;
-    float horizontalProbability;
+    const bool saved = PatternGifEnd(&gif, gifFileName, (frame + 1) * secondsPerFrame);
+    TraceLog(saved ? LOG_INFO : LOG_WARNING, "REPLAY: %s %s", saved ? "Rendered to" : "Failed to write", gifFileName);
+    ReplayClose(&reader);
+    return saved;
+}
 
-    int cellSize;
-    int gridWidth;
-    int gridHeight;
-    bool* verticalSequence;
-    bool* horizontalSequence;
-    int* islands;
+// F8 toggles recording of the pattern events
+static void UpdateReplayRecording(AppState* state)
+{
+    if (!IsKeyPressed(KEY_F8) || state->replaying)
+    {
+        return;
+    }
 
-    int old00Island;
+    if (state->replayRecording)
+    {
+        StopReplayRecording(state);
+    }
+    else
+    {
+        StartReplayRecording(state);
+    }
+}
 
-    double lastUpdateTime;
-    float updateSpeed; // How many time per second to update
-    int updateType;
-    bool updateTypeEditMode;
-    bool showFPS;
-    bool colored;
+// LEFT and RIGHT step through the timeline while updates are paused
+static void UpdateTimelineKeys(AppState* state)
+{
+    if (state->updateSpeed != 0.0f || state->timeline.axisBits == NULL)
+    {
+        return;
+    }
 
-    int diagonalScrollDirection;
-} AppState;
+    if ((IsKeyPressed(KEY_LEFT) || IsKeyPressedRepeat(KEY_LEFT)) && state->timelineStep > 0)
+    {
+        SeekTimeline(state, state->timelineStep - 1);
+    }
+    else if ((IsKeyPressed(KEY_RIGHT) || IsKeyPressedRepeat(KEY_RIGHT)) && state->timelineStep < state->timeline.stepCount)
+    {
+        SeekTimeline(state, state->timelineStep + 1);
+    }
+}
 
-typedef struct UIUpdateResult_t
+static void BeginGallery(AppState* state, float horizontalMin, float horizontalMax, float verticalMin, float verticalMax, uint64_t seed)
 {
-	int renderAreaWidth;
-    bool shouldRegenerate;
-} UIUpdateResult;
+    const GallerySweep sweep = {
+        .columns = state->gallerySide,
+        .rows = state->gallerySide,
+        .horizontalMin = horizontalMin < 0.0f ? 0.0f : horizontalMin,
+        .horizontalMax = horizontalMax > 1.0f ? 1.0f : horizontalMax,
+        .verticalMin = verticalMin < 0.0f ? 0.0f : verticalMin,
+        .verticalMax = verticalMax > 1.0f ? 1.0f : verticalMax,
+        .seed = seed,
+        .colored = state->colored,
+    };
+    state->frameAllocates = true;
+    if (!GalleryBegin(&state->gallery, &sweep))
+    {
+        TraceLog(LOG_WARNING, "GALLERY: Failed to start the sweep");
+        state->galleryOpen = false;
+    }
+}
 
-static float Uniform01Rand() { return GetRandomValue(0, 1000) / 1000.0f; }
-static void UpdateDrawFrame(AppState* state);
-static UIUpdateResult UpdateDrawUI(AppState* state); // Returns the x coordinate of the beginning of the UI blockhorizontalSequence
-static void RegenerateSequences(AppState* state)
+// Left click adopts the parameters of a thumbnail, right click sweeps a narrower range around it and R sweeps another seed
+static void UpdateGallery(AppState* state, int renderAreaWidth)
 {
-    state->windowWidth = GetRenderWidth();
-    state->windowHeight = GetRenderHeight();
+    const Rectangle bounds = { 0, 0, (float)renderAreaWidth, (float)state->windowHeight };
+    GalleryUpdate(&state->gallery);
+    GalleryDraw(&state->gallery, bounds);
 
-	if (state->verticalSequence)
-	{
-		free(state->verticalSequence);
-	}
-	if (state->horizontalSequence)
-	{
-		free(state->horizontalSequence);
-	}
+    const GallerySweep sweep = state->gallery.sweep;
+    if (IsKeyPressed(KEY_R))
+    {
+        BeginGallery(state, sweep.horizontalMin, sweep.horizontalMax, sweep.verticalMin, sweep.verticalMax, SplitMix64(sweep.seed));
+        return;
+    }
 
-    state->gridWidth = state->windowWidth / state->cellSize;
-    state->gridHeight = state->windowHeight / state->cellSize;
+    int column;
+    int row;
+    if (!GalleryPick(&state->gallery, bounds, GetMousePosition(), &column, &row))
+    {
+        return;
+    }
 
-	state->horizontalSequence = (bool*)malloc(state->gridWidth * sizeof(bool));
-    assert(state->horizontalSequence != NULL);
-	for (int i = 0; i < state->gridWidth; ++i)
-	{
-		state->horizontalSequence[i] = Uniform01Rand() < state->horizontalProbability;
-	}
+    const float horizontalProbability = GalleryHorizontalProbability(&sweep, column);
+    const float verticalProbability = GalleryVerticalProbability(&sweep, row);
+    const Rectangle thumbnail = GalleryThumbnailBounds(&state->gallery, bounds, column, row);
+    DrawRectangleLinesEx(thumbnail, 2.0f, BLUE);
+    DrawText(TextFormat("HP %.3f VP %.3f", horizontalProbability, verticalProbability), 10, state->windowHeight - 25, 20, DARKBLUE);
 
-    state->verticalSequence = (bool*)malloc(state->gridHeight * sizeof(bool));
-    assert(state->verticalSequence != NULL);
-    for (int i = 0; i < state->gridHeight; ++i)
+    if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT))
     {
-        state->verticalSequence[i] = Uniform01Rand() < state->verticalProbability;
+        if (sweep.seed != state->seed)
+        {
+            StopReplayRecording(state); // The log only knows the seeds that follow from its first one
+        }
+        state->horizontalProbability = horizontalProbability;
+        state->verticalProbability = verticalProbability;
+        state->seed = sweep.seed;
+        int gridWidth;
+        int gridHeight;
+        FitGridToWindow(state, &gridWidth, &gridHeight);
+        RegenerateFromUI(state, gridWidth, gridHeight);
+        RecordReplayParameters(state);
+        RecordReplayEvent(state, REPLAY_EVENT_REGENERATE, gridWidth, gridHeight);
+        state->galleryOpen = false;
+    }
+    else if (IsMouseButtonPressed(MOUSE_BUTTON_RIGHT))
+    {
+        const float horizontalStep = (sweep.horizontalMax - sweep.horizontalMin) / sweep.columns;
+        const float verticalStep = (sweep.verticalMax - sweep.verticalMin) / sweep.rows;
+        BeginGallery(state, horizontalProbability - horizontalStep, horizontalProbability + horizontalStep,
+            verticalProbability - verticalStep, verticalProbability + verticalStep, sweep.seed);
     }
-
-    if (state->islands)
-	{
-		free(state->islands);
-	}
-    state->islands = (int*)calloc(state->gridWidth * state->gridHeight, sizeof(int));
 }
 
-static void GenericScroll(bool* primarySequence, int primaryLength, float primaryProbability, bool* secondarySequence, int secondaryLength)
+// Warm shades for island 2 and cool ones for island 4, so neighbouring regions never share a color
+#define REGION_PALETTE_SIZE 4
+static const Color regionPalette[2][REGION_PALETTE_SIZE] = {
+    { RED, MAROON, ORANGE, PINK },
+    { GREEN, LIME, DARKGREEN, SKYBLUE },
+};
+
+// Labels only depend on the sequences, they are rebuilt after the pattern changed
+static bool UpdateRegionLabels(AppState* state)
 {
-    for (int i = 1; i < primaryLength; ++i)
+    if (state->regionsGeneration != state->sequenceGeneration || state->regions.gridWidth != state->gridWidth || state->regions.gridHeight != state->gridHeight)
     {
-        primarySequence[primaryLength - i] = primarySequence[primaryLength - 1 - i];
+        TRACE_BEGIN("RegionLabel");
+        RegionLabel(&state->regions, state->horizontalSequence, state->gridWidth, state->verticalSequence, state->gridHeight);
+        TRACE_END("RegionLabel");
+        state->regionsGeneration = state->sequenceGeneration;
     }
-    primarySequence[0] = Uniform01Rand() < primaryProbability;
+    return state->regions.regionCount > 0;
+}
 
-    for (int i = 0; i < secondaryLength; ++i)
+// Outlines the region under the mouse and names it
+static void DrawHoveredRegion(AppState* state, int visibleColumns)
+{
+    const Vector2 mouse = GetMousePosition();
+    const int x = (int)mouse.x / state->cellSize;
+    const int y = (int)mouse.y / state->cellSize;
+    const int id = x < visibleColumns ? RegionAt(&state->regions, x, y) : -1;
+    if (id < 0)
     {
-        secondarySequence[i] = !secondarySequence[i];
+        return;
     }
+
+    const RegionInfo* region = &state->regions.regions[id];
+    DrawRectangleLines(region->minX * state->cellSize, region->minY * state->cellSize,
+        (region->maxX - region->minX + 1) * state->cellSize, (region->maxY - region->minY + 1) * state->cellSize, BLUE);
+    DrawText(TextFormat("Region %d of %d, %d cells", id + 1, state->regions.regionCount, region->area), 10, state->windowHeight - 25, 20, DARKBLUE);
 }
 
-static void Scroll(AppState* state)
+// Generator state of the whole wall, sent every frame so that lost datagrams and late nodes catch up on their own
+static void UpdateClusterCoordinator(AppState* state)
 {
-    GenericScroll(state->horizontalSequence, state->gridWidth, state->horizontalProbability, state->verticalSequence, state->gridHeight);
+    if (state->generator != GENERATOR_SPLITMIX64)
+    {
+        return; // Loaded sequences without a generator can't be extended past this grid
+    }
+
+    ClusterMessage message = {
+        .tick = state->clusterTick,
+        .seed = state->seed,
+        .horizontalOrigin = state->horizontalOrigin,
+        .verticalOrigin = state->verticalOrigin,
+        .horizontalProbability = ReplayFloatBits(state->horizontalProbability),
+        .verticalProbability = ReplayFloatBits(state->verticalProbability),
+        .cellSize = state->cellSize,
+        .lodShift = state->lodShift,
+        .updateType = state->updateType,
+        .originIsland = state->old00Island,
+        .horizontalFlipped = state->horizontalFlipped,
+        .verticalFlipped = state->verticalFlipped,
+        .diagonalScrollDirection = (uint8_t)state->diagonalScrollDirection,
+        .colored = state->colored,
+    };
+    ClusterSend(&state->cluster, &message);
 }
 
-static void DiagonalScroll(AppState* state)
+// Parity of the generated stitches 1 - origin to offset - origin, the ones between a node's first column (or
+// row) and the global one. Scrolling moves the origin a stitch or so per tick, so the stitches entering and
+// leaving the range are applied to the cached parity, it is only generated in full for a new offset or pattern.
+static bool StitchParity(ClusterParity* cache, uint64_t seed, SequenceAxis axis, float probability, int64_t offset, int64_t origin)
 {
-	if (state->diagonalScrollDirection == 0)
-	{
-		GenericScroll(state->horizontalSequence, state->gridWidth, state->horizontalProbability, state->verticalSequence, state->gridHeight);
-	}
-	else
-	{
-		GenericScroll(state->verticalSequence, state->gridHeight, state->verticalProbability, state->horizontalSequence, state->gridWidth);
-	}
-    state->diagonalScrollDirection = !state->diagonalScrollDirection;
+    const int64_t distance = origin > cache->origin ? origin - cache->origin : cache->origin - origin;
+    if (!cache->valid || cache->seed != seed || cache->probability != probability || cache->offset != offset || distance >= offset)
+    {
+        cache->parity = false;
+        for (int64_t i = 1; i <= offset; ++i)
+        {
+            cache->parity ^= GeneratorStitch(seed, axis, i - origin, probability);
+        }
+    }
+    else
+    {
+        for (; cache->origin < origin; ++cache->origin)
+        {
+            cache->parity ^= GeneratorStitch(seed, axis, offset - cache->origin, probability) ^ GeneratorStitch(seed, axis, -cache->origin, probability);
+        }
+        for (; cache->origin > origin; --cache->origin)
+        {
+            cache->parity ^= GeneratorStitch(seed, axis, 1 - cache->origin, probability) ^ GeneratorStitch(seed, axis, offset + 1 - cache->origin, probability);
+        }
+    }
+    cache->valid = true;
+    cache->seed = seed;
+    cache->probability = probability;
+    cache->offset = offset;
+    cache->origin = origin;
+    return cache->parity;
 }
 
-int main(void)
+// Rebuilds the node's slice from the global generator state. The slice starts at an even cell, so the
+// stitch rows and columns keep the parity they have on the coordinator.
+static void ApplyClusterMessage(AppState* state, const ClusterMessage* message)
 {
-    srand(1023);
-    AppState appState = {
-        .windowWidth = 640,
-        .windowHeight = 480,
-        .verticalProbability = 0.5f,
-        .horizontalProbability = 0.5f,
-        .cellSize = 20,
-        .gridWidth = 0,
-        .gridHeight = 0,
-        .horizontalSequence = NULL,
-        .verticalSequence = NULL,
-        .islands = NULL,
-        .old00Island = 0,
-        .lastUpdateTime = 0.0,
-        .updateSpeed = 10.0,
-        .updateType = UPDATE_REGENERATE,
-        .updateTypeEditMode = false,
-        .colored = false,
-        .diagonalScrollDirection = 0,
-    };
-    InitWindow(appState.windowWidth, appState.windowHeight, "hitomezashi pattern generator");
-    SetWindowState(FLAG_WINDOW_RESIZABLE);
-    SetWindowMinSize(480, 480);
-    GuiSetStyle(DEFAULT, TEXT_SIZE, 20);
+    state->generator = GENERATOR_SPLITMIX64;
+    state->seed = message->seed;
+    state->horizontalProbability = ReplayBitsFloat(message->horizontalProbability);
+    state->verticalProbability = ReplayBitsFloat(message->verticalProbability);
+    state->cellSize = ClampCellSize(message->cellSize);
+    state->lodShift = ClampLodShift(message->lodShift);
+    state->updateType = message->updateType;
+    state->diagonalScrollDirection = message->diagonalScrollDirection;
+    state->colored = message->colored != 0;
 
-    SetTargetFPS(60);
-    RegenerateSequences(&appState);
-    while (!WindowShouldClose())
+    int gridWidth;
+    int gridHeight;
+    FitGridToWindow(state, &gridWidth, &gridHeight);
+    state->gridWidth = gridWidth;
+    state->gridHeight = gridHeight;
+    const bool withIslands = !IsLodActive(state);
+    EnsurePatternCapacity(state, gridWidth, gridHeight, withIslands ? IslandMapWordCount(gridWidth, gridHeight) : 0);
+
+    const int64_t columnOffset = ((int64_t)(state->clusterViewportX / state->cellSize) << state->lodShift) & ~(int64_t)1;
+    const int64_t rowOffset = ((int64_t)(state->clusterViewportY / state->cellSize) << state->lodShift) & ~(int64_t)1;
+    state->horizontalOrigin = message->horizontalOrigin - columnOffset;
+    state->verticalOrigin = message->verticalOrigin - rowOffset;
+    state->horizontalFlipped = message->horizontalFlipped != 0;
+    state->verticalFlipped = message->verticalFlipped != 0;
+    for (int i = 0; i < gridWidth; ++i)
     {
-        UpdateDrawFrame(&appState);
+        state->horizontalSequence[i] = HorizontalStitch(state, i);
+    }
+    for (int i = 0; i < gridHeight; ++i)
+    {
+        state->verticalSequence[i] = VerticalStitch(state, i);
     }
 
-    CloseWindow();
-    return 0;
+    // An even cell is in the other island than global (0, 0) when the stitches between them have odd parity,
+    // the flips cancel out over the even number of stitches
+    const bool otherIsland = StitchParity(&state->clusterColumnParity, state->seed, SEQUENCE_HORIZONTAL, state->horizontalProbability, columnOffset, message->horizontalOrigin)
+        ^ StitchParity(&state->clusterRowParity, state->seed, SEQUENCE_VERTICAL, state->verticalProbability, rowOffset, message->verticalOrigin);
+    state->old00Island = message->originIsland != 0 && otherIsland ? message->originIsland ^ 6 : message->originIsland;
+    MarkSequencesChanged(state);
+    ResetTimeline(state);
 }
 
-static void IterativeFill(AppState* state)
+// Messages come off the network, values the replay header would reject are dropped the same way
+static bool IsClusterMessageValid(const ClusterMessage* message)
 {
-    memset(state->islands, 0, state->gridWidth * state->gridHeight * sizeof(int));
+    return message->updateType >= 0 && message->updateType <= UPDATE_SCROLL
+        && (message->originIsland == 0 || message->originIsland == 2 || message->originIsland == 4);
+}
 
-    int currentIsland = 2;
-    if (state->old00Island != 0)
+// A node never updates on its own clock, it shows the newest state the coordinator sent
+static void UpdateClusterNode(AppState* state)
+{
+    ClusterMessage message;
+    bool changed = false;
+    while (ClusterReceive(&state->cluster, &message))
     {
-        switch (state->updateType)
+        if (!IsClusterMessageValid(&message))
         {
-        case UPDATE_SCROLL:
-            currentIsland = state->horizontalSequence[1] ? state->old00Island : state->old00Island ^ 6;
-            break;
-        case UPDATE_SHIFT:
-            const bool keep = state->diagonalScrollDirection == 1 && state->horizontalSequence[1] || state->diagonalScrollDirection == 0 && state->verticalSequence[1];
-            currentIsland = keep ? state->old00Island : state->old00Island ^ 6;
-            break;
+            TraceLog(LOG_WARNING, "CLUSTER: Dropped an invalid message for tick %llu", (unsigned long long)message.tick);
+            continue;
         }
+        const size_t contentOffset = offsetof(ClusterMessage, tick);
+        changed |= !state->clusterHasState
+            || memcmp((const char*)&message + contentOffset, (const char*)&state->clusterLast + contentOffset, sizeof(message) - contentOffset) != 0;
+        state->clusterLast = message;
+        state->clusterHasState = true;
     }
 
-    for (int y = 0; y < state->gridHeight; ++y)
-	{
-        const bool yOdd = (y & 1) == 1;
-		for (int x = 0; x < state->gridWidth; ++x)
-		{
-			state->islands[y * state->gridWidth + x] = currentIsland;
-            if (x + 1 < state->gridWidth)
-            {
-                const bool nextShifted = state->horizontalSequence[x + 1];
-                const bool keep = yOdd && !nextShifted || !yOdd && nextShifted;
-                currentIsland = keep ? currentIsland : currentIsland ^ 6;
-            }
-		}
-
-        currentIsland = state->islands[y * state->gridWidth];
-        if (y + 1 < state->gridHeight)
-		{
-			currentIsland = state->verticalSequence[y + 1] ? currentIsland : currentIsland ^ 6;
-		}
-	}
-
-	state->old00Island = state->islands[0];
+    if (state->clusterHasState && (changed || IsWindowResized()))
+    {
+        TRACE_BEGIN("ApplyClusterMessage");
+        state->clusterTick = state->clusterLast.tick;
+        ApplyClusterMessage(state, &state->clusterLast);
+        TRACE_END("ApplyClusterMessage");
+    }
+    else if (IsWindowResized())
+    {
+        int gridWidth;
+        int gridHeight;
+        FitGridToWindow(state, &gridWidth, &gridHeight);
+        ResizeSequences(state, gridWidth, gridHeight);
+    }
 }
 
 void UpdateDrawFrame(AppState* state)
 {
-    if (IsWindowResized())
-    {
-		RegenerateSequences(state);
-	}
+    UpdateTraceCapture(state);
+    UpdatePatternFiles(state);
+    UpdateReplayRecording(state);
 
-    double currentTime = GetTime();
-    bool updatePattern = state->updateSpeed != 0.0 && currentTime > (state->lastUpdateTime + (1.0f / state->updateSpeed));
-    if (updatePattern)
+#if !defined(NDEBUG)
+    const long allocationsAtFrameStart = GameGetAllocationCount() - GameGetGrowthCount();
+    state->frameAllocates = false;
+    const int gridWidthAtFrameStart = state->gridWidth;
+    const int gridHeightAtFrameStart = state->gridHeight;
+#endif
+
+    if (state->clusterRole == CLUSTER_NODE)
     {
-        state->lastUpdateTime = currentTime;
-        switch (state->updateType)
+        UpdateClusterNode(state);
+    }
+    else if (state->replaying)
+    {
+        if (IsWindowResized())
         {
-        case UPDATE_REGENERATE:
-            RegenerateSequences(state);
-            break;
-        case UPDATE_SHIFT:
-            DiagonalScroll(state);
-            break;
-        case UPDATE_SCROLL:
-            Scroll(state);
-			break;
+            int gridWidth;
+            int gridHeight;
+            FitGridToWindow(state, &gridWidth, &gridHeight); // Only the UI follows the window, the grid comes from the log
+        }
+        UpdateReplay(state);
+    }
+    else
+    {
+        if (IsWindowResized())
+        {
+            int gridWidth;
+            int gridHeight;
+            FitGridToWindow(state, &gridWidth, &gridHeight);
+            ResizeSequences(state, gridWidth, gridHeight);
+            RecordReplayEvent(state, REPLAY_EVENT_RESIZE, gridWidth, gridHeight);
         }
-        if (state->colored)
+        UpdateTimelineKeys(state);
+
+        double currentTime = GetAppTime(state);
+        bool updatePattern = state->updateSpeed != 0.0 && currentTime > (state->lastUpdateTime + (1.0f / state->updateSpeed));
+        if (updatePattern)
         {
-            IterativeFill(state);
+            state->lastUpdateTime = currentTime;
+            int gridWidth = state->gridWidth;
+            int gridHeight = state->gridHeight;
+            if (state->updateType == UPDATE_REGENERATE)
+            {
+                FitGridToWindow(state, &gridWidth, &gridHeight);
+            }
+            const bool gridChanged = gridWidth != state->gridWidth || gridHeight != state->gridHeight;
+            UpdatePattern(state, gridWidth, gridHeight);
+            RecordReplayEvent(state, REPLAY_EVENT_TICK, gridChanged ? gridWidth : 0, gridChanged ? gridHeight : 0);
         }
     }
 
     BeginDrawing();
     {
         ClearBackground(WHITE);
-        const UIUpdateResult uiUpdate = UpdateDrawUI(state);
-        if (uiUpdate.shouldRegenerate)
+        PROFILE_BEGIN(PROFILE_PHASE_UI);
+        TRACE_BEGIN("UpdateDrawUI");
+        if (state->replaying || state->clusterRole == CLUSTER_NODE)
+        {
+            GuiDisable(); // The log or the coordinator drives every parameter
+        }
+        const UIUpdateResult uiUpdate = UpdateDrawPanel(state);
+        GuiEnable();
+        TRACE_END("UpdateDrawUI");
+        PROFILE_END(PROFILE_PHASE_UI);
+        RecordReplayParameters(state);
+        if (uiUpdate.shouldRegenerate && !state->replaying && state->clusterRole != CLUSTER_NODE)
 		{
-			RegenerateSequences(state);
-            state->old00Island = 0;
-            if (state->colored)
-            {
-                IterativeFill(state);
-            }
+            int gridWidth;
+            int gridHeight;
+            FitGridToWindow(state, &gridWidth, &gridHeight);
+            RegenerateFromUI(state, gridWidth, gridHeight);
+            RecordReplayEvent(state, REPLAY_EVENT_REGENERATE, gridWidth, gridHeight);
 		}
+        if (state->clusterRole == CLUSTER_COORDINATOR)
+        {
+            UpdateClusterCoordinator(state);
+        }
+
+        PROFILE_BEGIN(PROFILE_PHASE_PATTERN_DRAW);
+        TRACE_BEGIN("DrawPattern");
 
         const int cappedGridWidth = (uiUpdate.renderAreaWidth / state->cellSize) < state->gridWidth ? (uiUpdate.renderAreaWidth / state->cellSize - 1) : state->gridWidth;
         
-        if (!state->colored)
+        if (state->galleryOpen)
+        {
+            UpdateGallery(state, uiUpdate.renderAreaWidth);
+        }
+        else if (IsLodActive(state))
+        {
+            const int visibleColumns = uiUpdate.renderAreaWidth / state->cellSize;
+            const int lodColumns = visibleColumns < (state->gridWidth >> state->lodShift) ? visibleColumns - 1 : (state->gridWidth >> state->lodShift);
+            const int lodRows = state->gridHeight >> state->lodShift;
+            if (state->lodGeneration != state->patternGeneration || state->lodTextureShift != state->lodShift || state->lod.texture.width != lodColumns || state->lod.texture.height != lodRows)
+            {
+                const LodPattern pattern = {
+                    .horizontalSequence = state->horizontalSequence,
+                    .gridWidth = state->gridWidth,
+                    .verticalSequence = state->verticalSequence,
+                    .gridHeight = state->gridHeight,
+                    .shift = state->lodShift,
+                    .columns = lodColumns,
+                    .rows = lodRows,
+                    .colored = state->colored,
+                    .originIsland = state->old00Island != 0 ? state->old00Island : 2,
+                };
+                LodUpdate(&state->lod, &pattern);
+                state->lodGeneration = state->patternGeneration;
+                state->lodTextureShift = state->lodShift;
+            }
+            LodDraw(&state->lod, state->cellSize);
+        }
+        else if (!state->colored)
         {
             // Horizontal pass
             for (int i = 0; i < cappedGridWidth; ++i)
@@ -277,17 +1992,64 @@ void UpdateDrawFrame(AppState* state)
         }
         else
         {
-			for (int i = 0; i < state->gridHeight; ++i)
-			{
-				for (int j = 0; j < cappedGridWidth; ++j)
-				{
-                    Color color = state->islands[i * state->gridWidth + j] == 2 ? RED : GREEN;
-					DrawRectangle(j * state->cellSize, i * state->cellSize, state->cellSize, state->cellSize, color);
-				}
-			}
+            EnsureIslands(state);
+            const bool labeled = state->showRegions && UpdateRegionLabels(state);
+            // Cells are visited a tile at a time, a run of one color in a tile row is drawn as one rectangle
+            IslandMapIterator cells = IslandMapIterate(&state->islands, 0, 0, cappedGridWidth, state->gridHeight);
+            IslandMapSpan span;
+            while (IslandMapNext(&cells, &span))
+            {
+                const int* labels = labeled ? state->regions.labels + (size_t)span.y * state->gridWidth + span.x : NULL;
+                for (int start = 0; start < span.count;)
+                {
+                    const bool red = ((span.red >> start) & 1) != 0;
+                    int end = start + 1;
+                    while (end < span.count && (((span.red >> end) & 1) != 0) == red && (labels == NULL || labels[end] == labels[start]))
+                    {
+                        end++;
+                    }
+                    const Color color = labels != NULL ? regionPalette[red ? 0 : 1][labels[start] % REGION_PALETTE_SIZE] : (red ? RED : GREEN);
+                    DrawRectangle((int)(span.x + start) * state->cellSize, (int)span.y * state->cellSize, (end - start) * state->cellSize, state->cellSize, color);
+                    start = end;
+                }
+            }
+            if (labeled)
+            {
+                DrawHoveredRegion(state, cappedGridWidth);
+            }
+        }
+        TRACE_END("DrawPattern");
+        PROFILE_END(PROFILE_PHASE_PATTERN_DRAW);
+
+        UpdatePatternRecording(state, uiUpdate.renderAreaWidth);
+
+#if PROFILER_ENABLED
+        if (state->showProfiler)
+        {
+            const int overlayWidth = uiUpdate.renderAreaWidth - 20 < 480 ? uiUpdate.renderAreaWidth - 20 : 480;
+            PROFILE_DRAW_OVERLAY(10, state->windowHeight - 170, overlayWidth, 160);
         }
+#endif
+    }
+    if (state->harnessing)
+    {
+        HarnessCapture(&state->harness);
     }
+    PROFILE_BEGIN(PROFILE_PHASE_END_DRAWING);
+    TRACE_BEGIN("EndDrawing");
     EndDrawing();
+    TRACE_END("EndDrawing");
+    PROFILE_END(PROFILE_PHASE_END_DRAWING);
+    PROFILE_END_FRAME();
+
+    state->frameIndex++;
+
+#if !defined(NDEBUG)
+    // Steady state frames, where the grid keeps its size and no action allocates, must not allocate beyond the
+    // geometric growth of GameGrow
+    const bool gridResized = IsWindowResized() || state->gridWidth != gridWidthAtFrameStart || state->gridHeight != gridHeightAtFrameStart;
+    assert(gridResized || state->frameAllocates || GameGetAllocationCount() - GameGetGrowthCount() == allocationsAtFrameStart);
+#endif
 }
 
 // Simplest possible layout system, top to bottom, possibly with half-width controls
@@ -303,6 +2065,7 @@ typedef struct UILayout_t
 
 #define TEXT_HEIGHT 20
 #define FAT_CONTROL_HEIGHT 40
+#define PANEL_WIDTH 250
 
 static Rectangle LayoutFull(UILayout* layout, bool isText)
 {
@@ -348,8 +2111,8 @@ static Rectangle LayoutCheckbox(UILayout* layout)
 UIUpdateResult UpdateDrawUI(AppState* state)
 {
     UILayout layout = {
-		.controlWidth = 250,
-		.controlRectXStart = state->windowWidth - 250,
+		.controlWidth = PANEL_WIDTH,
+		.controlRectXStart = state->windowWidth - PANEL_WIDTH,
 	};
 
 
@@ -357,10 +2120,18 @@ UIUpdateResult UpdateDrawUI(AppState* state)
     float floatCellSize = (float)state->cellSize;
     const bool cellSizeChanged = GuiSlider(
         LayoutFull(&layout, false),
-        NULL, NULL, &floatCellSize, 3, 60
+        NULL, NULL, &floatCellSize, 1, 60
     );
     state->cellSize = (int)floatCellSize;
 
+    GuiLabel(LayoutFull(&layout, true), TextFormat("Zoom out %dx", 1 << state->lodShift));
+    float floatLodShift = (float)state->lodShift;
+    const bool lodShiftChanged = GuiSlider(
+        LayoutFull(&layout, false),
+        NULL, NULL, &floatLodShift, 0, LOD_MAX_SHIFT
+    );
+    state->lodShift = (int)(floatLodShift + 0.5f);
+
     GuiLabel(LayoutHalf(&layout, true), "HP");
     GuiLabel(LayoutHalf(&layout, true), "VP");
     const bool hpChanged = GuiSlider(LayoutHalf(&layout, false), NULL, NULL, &state->horizontalProbability, 0.0, 1.0);
@@ -371,20 +2142,122 @@ UIUpdateResult UpdateDrawUI(AppState* state)
     GuiLabel(LayoutFull(&layout, true), "Update frequency");
     GuiSlider(LayoutFull(&layout, false), NULL, NULL, &state->updateSpeed, 0.0, 60.0);
 
+    GuiLabel(LayoutFull(&layout, true), TextFormat("Timeline %llu/%llu", (unsigned long long)state->timelineStep, (unsigned long long)state->timeline.stepCount));
+    float floatTimelineStep = (float)state->timelineStep;
+    if (GuiSlider(LayoutFull(&layout, false), NULL, NULL, &floatTimelineStep, 0.0f, (float)(state->timeline.stepCount > 0 ? state->timeline.stepCount : 1)) && state->timeline.stepCount > 0)
+    {
+        // Scrubbing pauses the animation so the chosen step stays on screen
+        state->updateSpeed = 0.0f;
+        SeekTimeline(state, (uint64_t)(floatTimelineStep + 0.5f));
+    }
+
     GuiLabel(updateTypeLblRect, "Update type");
+    const int previousUpdateType = state->updateType;
     if (GuiDropdownBox(updateTypeRect, "REGENERATE;SHIFT;SCROLL", &state->updateType, state->updateTypeEditMode))
         state->updateTypeEditMode = !state->updateTypeEditMode;
 
+    const bool wasColored = state->colored;
     GuiCheckBox(LayoutCheckbox(&layout), "Colored", &state->colored);
+    if (wasColored != state->colored)
+    {
+        MarkColoringChanged(state);
+    }
+    if (previousUpdateType != state->updateType || wasColored != state->colored)
+    {
+        ResetTimeline(state);
+    }
+    GuiCheckBox(LayoutCheckbox(&layout), "Regions", &state->showRegions);
+    const bool wasGalleryOpen = state->galleryOpen;
+    GuiCheckBox(LayoutCheckbox(&layout), "Gallery", &state->galleryOpen);
+    const GallerySweep* sweep = &state->gallery.sweep;
+    if (state->galleryOpen && !wasGalleryOpen)
+    {
+        BeginGallery(state, 0.0f, 1.0f, 0.0f, 1.0f, state->seed);
+    }
+    else if (state->galleryOpen && wasColored != state->colored)
+    {
+        BeginGallery(state, sweep->horizontalMin, sweep->horizontalMax, sweep->verticalMin, sweep->verticalMax, sweep->seed);
+    }
     GuiCheckBox(LayoutCheckbox(&layout), "Show FPS", &state->showFPS);
-
-    if (state->showFPS)
-	{
-		DrawFPS(layout.controlRectXStart + layout.controlWidth / 3 * 2, state->windowHeight - TEXT_HEIGHT);
-	}
+#if PROFILER_ENABLED
+    GuiCheckBox(LayoutCheckbox(&layout), "Profiler", &state->showProfiler);
+#endif
 
     return (UIUpdateResult) {
         .renderAreaWidth = layout.controlRectXStart,
-        .shouldRegenerate = cellSizeChanged || hpChanged || vpChanged,
+        .shouldRegenerate = cellSizeChanged || lodShiftChanged || hpChanged || vpChanged,
     };
 }
+
+static UIPanelKey GetPanelKey(const AppState* state)
+{
+    UIPanelKey key;
+    memset(&key, 0, sizeof(key)); // Padding is compared too
+    key.windowWidth = state->windowWidth;
+    key.windowHeight = state->windowHeight;
+    key.cellSize = state->cellSize;
+    key.lodShift = state->lodShift;
+    key.horizontalProbability = state->horizontalProbability;
+    key.verticalProbability = state->verticalProbability;
+    key.updateSpeed = state->updateSpeed;
+    key.updateType = state->updateType;
+    key.timelineStep = state->timelineStep;
+    key.timelineStepCount = state->timeline.stepCount;
+    key.colored = state->colored;
+    key.showRegions = state->showRegions;
+    key.galleryOpen = state->galleryOpen;
+    key.showFPS = state->showFPS;
+    key.showProfiler = state->showProfiler;
+    key.disabled = GuiGetState() == STATE_DISABLED;
+    return key;
+}
+
+// The panel only reacts to input while the mouse is over it or a control holds it, every other frame
+// it shows the last drawn texture, raygui runs again only when a shown value changed
+static UIUpdateResult UpdateDrawPanel(AppState* state)
+{
+    const Rectangle bounds = { (float)(state->windowWidth - PANEL_WIDTH), 0, PANEL_WIDTH, (float)state->windowHeight };
+    const bool interacting = CheckCollisionPointRec(GetMousePosition(), bounds) || IsMouseButtonDown(MOUSE_BUTTON_LEFT) || state->updateTypeEditMode;
+
+    UIUpdateResult result = { .renderAreaWidth = (int)bounds.x, .shouldRegenerate = false };
+    const UIPanelKey key = GetPanelKey(state);
+    if (interacting)
+    {
+        state->panelCached = false;
+        result = UpdateDrawUI(state);
+    }
+    else if (!state->panelCached || memcmp(&key, &state->panelKey, sizeof(key)) != 0)
+    {
+        if (state->panelTexture.id == 0 || state->panelTexture.texture.height != state->windowHeight)
+        {
+            UnloadRenderTexture(state->panelTexture);
+            state->panelTexture = LoadRenderTexture(PANEL_WIDTH, state->windowHeight);
+        }
+
+        BeginTextureMode(state->panelTexture);
+        ClearBackground(WHITE);
+        // Alpha is accumulated as coverage so the texture stays opaque, drawing it matches drawing the controls directly
+        rlSetBlendFactorsSeparate(RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA, RL_ONE, RL_ONE_MINUS_SRC_ALPHA, RL_FUNC_ADD, RL_FUNC_ADD);
+        BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+        BeginMode2D((Camera2D){ .offset = { -bounds.x, 0.0f }, .zoom = 1.0f });
+        result = UpdateDrawUI(state);
+        EndMode2D();
+        EndBlendMode();
+        EndTextureMode();
+
+        state->panelKey = GetPanelKey(state);
+        state->panelCached = true;
+    }
+
+    if (state->panelCached)
+    {
+        const Texture2D texture = state->panelTexture.texture;
+        DrawTextureRec(texture, (Rectangle){ 0.0f, 0.0f, (float)texture.width, -(float)texture.height }, (Vector2){ bounds.x, 0.0f }, WHITE);
+    }
+
+    if (state->showFPS)
+	{
+		DrawFPS((int)bounds.x + PANEL_WIDTH / 3 * 2, state->windowHeight - TEXT_HEIGHT);
+	}
+    return result;
+}
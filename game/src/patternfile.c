@@ -0,0 +1,224 @@
+#include "patternfile.h"
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+#include "bits.h"
+#include "gamealloc.h"
+
+// NOTE: This file must not include raylib.h, windows.h clashes with it
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static uint64_t AlignOffset(uint64_t offset)
+{
+    return (offset + PATTERN_FILE_ALIGNMENT - 1) & ~(uint64_t)(PATTERN_FILE_ALIGNMENT - 1);
+}
+
+static bool MapFile(PatternFile* file, const char* fileName)
+{
+#if defined(_WIN32)
+    HANDLE fileHandle = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    HANDLE mappingHandle = GetFileSizeEx(fileHandle, &size) && size.QuadPart > 0 ? CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+    void* mapping = mappingHandle != NULL ? MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (mapping == NULL)
+    {
+        if (mappingHandle != NULL)
+        {
+            CloseHandle(mappingHandle);
+        }
+        CloseHandle(fileHandle);
+        return false;
+    }
+
+    file->mapping = mapping;
+    file->mappingSize = (size_t)size.QuadPart;
+    file->fileHandle = fileHandle;
+    file->mappingHandle = mappingHandle;
+    return true;
+#else
+    const int descriptor = open(fileName, O_RDONLY);
+    if (descriptor < 0)
+    {
+        return false;
+    }
+
+    struct stat status;
+    void* mapping = fstat(descriptor, &status) == 0 && status.st_size > 0
+        ? mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_SHARED, descriptor, 0) : MAP_FAILED;
+    close(descriptor); // The mapping keeps the file alive
+    if (mapping == MAP_FAILED)
+    {
+        return false;
+    }
+
+    file->mapping = mapping;
+    file->mappingSize = (size_t)status.st_size;
+    return true;
+#endif
+}
+
+static bool IsPlaneInside(const PatternFile* file, uint64_t offset, uint64_t size)
+{
+    return offset % PATTERN_FILE_ALIGNMENT == 0 && offset <= file->mappingSize && size <= file->mappingSize - offset;
+}
+
+static bool IsHeaderValid(const PatternFile* file)
+{
+    const PatternFileHeader* header = (const PatternFileHeader*)file->mapping;
+    if (file->mappingSize < sizeof(PatternFileHeader) || memcmp(header->magic, PATTERN_FILE_MAGIC, sizeof(PATTERN_FILE_MAGIC)) != 0
+        || header->version != PATTERN_FILE_VERSION || header->headerSize != sizeof(PatternFileHeader) || header->fileSize != file->mappingSize)
+    {
+        return false;
+    }
+
+    const uint64_t horizontalWords = BitWordCount(header->gridWidth);
+    const uint64_t verticalWords = BitWordCount(header->gridHeight);
+    if (!IsPlaneInside(file, header->horizontalOffset, horizontalWords * sizeof(uint64_t))
+        || !IsPlaneInside(file, header->verticalOffset, verticalWords * sizeof(uint64_t)))
+    {
+        return false;
+    }
+
+    return (header->flags & PATTERN_FILE_HAS_ISLANDS) == 0
+        || (header->islandsRowWords == horizontalWords && header->gridHeight <= UINT64_MAX / sizeof(uint64_t) / (horizontalWords + 1)
+            && IsPlaneInside(file, header->islandsOffset, header->gridHeight * horizontalWords * sizeof(uint64_t)));
+}
+
+bool PatternFileOpen(PatternFile* file, const char* fileName)
+{
+    memset(file, 0, sizeof(*file));
+    if (!MapFile(file, fileName))
+    {
+        return false;
+    }
+
+    if (!IsHeaderValid(file))
+    {
+        PatternFileClose(file);
+        return false;
+    }
+
+    const uint8_t* base = (const uint8_t*)file->mapping;
+    file->header = (const PatternFileHeader*)base;
+    file->horizontalBits = (const uint64_t*)(base + file->header->horizontalOffset);
+    file->verticalBits = (const uint64_t*)(base + file->header->verticalOffset);
+    file->islandBits = (file->header->flags & PATTERN_FILE_HAS_ISLANDS) != 0 ? (const uint64_t*)(base + file->header->islandsOffset) : NULL;
+    return true;
+}
+
+void PatternFileClose(PatternFile* file)
+{
+    if (file->mapping != NULL)
+    {
+#if defined(_WIN32)
+        UnmapViewOfFile(file->mapping);
+        CloseHandle(file->mappingHandle);
+        CloseHandle(file->fileHandle);
+#else
+        munmap(file->mapping, file->mappingSize);
+#endif
+    }
+    memset(file, 0, sizeof(*file));
+}
+
+static bool WritePadding(FILE* stream, uint64_t from, uint64_t to)
+{
+    static const uint8_t zeros[PATTERN_FILE_ALIGNMENT] = { 0 };
+    return to - from == 0 || fwrite(zeros, 1, (size_t)(to - from), stream) == to - from;
+}
+
+// Packs 64 stitches per word through a small buffer, so arbitrarily long sequences stream to disk
+static bool WriteBits(FILE* stream, const bool* values, uint64_t count)
+{
+    uint64_t words[512];
+    uint64_t wordCount = 0;
+    for (uint64_t i = 0; i < count; i += 64)
+    {
+        uint64_t word = 0;
+        const uint64_t end = count - i < 64 ? count - i : 64;
+        for (uint64_t bit = 0; bit < end; ++bit)
+        {
+            word |= (uint64_t)values[i + bit] << bit;
+        }
+        words[wordCount++] = word;
+        if (wordCount == sizeof(words) / sizeof(words[0]))
+        {
+            if (fwrite(words, sizeof(uint64_t), (size_t)wordCount, stream) != wordCount)
+            {
+                return false;
+            }
+            wordCount = 0;
+        }
+    }
+    return fwrite(words, sizeof(uint64_t), (size_t)wordCount, stream) == wordCount;
+}
+
+static bool WriteIslands(FILE* stream, PatternFileIslandRow islandRow, void* context, uint64_t width, uint64_t height)
+{
+    const uint64_t rowWords = BitWordCount(width);
+    uint64_t* row = (uint64_t*)GameCalloc((size_t)rowWords, sizeof(uint64_t));
+    bool written = row != NULL;
+    for (uint64_t y = 0; y < height && written; ++y)
+    {
+        islandRow(context, y, row);
+        written = fwrite(row, sizeof(uint64_t), (size_t)rowWords, stream) == rowWords;
+    }
+    free(row);
+    return written;
+}
+
+bool PatternFileSave(const char* fileName, const PatternFileHeader* parameters, const bool* horizontalSequence, const bool* verticalSequence,
+    PatternFileIslandRow islandRow, void* context)
+{
+    PatternFileHeader header = *parameters;
+    memset(header.magic, 0, sizeof(header.magic));
+    memcpy(header.magic, PATTERN_FILE_MAGIC, sizeof(PATTERN_FILE_MAGIC));
+    header.version = PATTERN_FILE_VERSION;
+    header.headerSize = sizeof(PatternFileHeader);
+    header.flags = islandRow != NULL ? PATTERN_FILE_HAS_ISLANDS : 0;
+    header.reserved = 0;
+
+    const uint64_t rowWords = BitWordCount(header.gridWidth);
+    header.horizontalOffset = PATTERN_FILE_ALIGNMENT;
+    header.verticalOffset = AlignOffset(header.horizontalOffset + rowWords * sizeof(uint64_t));
+    const uint64_t verticalEnd = header.verticalOffset + BitWordCount(header.gridHeight) * sizeof(uint64_t);
+    header.islandsOffset = islandRow != NULL ? AlignOffset(verticalEnd) : 0;
+    header.islandsRowWords = islandRow != NULL ? rowWords : 0;
+    header.fileSize = islandRow != NULL ? header.islandsOffset + header.gridHeight * rowWords * sizeof(uint64_t) : verticalEnd;
+
+    FILE* stream = fopen(fileName, "wb");
+    if (stream == NULL)
+    {
+        return false;
+    }
+
+    bool written = fwrite(&header, sizeof(header), 1, stream) == 1
+        && WritePadding(stream, sizeof(header), header.horizontalOffset)
+        && WriteBits(stream, horizontalSequence, header.gridWidth)
+        && WritePadding(stream, header.horizontalOffset + rowWords * sizeof(uint64_t), header.verticalOffset)
+        && WriteBits(stream, verticalSequence, header.gridHeight);
+    if (written && islandRow != NULL)
+    {
+        written = WritePadding(stream, verticalEnd, header.islandsOffset)
+            && WriteIslands(stream, islandRow, context, header.gridWidth, header.gridHeight);
+    }
+
+    written = fclose(stream) == 0 && written;
+    return written;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "stdbool.h"
+#include "stddef.h"
+#include "stdint.h"
+
+// Binary pattern file, little endian. The header takes the first page and every bit plane starts on
+// a page boundary, so a read-only mapping of the file is used in place without parsing or copies.
+// Sequences are bit-packed with stitch i in word i / 64, the optional island plane holds one bit per
+// cell (1 for red) with every row padded to whole words.
+#define PATTERN_FILE_MAGIC "HTMZPAT"
+#define PATTERN_FILE_VERSION 1
+#define PATTERN_FILE_ALIGNMENT 4096
+#define PATTERN_FILE_EXTENSION ".htmz"
+
+#define PATTERN_FILE_HAS_ISLANDS 0x1u
+
+typedef struct PatternFileHeader_t
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t generator; // GeneratorId the sequences came from
+    uint32_t flags;
+
+    uint64_t seed;
+    int64_t horizontalOrigin;
+    int64_t verticalOrigin;
+    uint64_t gridWidth;
+    uint64_t gridHeight;
+    float horizontalProbability;
+    float verticalProbability;
+    int32_t cellSize;
+    int32_t lodShift;
+    uint8_t horizontalFlipped;
+    uint8_t verticalFlipped;
+    uint8_t colored;
+    uint8_t originRed; // Cell (0, 0) is red
+    uint32_t reserved;
+
+    // Byte offsets from the start of the file
+    uint64_t horizontalOffset;
+    uint64_t verticalOffset;
+    uint64_t islandsOffset;
+    uint64_t islandsRowWords;
+    uint64_t fileSize;
+} PatternFileHeader;
+
+typedef struct PatternFile_t
+{
+    const PatternFileHeader* header;
+    const uint64_t* horizontalBits;
+    const uint64_t* verticalBits;
+    const uint64_t* islandBits; // NULL without PATTERN_FILE_HAS_ISLANDS
+
+    void* mapping;
+    size_t mappingSize;
+    void* fileHandle;
+    void* mappingHandle;
+} PatternFile;
+
+// Maps the file read-only and validates the header, the planes point straight into the mapping
+bool PatternFileOpen(PatternFile* file, const char* fileName);
+void PatternFileClose(PatternFile* file);
+
+// Packs island row y into islandsRowWords words, rows are asked for in order
+typedef void (*PatternFileIslandRow)(void* context, uint64_t y, uint64_t* bits);
+
+// Writes a file from unpacked sequences. Offsets and sizes of the header are filled in here, the island
+// plane is streamed row by row from islandRow (NULL for none), so it never has to be in memory as a whole.
+bool PatternFileSave(const char* fileName, const PatternFileHeader* parameters, const bool* horizontalSequence, const bool* verticalSequence,
+    PatternFileIslandRow islandRow, void* context);
@@ -0,0 +1,375 @@
+#include "patterngif.h"
+
+#include "math.h"
+#include "stdlib.h"
+#include "string.h"
+
+#include "raylib.h"
+
+#include "gamealloc.h"
+
+// Palette indices: 0 background, 1 stitch or red cell, 2 transparent (unchanged since the previous frame)
+#define GIF_LZW_MIN_CODE_SIZE 2
+#define GIF_LZW_MAX_CODE 4095
+#define GIF_TRANSPARENT_INDEX 2
+
+typedef struct LzwWriter_t
+{
+    PatternGif* gif;
+    uint32_t bits;
+    int bitCount;
+    uint8_t block[255];
+    int blockSize;
+} LzwWriter;
+
+static void Reserve(PatternGif* gif, size_t extra)
+{
+    if (gif->outputSize + extra <= gif->outputCapacity)
+    {
+        return;
+    }
+
+    const size_t grown = gif->outputCapacity + gif->outputCapacity / 2;
+    const size_t capacity = grown > gif->outputSize + extra ? grown : gif->outputSize + extra;
+    gif->output = (uint8_t*)GameGrow(gif->output, capacity);
+    gif->outputCapacity = capacity;
+}
+
+static void PutBytes(PatternGif* gif, const void* bytes, size_t size)
+{
+    Reserve(gif, size);
+    memcpy(gif->output + gif->outputSize, bytes, size);
+    gif->outputSize += size;
+}
+
+static void PutByte(PatternGif* gif, uint8_t value)
+{
+    PutBytes(gif, &value, 1);
+}
+
+static void PutShort(PatternGif* gif, int value)
+{
+    const uint8_t bytes[2] = { (uint8_t)(value & 0xff), (uint8_t)((value >> 8) & 0xff) };
+    PutBytes(gif, bytes, 2);
+}
+
+static void PutPalette(PatternGif* gif, bool colored)
+{
+    const Color background = colored ? GREEN : WHITE;
+    const Color foreground = colored ? RED : BLACK;
+    const Color colors[4] = { background, foreground, background, background };
+    for (int i = 0; i < 4; ++i)
+    {
+        const uint8_t rgb[3] = { colors[i].r, colors[i].g, colors[i].b };
+        PutBytes(gif, rgb, 3);
+    }
+}
+
+static void FlushBlock(LzwWriter* writer)
+{
+    if (writer->blockSize > 0)
+    {
+        PutByte(writer->gif, (uint8_t)writer->blockSize);
+        PutBytes(writer->gif, writer->block, writer->blockSize);
+        writer->blockSize = 0;
+    }
+}
+
+static void PutCode(LzwWriter* writer, int code, int codeSize)
+{
+    writer->bits |= (uint32_t)code << writer->bitCount;
+    writer->bitCount += codeSize;
+    while (writer->bitCount >= 8)
+    {
+        writer->block[writer->blockSize++] = (uint8_t)(writer->bits & 0xff);
+        writer->bits >>= 8;
+        writer->bitCount -= 8;
+        if (writer->blockSize == (int)sizeof(writer->block))
+        {
+            FlushBlock(writer);
+        }
+    }
+}
+
+// Codes start at 3 bits for the 4 entry palette, the dictionary is a child table per code and symbol
+static void EncodeImage(PatternGif* gif, int left, int top, int width, int height, bool transparent)
+{
+    const int clearCode = 1 << GIF_LZW_MIN_CODE_SIZE;
+    const int endCode = clearCode + 1;
+    const size_t childrenSize = (GIF_LZW_MAX_CODE + 1) * 4 * sizeof(uint16_t);
+
+    PutByte(gif, GIF_LZW_MIN_CODE_SIZE);
+    LzwWriter writer = { .gif = gif };
+    int codeSize = GIF_LZW_MIN_CODE_SIZE + 1;
+    int maxCode = endCode;
+    memset(gif->lzwChildren, 0, childrenSize);
+    PutCode(&writer, clearCode, codeSize);
+
+    int current = -1;
+    for (int y = top; y < top + height; ++y)
+    {
+        const uint8_t* row = gif->indices + (size_t)y * gif->width;
+        const uint8_t* previousRow = gif->previousIndices + (size_t)y * gif->width;
+        for (int x = left; x < left + width; ++x)
+        {
+            const int symbol = transparent && row[x] == previousRow[x] ? GIF_TRANSPARENT_INDEX : row[x];
+            if (current < 0)
+            {
+                current = symbol;
+                continue;
+            }
+
+            uint16_t* child = gif->lzwChildren + current * 4 + symbol;
+            if (*child != 0)
+            {
+                current = *child;
+                continue;
+            }
+
+            PutCode(&writer, current, codeSize);
+            *child = (uint16_t)++maxCode;
+            if (maxCode >= (1 << codeSize))
+            {
+                codeSize++;
+            }
+            if (maxCode == GIF_LZW_MAX_CODE)
+            {
+                PutCode(&writer, clearCode, codeSize);
+                memset(gif->lzwChildren, 0, childrenSize);
+                codeSize = GIF_LZW_MIN_CODE_SIZE + 1;
+                maxCode = endCode;
+            }
+            current = symbol;
+        }
+    }
+
+    // The decoder adds one more entry when reading the last code, a clear keeps both code sizes in step
+    PutCode(&writer, current, codeSize);
+    PutCode(&writer, clearCode, codeSize);
+    PutCode(&writer, endCode, GIF_LZW_MIN_CODE_SIZE + 1);
+    if (writer.bitCount > 0)
+    {
+        writer.block[writer.blockSize++] = (uint8_t)(writer.bits & 0xff);
+    }
+    FlushBlock(&writer);
+    PutByte(gif, 0);
+}
+
+// Same closed form as the LOD texture: a cell is red when its column term differs from its row term
+static void RenderColored(PatternGif* gif, const PatternFrame* frame, int columns, int rows)
+{
+    bool parity = false;
+    for (int x = 0; x < columns; ++x)
+    {
+        if (x > 0)
+        {
+            parity ^= frame->horizontalSequence[x];
+        }
+        gif->columnTerms[x] = (uint8_t)((parity ^ (x & 1)) | (parity << 1));
+    }
+
+    const int cellPixels = gif->pixelsPerCell;
+    const bool originRed = frame->originIsland == 2;
+    parity = false;
+    for (int y = 0; y < rows; ++y)
+    {
+        if (y > 0)
+        {
+            parity ^= frame->verticalSequence[y];
+        }
+        const int yOdd = y & 1;
+        const uint8_t rowTerm = (uint8_t)(yOdd ^ parity ^ originRed);
+        uint8_t* line = gif->indices + (size_t)y * cellPixels * gif->width;
+        for (int x = 0; x < columns; ++x)
+        {
+            memset(line + x * cellPixels, ((gif->columnTerms[x] >> yOdd) & 1) ^ rowTerm, cellPixels);
+        }
+        for (int i = 1; i < cellPixels; ++i)
+        {
+            memcpy(line + (size_t)i * gif->width, line, (size_t)columns * cellPixels);
+        }
+    }
+}
+
+// Column x has vertical stitches on rows of parity h[x], row y horizontal ones on columns of parity v[y]
+static void RenderStitches(PatternGif* gif, const PatternFrame* frame, int columns, int rows)
+{
+    const int cellPixels = gif->pixelsPerCell;
+    for (int x = 0; x < columns; ++x)
+    {
+        uint8_t* pixel = gif->indices + (size_t)x * cellPixels;
+        for (int y = frame->horizontalSequence[x]; y < rows; y += 2)
+        {
+            for (int i = 0; i < cellPixels; ++i)
+            {
+                pixel[((size_t)y * cellPixels + i) * gif->width] = 1;
+            }
+        }
+    }
+
+    for (int y = 0; y < rows; ++y)
+    {
+        uint8_t* line = gif->indices + (size_t)y * cellPixels * gif->width;
+        for (int x = frame->verticalSequence[y]; x < columns; x += 2)
+        {
+            memset(line + x * cellPixels, 1, cellPixels);
+        }
+    }
+}
+
+// Bounding rectangle of the pixels that differ from the previous frame, returns the number of such pixels
+static size_t FindChangedRect(const PatternGif* gif, int* left, int* top, int* right, int* bottom)
+{
+    size_t changed = 0;
+    *left = gif->width;
+    *top = gif->height;
+    *right = -1;
+    *bottom = -1;
+    for (int y = 0; y < gif->height; ++y)
+    {
+        const uint8_t* row = gif->indices + (size_t)y * gif->width;
+        const uint8_t* previousRow = gif->previousIndices + (size_t)y * gif->width;
+        if (memcmp(row, previousRow, gif->width) == 0)
+        {
+            continue;
+        }
+
+        for (int x = 0; x < gif->width; ++x)
+        {
+            if (row[x] != previousRow[x])
+            {
+                changed++;
+                *left = x < *left ? x : *left;
+                *right = x > *right ? x : *right;
+            }
+        }
+        *top = y < *top ? y : *top;
+        *bottom = y;
+    }
+    return changed;
+}
+
+static void PatchLastDelay(PatternGif* gif, double time)
+{
+    const int64_t centiseconds = (int64_t)llround(time * 100.0);
+    if (gif->frameCount > 0)
+    {
+        int64_t delay = centiseconds - gif->lastFrameCentiseconds;
+        delay = delay < 0 ? 0 : (delay > 0xffff ? 0xffff : delay);
+        gif->output[gif->delayOffset] = (uint8_t)(delay & 0xff);
+        gif->output[gif->delayOffset + 1] = (uint8_t)(delay >> 8);
+    }
+    gif->lastFrameCentiseconds = centiseconds;
+}
+
+bool PatternGifBegin(PatternGif* gif, int columns, int rows, int pixelsPerCell, double time)
+{
+    const int width = columns * pixelsPerCell;
+    const int height = rows * pixelsPerCell;
+    if (columns <= 0 || rows <= 0 || pixelsPerCell <= 0 || width > PATTERN_GIF_MAX_SIDE || height > PATTERN_GIF_MAX_SIDE)
+    {
+        return false;
+    }
+
+    *gif = (PatternGif){
+        .columns = columns,
+        .rows = rows,
+        .pixelsPerCell = pixelsPerCell,
+        .width = width,
+        .height = height,
+        .indices = (uint8_t*)GameAlloc((size_t)width * height),
+        .previousIndices = (uint8_t*)GameAlloc((size_t)width * height),
+        .columnTerms = (uint8_t*)GameAlloc(columns),
+        .lzwChildren = (uint16_t*)GameAlloc((GIF_LZW_MAX_CODE + 1) * 4 * sizeof(uint16_t)),
+        .lastFrameCentiseconds = (int64_t)llround(time * 100.0),
+    };
+
+    PutBytes(gif, "GIF89a", 6);
+    PutShort(gif, width);
+    PutShort(gif, height);
+    PutByte(gif, 0x91); // Global color table of 4 entries, 2 bits of color resolution
+    PutByte(gif, 0);
+    PutByte(gif, 0);
+    PutPalette(gif, false);
+
+    // Loop forever
+    PutBytes(gif, "\x21\xff\x0bNETSCAPE2.0\x03\x01\x00\x00\x00", 19);
+    return true;
+}
+
+void PatternGifAddFrame(PatternGif* gif, const PatternFrame* frame, double time)
+{
+    const int columns = frame->gridWidth < gif->columns ? frame->gridWidth : gif->columns;
+    const int rows = frame->gridHeight < gif->rows ? frame->gridHeight : gif->rows;
+    memset(gif->indices, 0, (size_t)gif->width * gif->height);
+    if (frame->colored)
+    {
+        RenderColored(gif, frame, columns, rows);
+    }
+    else
+    {
+        RenderStitches(gif, frame, columns, rows);
+    }
+
+    int left = 0;
+    int top = 0;
+    int right = gif->width - 1;
+    int bottom = gif->height - 1;
+    bool transparent = false;
+    if (gif->hasPrevious && gif->previousColored == frame->colored)
+    {
+        const size_t changed = FindChangedRect(gif, &left, &top, &right, &bottom);
+        if (changed == 0)
+        {
+            return;
+        }
+
+        // Marking kept pixels transparent only pays off when they make up most of the rectangle
+        transparent = changed * 2 < (size_t)(right - left + 1) * (bottom - top + 1);
+    }
+
+    PatchLastDelay(gif, time);
+
+    // Graphic control: keep the previous frame under this one
+    PutBytes(gif, "\x21\xf9\x04", 3);
+    PutByte(gif, (1 << 2) | (transparent ? 1 : 0));
+    gif->delayOffset = gif->outputSize;
+    PutShort(gif, 0);
+    PutByte(gif, GIF_TRANSPARENT_INDEX);
+    PutByte(gif, 0);
+
+    PutByte(gif, 0x2c);
+    PutShort(gif, left);
+    PutShort(gif, top);
+    PutShort(gif, right - left + 1);
+    PutShort(gif, bottom - top + 1);
+    PutByte(gif, 0x81); // Local color table of 4 entries
+    PutPalette(gif, frame->colored);
+    EncodeImage(gif, left, top, right - left + 1, bottom - top + 1, transparent);
+
+    uint8_t* swap = gif->previousIndices;
+    gif->previousIndices = gif->indices;
+    gif->indices = swap;
+    gif->hasPrevious = true;
+    gif->previousColored = frame->colored;
+    gif->frameCount++;
+}
+
+bool PatternGifEnd(PatternGif* gif, const char* fileName, double time)
+{
+    bool saved = false;
+    if (gif->frameCount > 0)
+    {
+        PatchLastDelay(gif, time);
+        PutByte(gif, 0x3b);
+        saved = SaveFileData(fileName, gif->output, (int)gif->outputSize);
+    }
+
+    free(gif->indices);
+    free(gif->previousIndices);
+    free(gif->columnTerms);
+    free(gif->lzwChildren);
+    free(gif->output);
+    *gif = (PatternGif){ 0 };
+    return saved;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "stdbool.h"
+#include "stddef.h"
+#include "stdint.h"
+
+// GIF recorder that encodes straight from the sequences instead of screen pixels. Frames only
+// ever hold two colors, so every frame is a 2-bit LZW stream over a fixed palette, cropped to the
+// rectangle that changed since the previous frame. Unchanged frames cost nothing, their time is
+// added to the delay of the frame before.
+#define PATTERN_GIF_MAX_SIDE 4096
+
+typedef struct PatternFrame_t
+{
+    const bool* horizontalSequence;
+    int gridWidth;
+    const bool* verticalSequence;
+    int gridHeight;
+    bool colored;
+    int originIsland; // Island of cell (0, 0), 2 or 4
+} PatternFrame;
+
+typedef struct PatternGif_t
+{
+    int columns;
+    int rows;
+    int pixelsPerCell; // 1 only makes sense for colored patterns, stitches need at least 2
+    int width;
+    int height;
+
+    uint8_t* indices;
+    uint8_t* previousIndices;
+    uint8_t* columnTerms; // Per column, bit 0 for even rows and bit 1 for odd rows
+    uint16_t* lzwChildren;
+    bool hasPrevious;
+    bool previousColored;
+
+    uint8_t* output;
+    size_t outputSize;
+    size_t outputCapacity;
+    size_t delayOffset; // Delay field of the last written frame, patched once the next frame shows up
+    int64_t lastFrameCentiseconds;
+    int frameCount;
+} PatternGif;
+
+bool PatternGifBegin(PatternGif* gif, int columns, int rows, int pixelsPerCell, double time);
+void PatternGifAddFrame(PatternGif* gif, const PatternFrame* frame, double time); // Frames identical to the previous one are skipped
+bool PatternGifEnd(PatternGif* gif, const char* fileName, double time); // Writes the file and frees everything
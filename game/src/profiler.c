@@ -0,0 +1,178 @@
+#include "profiler.h"
+
+#if PROFILER_ENABLED
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+#include "raylib.h"
+#include "rlgl.h"
+#include "timer.h"
+
+typedef struct ProfilerFrame_t
+{
+    uint64_t phaseNs[PROFILE_PHASE_COUNT];
+    uint64_t totalNs;
+    int drawCalls;
+    int vertexCount;
+} ProfilerFrame;
+
+typedef struct Profiler_t
+{
+    ProfilerFrame frames[PROFILER_FRAME_COUNT]; // Ring buffer, frameIndex points at the oldest entry
+    int frameIndex;
+    int frameCount;
+
+    ProfilerFrame current;
+    uint64_t phaseStartNs[PROFILE_PHASE_COUNT];
+} Profiler;
+
+static Profiler profiler = { 0 };
+
+static const char* phaseNames[PROFILE_PHASE_COUNT] = {
+    "Sequences",
+    "Fill",
+    "Pattern",
+    "UI",
+    "EndDrawing",
+};
+
+static const Color phaseColors[PROFILE_PHASE_COUNT] = {
+    { 0, 121, 241, 255 },   // BLUE
+    { 255, 161, 0, 255 },   // ORANGE
+    { 0, 158, 47, 255 },    // LIME
+    { 200, 122, 255, 255 }, // PURPLE
+    { 130, 130, 130, 255 }, // GRAY
+};
+
+void ProfilerBeginPhase(ProfilePhase phase)
+{
+    profiler.phaseStartNs[phase] = GetMonotonicTimeNs();
+}
+
+void ProfilerEndPhase(ProfilePhase phase)
+{
+    // Phases may run several times per frame (e.g. a fill on tick and another on regenerate), so accumulate
+    profiler.current.phaseNs[phase] += GetMonotonicTimeNs() - profiler.phaseStartNs[phase];
+}
+
+void ProfilerEndFrame(void)
+{
+    const rlRenderStats stats = rlGetRenderStats();
+    rlResetRenderStats();
+
+    profiler.current.drawCalls = stats.drawCalls;
+    profiler.current.vertexCount = stats.vertexCount;
+    profiler.current.totalNs = 0;
+    for (int i = 0; i < PROFILE_PHASE_COUNT; ++i)
+    {
+        profiler.current.totalNs += profiler.current.phaseNs[i];
+    }
+
+    const int slot = (profiler.frameIndex + profiler.frameCount) % PROFILER_FRAME_COUNT;
+    profiler.frames[slot] = profiler.current;
+    if (profiler.frameCount < PROFILER_FRAME_COUNT)
+    {
+        profiler.frameCount++;
+    }
+    else
+    {
+        profiler.frameIndex = (profiler.frameIndex + 1) % PROFILER_FRAME_COUNT;
+    }
+
+    memset(&profiler.current, 0, sizeof(profiler.current));
+}
+
+static int CompareU64(const void* a, const void* b)
+{
+    const uint64_t lhs = *(const uint64_t*)a;
+    const uint64_t rhs = *(const uint64_t*)b;
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+static float NsToMs(uint64_t ns) { return (float)((double)ns / 1000000.0); }
+
+void ProfilerDrawOverlay(int x, int y, int width, int height)
+{
+    if (profiler.frameCount == 0)
+    {
+        return;
+    }
+
+    DrawRectangle(x, y, width, height, Fade(BLACK, 0.75f));
+
+    // Per phase averages and min/avg/p99 of the whole frame
+    uint64_t sorted[PROFILER_FRAME_COUNT];
+    uint64_t phaseSums[PROFILE_PHASE_COUNT] = { 0 };
+    uint64_t totalSum = 0;
+    for (int i = 0; i < profiler.frameCount; ++i)
+    {
+        const ProfilerFrame* frame = &profiler.frames[(profiler.frameIndex + i) % PROFILER_FRAME_COUNT];
+        sorted[i] = frame->totalNs;
+        totalSum += frame->totalNs;
+        for (int phase = 0; phase < PROFILE_PHASE_COUNT; ++phase)
+        {
+            phaseSums[phase] += frame->phaseNs[phase];
+        }
+    }
+    qsort(sorted, profiler.frameCount, sizeof(uint64_t), CompareU64);
+    const int p99Index = (profiler.frameCount * 99 - 1) / 100;
+
+    const int fontSize = 10;
+    const int padding = 4;
+    char text[128];
+    int textY = y + padding;
+    snprintf(text, sizeof(text), "frame ms  min %.2f  avg %.2f  p99 %.2f",
+        NsToMs(sorted[0]), NsToMs(totalSum / profiler.frameCount), NsToMs(sorted[p99Index]));
+    DrawText(text, x + padding, textY, fontSize, WHITE);
+    textY += fontSize + 2;
+
+    const ProfilerFrame* last = &profiler.frames[(profiler.frameIndex + profiler.frameCount - 1) % PROFILER_FRAME_COUNT];
+    snprintf(text, sizeof(text), "draw calls %d  vertices %d", last->drawCalls, last->vertexCount);
+    DrawText(text, x + padding, textY, fontSize, WHITE);
+    textY += fontSize + 2;
+
+    int legendX = x + padding;
+    for (int phase = 0; phase < PROFILE_PHASE_COUNT; ++phase)
+    {
+        snprintf(text, sizeof(text), "%s %.2f", phaseNames[phase], NsToMs(phaseSums[phase] / profiler.frameCount));
+        DrawRectangle(legendX, textY + 2, fontSize - 4, fontSize - 4, phaseColors[phase]);
+        DrawText(text, legendX + fontSize, textY, fontSize, WHITE);
+        legendX += fontSize + MeasureText(text, fontSize) + padding * 2;
+    }
+    textY += fontSize + padding;
+
+    // Stacked bars, full graph height is two 60 FPS frames
+    const double graphScaleNs = 2.0 * 1000000000.0 / 60.0;
+    const int graphTop = textY;
+    const int graphHeight = y + height - padding - graphTop;
+    const int graphBottom = graphTop + graphHeight;
+    const float barWidth = (float)(width - padding * 2) / PROFILER_FRAME_COUNT;
+    if (graphHeight <= 0)
+    {
+        return;
+    }
+
+    const int budgetY = graphBottom - (int)(graphHeight * (1000000000.0 / 60.0) / graphScaleNs);
+    DrawLine(x + padding, budgetY, x + width - padding, budgetY, Fade(WHITE, 0.5f));
+
+    for (int i = 0; i < profiler.frameCount; ++i)
+    {
+        const ProfilerFrame* frame = &profiler.frames[(profiler.frameIndex + i) % PROFILER_FRAME_COUNT];
+        const float barX = x + padding + i * barWidth;
+        float barY = (float)graphBottom;
+        for (int phase = 0; phase < PROFILE_PHASE_COUNT; ++phase)
+        {
+            float barHeight = (float)(graphHeight * (frame->phaseNs[phase] / graphScaleNs));
+            if (barY - barHeight < graphTop)
+            {
+                barHeight = barY - graphTop;
+            }
+            barY -= barHeight;
+            DrawRectangleRec((Rectangle){ barX, barY, barWidth, barHeight }, phaseColors[phase]);
+        }
+    }
+}
+
+#endif
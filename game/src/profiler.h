@@ -0,0 +1,43 @@
+#pragma once
+
+#include "stdint.h"
+
+// Frame profiler, only compiled into Debug builds
+#if defined(DEBUG) && !defined(NDEBUG)
+#define PROFILER_ENABLED 1
+#else
+#define PROFILER_ENABLED 0
+#endif
+
+#define PROFILER_FRAME_COUNT 120
+
+typedef enum
+{
+    PROFILE_PHASE_SEQUENCE_UPDATE,
+    PROFILE_PHASE_FILL,
+    PROFILE_PHASE_PATTERN_DRAW,
+    PROFILE_PHASE_UI,
+    PROFILE_PHASE_END_DRAWING,
+    PROFILE_PHASE_COUNT,
+} ProfilePhase;
+
+#if PROFILER_ENABLED
+
+void ProfilerBeginPhase(ProfilePhase phase);
+void ProfilerEndPhase(ProfilePhase phase);
+void ProfilerEndFrame(void); // Call after EndDrawing(), also collects rlgl batch statistics
+void ProfilerDrawOverlay(int x, int y, int width, int height);
+
+#define PROFILE_BEGIN(phase) ProfilerBeginPhase(phase)
+#define PROFILE_END(phase) ProfilerEndPhase(phase)
+#define PROFILE_END_FRAME() ProfilerEndFrame()
+#define PROFILE_DRAW_OVERLAY(x, y, width, height) ProfilerDrawOverlay(x, y, width, height)
+
+#else
+
+#define PROFILE_BEGIN(phase) ((void)0)
+#define PROFILE_END(phase) ((void)0)
+#define PROFILE_END_FRAME() ((void)0)
+#define PROFILE_DRAW_OVERLAY(x, y, width, height) ((void)0)
+
+#endif
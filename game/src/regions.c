@@ -0,0 +1,300 @@
+#include "regions.h"
+
+#include "stdlib.h"
+#include "string.h"
+
+#include "gamealloc.h"
+
+static int Find(int* parents, int i)
+{
+    while (parents[i] != i)
+    {
+        parents[i] = parents[parents[i]];
+        i = parents[i];
+    }
+    return i;
+}
+
+// Roots are always the earlier run, so a stripe only ever links runs of its own rows
+static void Union(int* parents, int a, int b)
+{
+    a = Find(parents, a);
+    b = Find(parents, b);
+    if (a < b) parents[b] = a;
+    else if (b < a) parents[a] = b;
+}
+
+static const int* RowRuns(const RegionLabels* labels, int parity)
+{
+    return labels->rowRunStarts + (parity == 0 ? 0 : labels->gridWidth);
+}
+
+static int RunEnd(const RegionLabels* labels, int parity, int run)
+{
+    return run + 1 < labels->rowRunCounts[parity] ? RowRuns(labels, parity)[run + 1] : labels->gridWidth;
+}
+
+static size_t FirstRun(const RegionLabels* labels, int y)
+{
+    return (size_t)(y >> 1) * (labels->rowRunCounts[0] + labels->rowRunCounts[1]) + ((y & 1) == 1 ? labels->rowRunCounts[0] : 0);
+}
+
+// Column line x has a stitch next to the cells of row y when (y & 1) == h[x], every stitch starts a run
+static void LayOutRuns(RegionLabels* labels, const bool* horizontalSequence)
+{
+    for (int parity = 0; parity < 2; ++parity)
+    {
+        int* starts = labels->rowRunStarts + (parity == 0 ? 0 : labels->gridWidth);
+        int count = 0;
+        for (int x = 0; x < labels->gridWidth; ++x)
+        {
+            if (x == 0 || horizontalSequence[x] == (parity == 1))
+            {
+                starts[count++] = x;
+            }
+        }
+        labels->rowRunCounts[parity] = count;
+    }
+}
+
+// Cells (x, y - 1) and (x, y) are joined unless row line y has a stitch above x, which is when (x & 1) == v[y]
+static void LayOutJoins(RegionLabels* labels)
+{
+    for (int combination = 0; combination < 4; ++combination)
+    {
+        const int parity = combination >> 1;
+        const bool stitchParity = (combination & 1) == 1;
+        const int aboveParity = parity ^ 1;
+        int* joins = labels->joins + (size_t)combination * 2 * labels->gridWidth;
+        int count = 0;
+        int above = 0;
+        int run = 0;
+        while (above < labels->rowRunCounts[aboveParity] && run < labels->rowRunCounts[parity])
+        {
+            const int aboveStart = RowRuns(labels, aboveParity)[above];
+            const int aboveEnd = RunEnd(labels, aboveParity, above);
+            const int runStart = RowRuns(labels, parity)[run];
+            const int runEnd = RunEnd(labels, parity, run);
+            const int overlapStart = aboveStart > runStart ? aboveStart : runStart;
+            const int overlapEnd = aboveEnd < runEnd ? aboveEnd : runEnd;
+            if (overlapEnd - overlapStart >= 2 || (overlapEnd - overlapStart == 1 && ((overlapStart & 1) == 1) != stitchParity))
+            {
+                joins[2 * count] = above;
+                joins[2 * count + 1] = run;
+                count++;
+            }
+            if (aboveEnd <= runEnd) above++;
+            if (runEnd <= aboveEnd) run++;
+        }
+        labels->joinCounts[combination] = count;
+    }
+}
+
+static void JoinRows(RegionLabels* labels, int y)
+{
+    const int combination = ((y & 1) << 1) | (labels->verticalSequence[y] ? 1 : 0);
+    const int* joins = labels->joins + (size_t)combination * 2 * labels->gridWidth;
+    const int aboveFirst = (int)FirstRun(labels, y - 1);
+    const int first = (int)FirstRun(labels, y);
+    for (int i = 0; i < labels->joinCounts[combination]; ++i)
+    {
+        Union(labels->runParents, aboveFirst + joins[2 * i], first + joins[2 * i + 1]);
+    }
+}
+
+static void StripeRows(const RegionLabels* labels, int stripe, int* yStart, int* yEnd)
+{
+    *yStart = (int)((long long)labels->gridHeight * stripe / labels->stripeCount);
+    *yEnd = (int)((long long)labels->gridHeight * (stripe + 1) / labels->stripeCount);
+}
+
+static void LabelStripe(void* context, int stripe, int threadIndex)
+{
+    (void)threadIndex;
+    RegionLabels* labels = (RegionLabels*)context;
+    int yStart;
+    int yEnd;
+    StripeRows(labels, stripe, &yStart, &yEnd);
+    const size_t runEnd = FirstRun(labels, yEnd);
+    for (size_t run = FirstRun(labels, yStart); run < runEnd; ++run)
+    {
+        labels->runParents[run] = (int)run;
+        labels->runIds[run] = -1;
+    }
+    for (int y = yStart + 1; y < yEnd; ++y)
+    {
+        JoinRows(labels, y);
+    }
+}
+
+static void FillStripe(void* context, int stripe, int threadIndex)
+{
+    (void)threadIndex;
+    RegionLabels* labels = (RegionLabels*)context;
+    int yStart;
+    int yEnd;
+    StripeRows(labels, stripe, &yStart, &yEnd);
+    for (int y = yStart; y < yEnd; ++y)
+    {
+        const int parity = y & 1;
+        const int* starts = RowRuns(labels, parity);
+        const int* ids = labels->runIds + FirstRun(labels, y);
+        int* row = labels->labels + (size_t)y * labels->gridWidth;
+        for (int run = 0; run < labels->rowRunCounts[parity]; ++run)
+        {
+            const int id = ids[run];
+            const int end = RunEnd(labels, parity, run);
+            for (int x = starts[run]; x < end; ++x)
+            {
+                row[x] = id;
+            }
+        }
+    }
+}
+
+static bool RunStripes(RegionLabels* labels, WorkPoolJob job)
+{
+    if (labels->stripeCount == 1)
+    {
+        job(labels, 0, 0);
+        return true;
+    }
+
+    WorkPool pool;
+    if (!WorkPoolStart(&pool, labels->stripeCount, labels->stripeCount, job, labels))
+    {
+        return false;
+    }
+    WorkPoolWait(&pool, false);
+    return true;
+}
+
+static bool GrowInts(int** buffer, size_t* capacity, size_t required)
+{
+    if (required <= *capacity)
+    {
+        return true;
+    }
+    const size_t grown = *capacity + *capacity / 2;
+    const size_t size = grown > required ? grown : required;
+    int* grownBuffer = (int*)GameGrow(*buffer, size * sizeof(int));
+    if (grownBuffer == NULL)
+    {
+        return false;
+    }
+    *buffer = grownBuffer;
+    *capacity = size;
+    return true;
+}
+
+static bool PushRegion(RegionLabels* labels, int x, int y)
+{
+    if (labels->regionCount == labels->regionCapacity)
+    {
+        const int grown = labels->regionCapacity + labels->regionCapacity / 2;
+        const int capacity = grown > 1024 ? grown : 1024;
+        RegionInfo* regions = (RegionInfo*)GameGrow(labels->regions, capacity * sizeof(RegionInfo));
+        if (regions == NULL)
+        {
+            return false;
+        }
+        labels->regions = regions;
+        labels->regionCapacity = capacity;
+    }
+    labels->regions[labels->regionCount++] = (RegionInfo){ 0, x, y, x, y };
+    return true;
+}
+
+bool RegionLabel(RegionLabels* labels, const bool* horizontalSequence, int gridWidth, const bool* verticalSequence, int gridHeight)
+{
+    labels->regionCount = 0;
+    labels->gridWidth = 0;
+    labels->gridHeight = 0;
+    const size_t cellCount = (size_t)gridWidth * gridHeight;
+    if (gridWidth <= 0 || gridHeight <= 0 || !GrowInts(&labels->labels, &labels->cellCapacity, cellCount)
+        || !GrowInts(&labels->rowRunStarts, &labels->rowRunCapacity, 2 * (size_t)gridWidth)
+        || !GrowInts(&labels->joins, &labels->joinCapacity, 8 * (size_t)gridWidth))
+    {
+        return false;
+    }
+
+    labels->verticalSequence = verticalSequence;
+    labels->gridWidth = gridWidth;
+    labels->gridHeight = gridHeight;
+    LayOutRuns(labels, horizontalSequence);
+    LayOutJoins(labels);
+    const size_t runCount = FirstRun(labels, gridHeight);
+    if (!GrowInts(&labels->runParents, &labels->runParentCapacity, runCount) || !GrowInts(&labels->runIds, &labels->runIdCapacity, runCount))
+    {
+        labels->gridWidth = 0;
+        labels->gridHeight = 0;
+        return false;
+    }
+
+    const int threadCount = cellCount >= REGION_PARALLEL_MIN_CELLS ? WorkPoolDefaultThreadCount() : 1;
+    labels->stripeCount = threadCount < gridHeight ? threadCount : gridHeight;
+    if (!RunStripes(labels, LabelStripe))
+    {
+        return false;
+    }
+    for (int stripe = 1; stripe < labels->stripeCount; ++stripe)
+    {
+        int yStart;
+        int yEnd;
+        StripeRows(labels, stripe, &yStart, &yEnd);
+        JoinRows(labels, yStart);
+    }
+
+    // Regions are numbered by their first run, which makes the ids independent of the stripe count
+    for (int y = 0; y < gridHeight; ++y)
+    {
+        const int parity = y & 1;
+        const int* starts = RowRuns(labels, parity);
+        const int first = (int)FirstRun(labels, y);
+        for (int run = 0; run < labels->rowRunCounts[parity]; ++run)
+        {
+            const int root = Find(labels->runParents, first + run);
+            const int start = starts[run];
+            const int end = RunEnd(labels, parity, run);
+            if (labels->runIds[root] < 0)
+            {
+                if (!PushRegion(labels, start, y))
+                {
+                    labels->regionCount = 0;
+                    return false;
+                }
+                labels->runIds[root] = labels->regionCount - 1;
+            }
+
+            const int id = labels->runIds[root];
+            labels->runIds[first + run] = id;
+            RegionInfo* region = &labels->regions[id];
+            region->area += end - start;
+            region->minX = start < region->minX ? start : region->minX;
+            region->maxX = end - 1 > region->maxX ? end - 1 : region->maxX;
+            region->maxY = y;
+        }
+    }
+
+    return RunStripes(labels, FillStripe);
+}
+
+int RegionAt(const RegionLabels* labels, int x, int y)
+{
+    if (x < 0 || y < 0 || x >= labels->gridWidth || y >= labels->gridHeight || labels->regionCount == 0)
+    {
+        return -1;
+    }
+    return labels->labels[(size_t)y * labels->gridWidth + x];
+}
+
+void RegionRelease(RegionLabels* labels)
+{
+    free(labels->labels);
+    free(labels->regions);
+    free(labels->rowRunStarts);
+    free(labels->joins);
+    free(labels->runParents);
+    free(labels->runIds);
+    memset(labels, 0, sizeof(*labels));
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "stdbool.h"
+#include "stddef.h"
+
+#include "workpool.h"
+
+// Connected-component labeling of the enclosed regions. Cells of a row form runs between the vertical
+// stitches, runs that touch the row above through a gap in the horizontal stitches are joined with
+// union-find, so the work is per run rather than per cell. The runs of a row only depend on its parity and
+// the joins between two rows only on the parity and the stitch of the lower row, so both are laid out once
+// per labeling. Grids of REGION_PARALLEL_MIN_CELLS and more are cut into horizontal stripes that are labeled
+// in parallel and merged along the stripe borders.
+#define REGION_PARALLEL_MIN_CELLS (1 << 20)
+
+typedef struct RegionInfo_t
+{
+    int area; // Cells
+    int minX;
+    int minY;
+    int maxX; // Inclusive
+    int maxY;
+} RegionInfo;
+
+typedef struct RegionLabels_t
+{
+    int* labels; // Region of every cell, row-major, numbered from 0 in scan order
+    RegionInfo* regions;
+    int regionCount;
+    int gridWidth;
+    int gridHeight;
+
+    // Scratch, kept for the next labeling
+    const bool* verticalSequence;
+    int* rowRunStarts;   // Run starts of an even row, then of an odd row
+    int rowRunCounts[2];
+    int* joins;          // Pairs of (run above, run) for the 4 combinations of row parity and stitch
+    int joinCounts[4];
+    int* runParents;
+    int* runIds;
+    size_t cellCapacity;
+    size_t rowRunCapacity;
+    size_t joinCapacity;
+    size_t runParentCapacity;
+    size_t runIdCapacity;
+    int regionCapacity;
+    int stripeCount;
+} RegionLabels;
+
+bool RegionLabel(RegionLabels* labels, const bool* horizontalSequence, int gridWidth, const bool* verticalSequence, int gridHeight);
+int RegionAt(const RegionLabels* labels, int x, int y); // -1 outside the grid
+void RegionRelease(RegionLabels* labels);
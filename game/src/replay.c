@@ -0,0 +1,350 @@
+#include "replay.h"
+
+#include "stdlib.h"
+#include "string.h"
+
+#include "bits.h"
+#include "gamealloc.h"
+
+static void PutBits(ReplayWriter* writer, uint64_t value, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        writer->bits |= ((value >> i) & 1) << writer->bitCount;
+        if (++writer->bitCount == 8)
+        {
+            fputc((int)writer->bits, writer->file);
+            writer->bits = 0;
+            writer->bitCount = 0;
+        }
+    }
+}
+
+// Elias gamma code of value >= 1: the bit length minus one in zeros, then the value from its top bit down
+static void PutGamma(ReplayWriter* writer, uint64_t value)
+{
+    int length = 0;
+    while (length < 64 && (value >> length) > 1)
+    {
+        length++;
+    }
+    PutBits(writer, 0, length);
+    for (int i = length; i >= 0; --i)
+    {
+        PutBits(writer, value >> i, 1);
+    }
+}
+
+static uint64_t ZigZag(int64_t value)
+{
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static int64_t UnZigZag(uint64_t value)
+{
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+static bool IsParameterFloat(int parameter)
+{
+    return parameter == REPLAY_PARAMETER_HORIZONTAL_PROBABILITY || parameter == REPLAY_PARAMETER_VERTICAL_PROBABILITY;
+}
+
+static void WriteSequence(FILE* file, const bool* sequence, int length)
+{
+    for (int i = 0; i < length; i += 64)
+    {
+        uint64_t word = 0;
+        for (int bit = 0; bit < 64 && i + bit < length; ++bit)
+        {
+            word |= (uint64_t)sequence[i + bit] << bit;
+        }
+        fwrite(&word, sizeof(word), 1, file);
+    }
+}
+
+bool ReplayBeginRecording(ReplayWriter* writer, const char* fileName, const ReplayHeader* initial, const bool* horizontalSequence, const bool* verticalSequence)
+{
+    memset(writer, 0, sizeof(*writer));
+    writer->file = fopen(fileName, "wb");
+    if (writer->file == NULL)
+    {
+        return false;
+    }
+
+    ReplayHeader header = *initial;
+    memset(header.magic, 0, sizeof(header.magic));
+    memcpy(header.magic, REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+    header.version = REPLAY_VERSION;
+    header.headerSize = sizeof(ReplayHeader);
+    fwrite(&header, sizeof(header), 1, writer->file);
+    WriteSequence(writer->file, horizontalSequence, header.gridWidth);
+    WriteSequence(writer->file, verticalSequence, header.gridHeight);
+
+    memcpy(writer->parameters, header.parameters, sizeof(writer->parameters));
+    return true;
+}
+
+void ReplayWriteEvent(ReplayWriter* writer, const ReplayEvent* event)
+{
+    PutBits(writer, (uint64_t)event->type, 3);
+    writer->eventCount++;
+    if (event->type == REPLAY_EVENT_END)
+    {
+        return;
+    }
+
+    const int64_t delta = (int64_t)(event->frame - writer->lastFrame);
+    PutGamma(writer, ZigZag(delta - writer->lastDelta) + 1);
+    writer->lastFrame = event->frame;
+    writer->lastDelta = delta;
+
+    switch (event->type)
+    {
+    case REPLAY_EVENT_TICK:
+        // Grid size flag, only set when a timed regeneration follows the window to a new size
+        PutBits(writer, event->gridWidth != 0, 1);
+        if (event->gridWidth != 0)
+        {
+            PutGamma(writer, (uint64_t)event->gridWidth + 1);
+            PutGamma(writer, (uint64_t)event->gridHeight + 1);
+        }
+        break;
+    case REPLAY_EVENT_REGENERATE:
+    case REPLAY_EVENT_RESIZE:
+        PutGamma(writer, (uint64_t)event->gridWidth + 1);
+        PutGamma(writer, (uint64_t)event->gridHeight + 1);
+        break;
+    case REPLAY_EVENT_PARAMETER:
+        PutBits(writer, (uint64_t)event->parameter, 3);
+        if (IsParameterFloat(event->parameter))
+        {
+            PutBits(writer, event->value, 32);
+        }
+        else
+        {
+            PutGamma(writer, (uint64_t)event->value + 1);
+        }
+        writer->parameters[event->parameter] = event->value;
+        break;
+    }
+}
+
+void ReplayWriteParameter(ReplayWriter* writer, uint64_t frame, ReplayParameter parameter, uint32_t value)
+{
+    if (writer->parameters[parameter] != value)
+    {
+        const ReplayEvent event = { .type = REPLAY_EVENT_PARAMETER, .frame = frame, .parameter = parameter, .value = value };
+        ReplayWriteEvent(writer, &event);
+    }
+}
+
+bool ReplayEndRecording(ReplayWriter* writer)
+{
+    const ReplayEvent end = { .type = REPLAY_EVENT_END };
+    ReplayWriteEvent(writer, &end);
+    if (writer->bitCount > 0)
+    {
+        fputc((int)writer->bits, writer->file);
+    }
+
+    const bool written = ferror(writer->file) == 0;
+    const bool closed = fclose(writer->file) == 0;
+    writer->file = NULL;
+    return written && closed;
+}
+
+static bool GetBit(ReplayReader* reader, bool* bit)
+{
+    if (reader->bitPosition >= reader->streamSize * 8)
+    {
+        return false;
+    }
+    *bit = (reader->stream[reader->bitPosition >> 3] >> (reader->bitPosition & 7)) & 1;
+    reader->bitPosition++;
+    return true;
+}
+
+static bool GetBits(ReplayReader* reader, int count, uint64_t* value)
+{
+    *value = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        bool bit;
+        if (!GetBit(reader, &bit))
+        {
+            return false;
+        }
+        *value |= (uint64_t)bit << i;
+    }
+    return true;
+}
+
+static bool GetGamma(ReplayReader* reader, uint64_t* value)
+{
+    int length = 0;
+    bool bit = false;
+    while (GetBit(reader, &bit) && !bit)
+    {
+        if (++length == 64)
+        {
+            return false;
+        }
+    }
+    if (!bit)
+    {
+        return false;
+    }
+
+    *value = 1;
+    for (int i = 0; i < length; ++i)
+    {
+        if (!GetBit(reader, &bit))
+        {
+            return false;
+        }
+        *value = (*value << 1) | bit;
+    }
+    return true;
+}
+
+static bool ReadSequence(const uint8_t** data, const uint8_t* end, bool* sequence, int length)
+{
+    const size_t size = BitWordCount(length) * sizeof(uint64_t);
+    if ((size_t)(end - *data) < size)
+    {
+        return false;
+    }
+
+    for (int i = 0; i < length; ++i)
+    {
+        sequence[i] = ((*data)[i >> 3] >> (i & 7)) & 1;
+    }
+    *data += size;
+    return true;
+}
+
+bool ReplayOpen(ReplayReader* reader, const char* fileName)
+{
+    memset(reader, 0, sizeof(*reader));
+    FILE* file = fopen(fileName, "rb");
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    fseek(file, 0, SEEK_END);
+    const long fileSize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    uint8_t* data = fileSize > 0 ? (uint8_t*)GameAlloc((size_t)fileSize) : NULL;
+    const bool read = data != NULL && fread(data, 1, (size_t)fileSize, file) == (size_t)fileSize;
+    fclose(file);
+    if (!read || (size_t)fileSize < sizeof(ReplayHeader))
+    {
+        free(data);
+        return false;
+    }
+
+    memcpy(&reader->header, data, sizeof(ReplayHeader));
+    const ReplayHeader* header = &reader->header;
+    const uint8_t* cursor = data + sizeof(ReplayHeader);
+    const uint8_t* end = data + fileSize;
+    bool valid = memcmp(header->magic, REPLAY_MAGIC, sizeof(REPLAY_MAGIC)) == 0 && header->version == REPLAY_VERSION
+        && header->headerSize == sizeof(ReplayHeader) && header->gridWidth > 0 && header->gridHeight > 0
+        && header->gridWidth <= REPLAY_MAX_GRID_SIDE && header->gridHeight <= REPLAY_MAX_GRID_SIDE
+        && (size_t)header->gridWidth + header->gridHeight <= (size_t)fileSize * 8;
+    if (valid)
+    {
+        reader->horizontalSequence = (bool*)GameAlloc(header->gridWidth);
+        reader->verticalSequence = (bool*)GameAlloc(header->gridHeight);
+        valid = reader->horizontalSequence != NULL && reader->verticalSequence != NULL
+            && ReadSequence(&cursor, end, reader->horizontalSequence, header->gridWidth)
+            && ReadSequence(&cursor, end, reader->verticalSequence, header->gridHeight);
+    }
+    if (!valid)
+    {
+        free(data);
+        ReplayClose(reader);
+        return false;
+    }
+
+    // The stream is kept at the start of the same block
+    reader->streamSize = (size_t)(end - cursor);
+    memmove(data, cursor, reader->streamSize);
+    reader->stream = data;
+    return true;
+}
+
+bool ReplayReadEvent(ReplayReader* reader, ReplayEvent* event)
+{
+    memset(event, 0, sizeof(*event));
+    uint64_t type;
+    if (!GetBits(reader, 3, &type) || type == REPLAY_EVENT_END || type > REPLAY_EVENT_PARAMETER)
+    {
+        return false;
+    }
+    event->type = (int)type;
+
+    uint64_t code;
+    if (!GetGamma(reader, &code))
+    {
+        return false;
+    }
+    const int64_t delta = reader->lastDelta + UnZigZag(code - 1);
+    reader->lastFrame += (uint64_t)delta;
+    reader->lastDelta = delta;
+    event->frame = reader->lastFrame;
+
+    uint64_t width;
+    uint64_t height;
+    uint64_t parameter;
+    uint64_t value;
+    switch (event->type)
+    {
+    case REPLAY_EVENT_TICK:
+        if (!GetBits(reader, 1, &value))
+        {
+            return false;
+        }
+        if (value == 0)
+        {
+            break;
+        }
+        // fallthrough
+    case REPLAY_EVENT_REGENERATE:
+    case REPLAY_EVENT_RESIZE:
+        if (!GetGamma(reader, &width) || !GetGamma(reader, &height))
+        {
+            return false;
+        }
+        if (width < 2 || height < 2 || width - 1 > REPLAY_MAX_GRID_SIDE || height - 1 > REPLAY_MAX_GRID_SIDE)
+        {
+            reader->rejected = true;
+            return false;
+        }
+        event->gridWidth = (int)(width - 1);
+        event->gridHeight = (int)(height - 1);
+        break;
+    case REPLAY_EVENT_PARAMETER:
+        if (!GetBits(reader, 3, &parameter) || parameter >= REPLAY_PARAMETER_COUNT)
+        {
+            return false;
+        }
+        event->parameter = (int)parameter;
+        if (IsParameterFloat(event->parameter) ? !GetBits(reader, 32, &value) : (!GetGamma(reader, &value) || --value > UINT32_MAX))
+        {
+            return false;
+        }
+        event->value = (uint32_t)value;
+        break;
+    }
+    return true;
+}
+
+void ReplayClose(ReplayReader* reader)
+{
+    free(reader->horizontalSequence);
+    free(reader->verticalSequence);
+    free(reader->stream);
+    memset(reader, 0, sizeof(*reader));
+}
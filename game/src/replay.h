@@ -0,0 +1,112 @@
+#pragma once
+
+#include "stdbool.h"
+#include "stdint.h"
+#include "stdio.h"
+
+// Animation event log. The header holds the starting pattern, after it comes a bit stream of events,
+// each a 3 bit type and the frame delta to the event before, coded as an Elias gamma delta of
+// deltas so steady update rates cost one bit. New stitches come from the counter-based generator,
+// so events carry no stitch bits and replaying them through the app's update functions is bit-exact.
+#define REPLAY_MAGIC "HTMZLOG"
+#define REPLAY_VERSION 1
+#define REPLAY_EXTENSION ".htmzlog"
+#define REPLAY_MAX_WINDOW_SIDE 16384 // Pixels
+#define REPLAY_MAX_GRID_SIDE (REPLAY_MAX_WINDOW_SIDE << 10) // Cell size 1 at LOD_MAX_SHIFT, no window grid is larger
+
+typedef enum
+{
+    REPLAY_EVENT_END = 0,
+    REPLAY_EVENT_TICK,       // Timed pattern update of the current update type, followed by a fill when colored
+    REPLAY_EVENT_REGENERATE, // Regeneration requested from the UI, the grid may change size
+    REPLAY_EVENT_RESIZE,     // Window resize, keeps the visible stitches
+    REPLAY_EVENT_PARAMETER,
+} ReplayEventType;
+
+typedef enum
+{
+    REPLAY_PARAMETER_HORIZONTAL_PROBABILITY = 0, // Raw float bits
+    REPLAY_PARAMETER_VERTICAL_PROBABILITY,       // Raw float bits
+    REPLAY_PARAMETER_CELL_SIZE,
+    REPLAY_PARAMETER_LOD_SHIFT,
+    REPLAY_PARAMETER_COLORED,
+    REPLAY_PARAMETER_UPDATE_TYPE,
+    REPLAY_PARAMETER_COUNT,
+} ReplayParameter;
+
+typedef struct ReplayEvent_t
+{
+    int type;
+    uint64_t frame;
+    int parameter;   // REPLAY_EVENT_PARAMETER
+    uint32_t value;  // REPLAY_EVENT_PARAMETER
+    int gridWidth;   // New grid size, 0 on a REPLAY_EVENT_TICK that keeps the grid
+    int gridHeight;
+} ReplayEvent;
+
+typedef struct ReplayHeader_t
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t generator;
+    uint32_t framesPerSecond;
+
+    uint64_t seed;
+    int64_t horizontalOrigin;
+    int64_t verticalOrigin;
+    int32_t gridWidth;
+    int32_t gridHeight;
+    uint32_t parameters[REPLAY_PARAMETER_COUNT];
+    int32_t diagonalScrollDirection;
+    int32_t old00Island;
+    uint8_t horizontalFlipped;
+    uint8_t verticalFlipped;
+    uint8_t reserved[6];
+} ReplayHeader; // Followed by the bit-packed horizontal and vertical sequences, then the event stream
+
+typedef struct ReplayWriter_t
+{
+    FILE* file;
+    uint64_t bits;
+    int bitCount;
+    uint64_t lastFrame;
+    int64_t lastDelta;
+    uint32_t parameters[REPLAY_PARAMETER_COUNT]; // Last logged values, unchanged parameters are not written
+    uint64_t eventCount;
+} ReplayWriter;
+
+typedef struct ReplayReader_t
+{
+    ReplayHeader header;
+    bool* horizontalSequence;
+    bool* verticalSequence;
+
+    uint8_t* stream;
+    size_t streamSize;
+    size_t bitPosition;
+    uint64_t lastFrame;
+    int64_t lastDelta;
+    bool rejected; // The stream ended at an event with an impossible grid size
+} ReplayReader;
+
+static inline uint32_t ReplayFloatBits(float value)
+{
+    union { float f; uint32_t u; } bits = { .f = value };
+    return bits.u;
+}
+
+static inline float ReplayBitsFloat(uint32_t value)
+{
+    union { uint32_t u; float f; } bits = { .u = value };
+    return bits.f;
+}
+
+bool ReplayBeginRecording(ReplayWriter* writer, const char* fileName, const ReplayHeader* initial, const bool* horizontalSequence, const bool* verticalSequence);
+void ReplayWriteEvent(ReplayWriter* writer, const ReplayEvent* event);
+void ReplayWriteParameter(ReplayWriter* writer, uint64_t frame, ReplayParameter parameter, uint32_t value); // Skipped when unchanged
+bool ReplayEndRecording(ReplayWriter* writer);
+
+bool ReplayOpen(ReplayReader* reader, const char* fileName);
+bool ReplayReadEvent(ReplayReader* reader, ReplayEvent* event); // False at the end of the log or on a truncated or rejected stream
+void ReplayClose(ReplayReader* reader);
@@ -0,0 +1,504 @@
+#include "stats.h"
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+#include "raylib.h"
+
+#include "bits.h"
+#include "gamealloc.h"
+#include "generator.h"
+#include "timer.h"
+#include "workpool.h"
+
+typedef enum
+{
+    STATS_TOUCHES_LEFT = 1,
+    STATS_TOUCHES_RIGHT = 2,
+    STATS_TOUCHES_TOP = 4,
+    STATS_TOUCHES_BOTTOM = 8,
+} StatsEdge;
+
+// Totals of one grid point, integers where possible so they don't depend on summation order
+typedef struct StatsPoint_t
+{
+    float horizontalProbability;
+    float verticalProbability;
+    uint64_t regions;
+    uint64_t largestRegionCells;
+    uint64_t horizontalSpans; // Samples with a region that touches the left and the right edge
+    uint64_t verticalSpans;
+    uint64_t anySpans;
+    uint64_t closedLoops;
+    uint64_t closedLoopLength;
+    uint64_t longestLoopLength;
+    uint64_t openPaths;
+    uint64_t regionHistogram[STATS_HISTOGRAM_BUCKETS];
+    uint64_t loopHistogram[STATS_HISTOGRAM_BUCKETS];
+    volatile long done;
+} StatsPoint;
+
+// Per-thread buffers, sized once for the pattern and reused by every sample
+typedef struct StatsScratch_t
+{
+    bool* horizontalSequence; // width + 1 column lines
+    bool* verticalSequence;   // height + 1 row lines
+    uint64_t* evenRowColors;  // H(x) ^ (x & 1), see lod.c
+    uint64_t* oddRowColors;   // H(x)
+    uint64_t* rowColors;
+    int* rowRunOffsets;
+    int* runStarts;
+    uint8_t* runColors;
+    int* runParents;
+    int* runCells;
+    uint8_t* runEdges;
+    int* vertexParents;
+    int* vertexCounts;
+    int* degreeSums;
+    uint8_t* degrees;
+} StatsScratch;
+
+typedef struct StatsJobs_t
+{
+    const StatsConfig* config;
+    StatsPoint* points;
+    StatsScratch* scratch;
+} StatsJobs;
+
+static int Find(int* parents, int i)
+{
+    while (parents[i] != i)
+    {
+        parents[i] = parents[parents[i]];
+        i = parents[i];
+    }
+    return i;
+}
+
+static void Union(int* parents, int a, int b)
+{
+    a = Find(parents, a);
+    b = Find(parents, b);
+    if (a < b) parents[b] = a;
+    else if (b < a) parents[a] = b;
+}
+
+static int HistogramBucket(uint64_t size)
+{
+    int bucket = 0;
+    while (size > 1 && bucket < STATS_HISTOGRAM_BUCKETS - 1)
+    {
+        size >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+static bool AllocateScratch(StatsScratch* scratch, int width, int height)
+{
+    const size_t words = BitWordCount(width);
+    const size_t cells = (size_t)width * height;
+    const size_t vertices = (size_t)(width + 1) * (height + 1);
+    scratch->horizontalSequence = (bool*)GameAlloc((width + 1) * sizeof(bool));
+    scratch->verticalSequence = (bool*)GameAlloc((height + 1) * sizeof(bool));
+    scratch->evenRowColors = (uint64_t*)GameAlloc(words * sizeof(uint64_t));
+    scratch->oddRowColors = (uint64_t*)GameAlloc(words * sizeof(uint64_t));
+    scratch->rowColors = (uint64_t*)GameAlloc(words * sizeof(uint64_t));
+    scratch->rowRunOffsets = (int*)GameAlloc((height + 1) * sizeof(int));
+    scratch->runStarts = (int*)GameAlloc(cells * sizeof(int));
+    scratch->runColors = (uint8_t*)GameAlloc(cells);
+    scratch->runParents = (int*)GameAlloc(cells * sizeof(int));
+    scratch->runCells = (int*)GameAlloc(cells * sizeof(int));
+    scratch->runEdges = (uint8_t*)GameAlloc(cells);
+    scratch->vertexParents = (int*)GameAlloc(vertices * sizeof(int));
+    scratch->vertexCounts = (int*)GameAlloc(vertices * sizeof(int));
+    scratch->degreeSums = (int*)GameAlloc(vertices * sizeof(int));
+    scratch->degrees = (uint8_t*)GameAlloc(vertices);
+    return scratch->horizontalSequence != NULL && scratch->verticalSequence != NULL && scratch->evenRowColors != NULL
+        && scratch->oddRowColors != NULL && scratch->rowColors != NULL && scratch->rowRunOffsets != NULL
+        && scratch->runStarts != NULL && scratch->runColors != NULL && scratch->runParents != NULL && scratch->runCells != NULL
+        && scratch->runEdges != NULL && scratch->vertexParents != NULL && scratch->vertexCounts != NULL
+        && scratch->degreeSums != NULL && scratch->degrees != NULL;
+}
+
+static void FreeScratch(StatsScratch* scratch)
+{
+    free(scratch->horizontalSequence);
+    free(scratch->verticalSequence);
+    free(scratch->evenRowColors);
+    free(scratch->oddRowColors);
+    free(scratch->rowColors);
+    free(scratch->rowRunOffsets);
+    free(scratch->runStarts);
+    free(scratch->runColors);
+    free(scratch->runParents);
+    free(scratch->runCells);
+    free(scratch->runEdges);
+    free(scratch->vertexParents);
+    free(scratch->vertexCounts);
+    free(scratch->degreeSums);
+    free(scratch->degrees);
+}
+
+// Splits a row of packed cell colors into runs of equal color, returns the new run count
+static int AppendRuns(StatsScratch* scratch, int runCount, int width)
+{
+    const size_t words = BitWordCount(width);
+    uint64_t previousTop = 0;
+    for (size_t word = 0; word < words; ++word)
+    {
+        const uint64_t bits = scratch->rowColors[word];
+        uint64_t starts = bits ^ ((bits << 1) | previousTop);
+        if (word == 0)
+        {
+            starts |= 1;
+        }
+        if ((word + 1) * 64 > (size_t)width)
+        {
+            starts &= ~0ull >> (64 - (width & 63));
+        }
+        previousTop = bits >> 63;
+        while (starts != 0)
+        {
+            const int bit = CountTrailingZeros64(starts);
+            starts &= starts - 1;
+            scratch->runStarts[runCount] = (int)(word * 64) + bit;
+            scratch->runColors[runCount] = (uint8_t)((bits >> bit) & 1);
+            runCount++;
+        }
+    }
+    return runCount;
+}
+
+static int RunEnd(const StatsScratch* scratch, int run, int rowEnd, int width)
+{
+    return run + 1 < rowEnd ? scratch->runStarts[run + 1] : width;
+}
+
+// Regions are the connected sets of equal color, the 2-coloring flips exactly where a stitch is crossed
+static void LabelRegions(StatsScratch* scratch, StatsPoint* point, int width, int height)
+{
+    const size_t words = BitWordCount(width);
+    memset(scratch->evenRowColors, 0, words * sizeof(uint64_t));
+    memset(scratch->oddRowColors, 0, words * sizeof(uint64_t));
+    bool columnParity = false;
+    for (int x = 0; x < width; ++x)
+    {
+        columnParity ^= x > 0 && scratch->horizontalSequence[x];
+        scratch->oddRowColors[x >> 6] |= (uint64_t)columnParity << (x & 63);
+        scratch->evenRowColors[x >> 6] |= (uint64_t)(columnParity ^ (x & 1)) << (x & 63);
+    }
+
+    int runCount = 0;
+    bool rowParity = false;
+    for (int y = 0; y < height; ++y)
+    {
+        const bool yOdd = (y & 1) == 1;
+        rowParity ^= y > 0 && scratch->verticalSequence[y];
+        const uint64_t rowTerm = rowParity ^ yOdd ? ~0ull : 0;
+        const uint64_t* columnTerms = yOdd ? scratch->oddRowColors : scratch->evenRowColors;
+        for (size_t word = 0; word < words; ++word)
+        {
+            scratch->rowColors[word] = columnTerms[word] ^ rowTerm;
+        }
+
+        const int rowStart = runCount;
+        scratch->rowRunOffsets[y] = rowStart;
+        runCount = AppendRuns(scratch, runCount, width);
+        for (int run = rowStart; run < runCount; ++run)
+        {
+            const int end = RunEnd(scratch, run, runCount, width);
+            scratch->runParents[run] = run;
+            scratch->runCells[run] = 0;
+            scratch->runEdges[run] = (scratch->runStarts[run] == 0 ? STATS_TOUCHES_LEFT : 0) | (end == width ? STATS_TOUCHES_RIGHT : 0)
+                | (y == 0 ? STATS_TOUCHES_TOP : 0) | (y == height - 1 ? STATS_TOUCHES_BOTTOM : 0);
+        }
+
+        // Runs of equal color that overlap the row above belong to the same region
+        if (y > 0)
+        {
+            int above = scratch->rowRunOffsets[y - 1];
+            int run = rowStart;
+            while (above < rowStart && run < runCount)
+            {
+                const int aboveEnd = RunEnd(scratch, above, rowStart, width);
+                const int runEnd = RunEnd(scratch, run, runCount, width);
+                if (scratch->runColors[above] == scratch->runColors[run])
+                {
+                    Union(scratch->runParents, above, run);
+                }
+                if (aboveEnd <= runEnd) above++;
+                if (runEnd <= aboveEnd) run++;
+            }
+        }
+    }
+    scratch->rowRunOffsets[height] = runCount;
+
+    for (int y = 0; y < height; ++y)
+    {
+        const int rowEnd = scratch->rowRunOffsets[y + 1];
+        for (int run = scratch->rowRunOffsets[y]; run < rowEnd; ++run)
+        {
+            const int root = Find(scratch->runParents, run);
+            scratch->runCells[root] += RunEnd(scratch, run, rowEnd, width) - scratch->runStarts[run];
+            scratch->runEdges[root] |= scratch->runEdges[run];
+        }
+    }
+
+    int largest = 0;
+    uint8_t spans = 0;
+    for (int run = 0; run < runCount; ++run)
+    {
+        if (scratch->runParents[run] != run)
+        {
+            continue;
+        }
+        const int cells = scratch->runCells[run];
+        const uint8_t edges = scratch->runEdges[run];
+        point->regions++;
+        point->regionHistogram[HistogramBucket((uint64_t)cells)]++;
+        largest = cells > largest ? cells : largest;
+        spans |= (edges & (STATS_TOUCHES_LEFT | STATS_TOUCHES_RIGHT)) == (STATS_TOUCHES_LEFT | STATS_TOUCHES_RIGHT) ? 1 : 0;
+        spans |= (edges & (STATS_TOUCHES_TOP | STATS_TOUCHES_BOTTOM)) == (STATS_TOUCHES_TOP | STATS_TOUCHES_BOTTOM) ? 2 : 0;
+    }
+    point->largestRegionCells += (uint64_t)largest;
+    point->horizontalSpans += spans & 1;
+    point->verticalSpans += (spans >> 1) & 1;
+    point->anySpans += spans != 0;
+}
+
+// Stitches join the lattice points, (width + 1) x (height + 1) of them. Row line Y has a segment right of
+// point X when (X & 1) == v[Y], column line X one below point Y when (Y & 1) == h[X], so every inner point has
+// degree 2 and each curve is a closed loop or a path between two border points.
+static void LabelLoops(StatsScratch* scratch, StatsPoint* point, int width, int height)
+{
+    const int stride = width + 1;
+    const int vertexCount = stride * (height + 1);
+    for (int i = 0; i < vertexCount; ++i)
+    {
+        scratch->vertexParents[i] = i;
+        scratch->vertexCounts[i] = 0;
+        scratch->degreeSums[i] = 0;
+        scratch->degrees[i] = 0;
+    }
+
+    for (int y = 0; y <= height; ++y)
+    {
+        int* parents = scratch->vertexParents;
+        uint8_t* degrees = scratch->degrees + y * stride;
+        const int row = y * stride;
+        for (int x = scratch->verticalSequence[y] ? 1 : 0; x < width; x += 2)
+        {
+            Union(parents, row + x, row + x + 1);
+            degrees[x]++;
+            degrees[x + 1]++;
+        }
+        if (y == height)
+        {
+            break;
+        }
+        for (int x = 0; x <= width; ++x)
+        {
+            if (scratch->horizontalSequence[x] == ((y & 1) == 1))
+            {
+                Union(parents, row + x, row + stride + x);
+                degrees[x]++;
+                degrees[stride + x]++;
+            }
+        }
+    }
+
+    for (int i = 0; i < vertexCount; ++i)
+    {
+        const int root = Find(scratch->vertexParents, i);
+        scratch->vertexCounts[root]++;
+        scratch->degreeSums[root] += scratch->degrees[i];
+    }
+
+    uint64_t longest = 0;
+    for (int i = 0; i < vertexCount; ++i)
+    {
+        if (scratch->vertexParents[i] != i || scratch->degreeSums[i] == 0)
+        {
+            continue;
+        }
+        const int vertices = scratch->vertexCounts[i];
+        if (scratch->degreeSums[i] == 2 * vertices)
+        {
+            point->closedLoops++;
+            point->closedLoopLength += (uint64_t)vertices;
+            point->loopHistogram[HistogramBucket((uint64_t)vertices)]++;
+            longest = (uint64_t)vertices > longest ? (uint64_t)vertices : longest;
+        }
+        else
+        {
+            point->openPaths++;
+        }
+    }
+    point->longestLoopLength += longest;
+}
+
+static void RunPoint(void* context, int jobIndex, int threadIndex)
+{
+    StatsJobs* jobs = (StatsJobs*)context;
+    const StatsConfig* config = jobs->config;
+    StatsScratch* scratch = &jobs->scratch[threadIndex];
+    StatsPoint* point = &jobs->points[jobIndex];
+    for (int sample = 0; sample < config->samplesPerPoint; ++sample)
+    {
+        const uint64_t seed = SplitMix64(config->seed ^ SplitMix64(((uint64_t)jobIndex << 32) | (uint64_t)sample));
+        for (int i = 0; i <= config->width; ++i)
+        {
+            scratch->horizontalSequence[i] = GeneratorStitch(seed, SEQUENCE_HORIZONTAL, i, point->horizontalProbability);
+        }
+        for (int i = 0; i <= config->height; ++i)
+        {
+            scratch->verticalSequence[i] = GeneratorStitch(seed, SEQUENCE_VERTICAL, i, point->verticalProbability);
+        }
+        LabelRegions(scratch, point, config->width, config->height);
+        LabelLoops(scratch, point, config->width, config->height);
+    }
+    WorkPoolAdd(&point->done, 1);
+}
+
+static void WriteHistogram(FILE* file, const uint64_t* histogram, const char* separator)
+{
+    for (int bucket = 0; bucket < STATS_HISTOGRAM_BUCKETS; ++bucket)
+    {
+        fprintf(file, "%s%llu", bucket > 0 ? separator : "", (unsigned long long)histogram[bucket]);
+    }
+}
+
+static void WritePoint(FILE* file, const StatsConfig* config, const StatsPoint* point, bool json, bool first)
+{
+    const double samples = (double)config->samplesPerPoint;
+    const double cells = (double)config->width * config->height;
+    const double regions = (double)point->regions / samples;
+    const double meanRegionCells = point->regions > 0 ? cells * samples / (double)point->regions : 0.0;
+    const double largestRegionFraction = (double)point->largestRegionCells / (cells * samples);
+    const double meanLoopLength = point->closedLoops > 0 ? (double)point->closedLoopLength / (double)point->closedLoops : 0.0;
+    if (json)
+    {
+        fprintf(file, "%s\n    {\"hp\": %.6f, \"vp\": %.6f, \"regions\": %.6f, \"meanRegionCells\": %.6f, \"largestRegionFraction\": %.6f, "
+            "\"horizontalSpanProbability\": %.6f, \"verticalSpanProbability\": %.6f, \"spanProbability\": %.6f, "
+            "\"closedLoops\": %.6f, \"meanLoopLength\": %.6f, \"longestLoopLength\": %.6f, \"openPaths\": %.6f, \"regionHistogram\": [",
+            first ? "" : ",", point->horizontalProbability, point->verticalProbability, regions, meanRegionCells, largestRegionFraction,
+            (double)point->horizontalSpans / samples, (double)point->verticalSpans / samples, (double)point->anySpans / samples,
+            (double)point->closedLoops / samples, meanLoopLength, (double)point->longestLoopLength / samples, (double)point->openPaths / samples);
+        WriteHistogram(file, point->regionHistogram, ", ");
+        fprintf(file, "], \"loopHistogram\": [");
+        WriteHistogram(file, point->loopHistogram, ", ");
+        fprintf(file, "]}");
+    }
+    else
+    {
+        fprintf(file, "%.6f,%.6f,%d,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,",
+            point->horizontalProbability, point->verticalProbability, config->samplesPerPoint, regions, meanRegionCells, largestRegionFraction,
+            (double)point->horizontalSpans / samples, (double)point->verticalSpans / samples, (double)point->anySpans / samples,
+            (double)point->closedLoops / samples, meanLoopLength, (double)point->longestLoopLength / samples, (double)point->openPaths / samples);
+        WriteHistogram(file, point->regionHistogram, ",");
+        fprintf(file, ",");
+        WriteHistogram(file, point->loopHistogram, ",");
+        fprintf(file, "\n");
+    }
+}
+
+static void WriteHeader(FILE* file, const StatsConfig* config, bool json)
+{
+    if (json)
+    {
+        fprintf(file, "{\n  \"seed\": %llu, \"width\": %d, \"height\": %d, \"samplesPerPoint\": %d, \"histogramBuckets\": %d,\n  \"points\": [",
+            (unsigned long long)config->seed, config->width, config->height, config->samplesPerPoint, STATS_HISTOGRAM_BUCKETS);
+        return;
+    }
+
+    fprintf(file, "hp,vp,samples,regions,mean_region_cells,largest_region_fraction,horizontal_span_probability,"
+        "vertical_span_probability,span_probability,closed_loops,mean_loop_length,longest_loop_length,open_paths");
+    for (int bucket = 0; bucket < STATS_HISTOGRAM_BUCKETS; ++bucket)
+    {
+        fprintf(file, ",region_log2_%d", bucket);
+    }
+    for (int bucket = 0; bucket < STATS_HISTOGRAM_BUCKETS; ++bucket)
+    {
+        fprintf(file, ",loop_log2_%d", bucket);
+    }
+    fprintf(file, "\n");
+}
+
+bool StatsRun(const StatsConfig* config)
+{
+    if (config->gridPoints < 1 || config->samplesPerPoint < 1 || config->width < 1 || config->height < 1
+        || (size_t)(config->width + 1) * (config->height + 1) > (size_t)INT32_MAX)
+    {
+        TraceLog(LOG_WARNING, "STATS: Invalid sweep");
+        return false;
+    }
+
+    FILE* file = fopen(config->fileName, "w");
+    if (file == NULL)
+    {
+        TraceLog(LOG_WARNING, "STATS: Failed to open %s", config->fileName);
+        return false;
+    }
+
+    const int pointCount = config->gridPoints * config->gridPoints;
+    const int threadCount = config->threadCount > 0 ? config->threadCount : WorkPoolDefaultThreadCount();
+    StatsPoint* points = (StatsPoint*)GameCalloc(pointCount, sizeof(StatsPoint));
+    StatsScratch* scratch = (StatsScratch*)GameCalloc(threadCount, sizeof(StatsScratch));
+    bool allocated = points != NULL && scratch != NULL;
+    for (int i = 0; allocated && i < threadCount; ++i)
+    {
+        allocated = AllocateScratch(&scratch[i], config->width, config->height);
+    }
+
+    const float step = config->gridPoints > 1 ? 1.0f / (float)(config->gridPoints - 1) : 0.0f;
+    for (int i = 0; allocated && i < pointCount; ++i)
+    {
+        points[i].horizontalProbability = config->gridPoints > 1 ? (float)(i % config->gridPoints) * step : 0.5f;
+        points[i].verticalProbability = config->gridPoints > 1 ? (float)(i / config->gridPoints) * step : 0.5f;
+    }
+
+    StatsJobs jobs = { config, points, scratch };
+    WorkPool pool;
+    const bool started = allocated && WorkPoolStart(&pool, threadCount, pointCount, RunPoint, &jobs);
+    if (started)
+    {
+        const bool json = strlen(config->fileName) >= 5 && strcmp(config->fileName + strlen(config->fileName) - 5, ".json") == 0;
+        const uint64_t startNs = GetMonotonicTimeNs();
+        WriteHeader(file, config, json);
+        for (int i = 0; i < pointCount; ++i)
+        {
+            // Points are written in order as they finish, so a long sweep can be watched or cut short
+            while (WorkPoolLoad(&points[i].done) == 0)
+            {
+                WorkPoolSleep(10);
+            }
+            WritePoint(file, config, &points[i], json, i == 0);
+            fflush(file);
+        }
+        if (json)
+        {
+            fprintf(file, "\n  ]\n}\n");
+        }
+        WorkPoolWait(&pool, false);
+
+        const double seconds = (double)(GetMonotonicTimeNs() - startNs) * 1e-9;
+        const double samples = (double)pointCount * config->samplesPerPoint;
+        TraceLog(LOG_INFO, "STATS: %.0f samples of %dx%d written to %s in %.2f s, %.0f samples/s on %d threads", samples,
+            config->width, config->height, config->fileName, seconds, samples / seconds, threadCount);
+    }
+    else
+    {
+        TraceLog(LOG_WARNING, "STATS: Failed to start the sweep");
+    }
+
+    for (int i = 0; scratch != NULL && i < threadCount; ++i)
+    {
+        FreeScratch(&scratch[i]);
+    }
+    free(scratch);
+    free(points);
+    fclose(file);
+    return started;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "stdbool.h"
+#include "stdint.h"
+
+// Headless Monte Carlo statistics over a grid of (horizontal, vertical) probabilities. Every sample is a
+// random width x height pattern, its regions (cells joined where no stitch separates them) and its stitch
+// curves are labeled with union-find, and the totals of each grid point are streamed to CSV or JSON as soon
+// as the point is done. Sample seeds only depend on the base seed and the sample's place in the grid, so a
+// run is reproducible whatever the thread count.
+#define STATS_HISTOGRAM_BUCKETS 25 // Bucket b counts sizes in [2^b, 2^(b+1)), the last one everything above
+
+typedef struct StatsConfig_t
+{
+    const char* fileName; // JSON when it ends in .json, CSV otherwise
+    int gridPoints;       // Probabilities i / (gridPoints - 1) on each axis
+    int samplesPerPoint;
+    int width;            // Cells
+    int height;
+    uint64_t seed;
+    int threadCount;      // 0 for one per CPU
+} StatsConfig;
+
+bool StatsRun(const StatsConfig* config);
@@ -0,0 +1,270 @@
+#include "tileserver.h"
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+#include "raylib.h"
+
+#include "gamealloc.h"
+
+#if defined(__linux__)
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+
+#define BENCH_BUFFER_SIZE 8192
+#define BENCH_MAX_EVENTS 256
+
+// Closed loop load generator: every connection sends its next request as soon as a response is complete
+typedef struct BenchConnection_t
+{
+    int fd;
+    bool sending;
+    char request[256];
+    size_t requestSize;
+    size_t requestSent;
+    char buffer[BENCH_BUFFER_SIZE];
+    size_t bufferSize;
+    bool inBody;
+    size_t bodyRemaining;
+    int status;
+    uint64_t sentNs;
+} BenchConnection;
+
+typedef struct BenchStats_t
+{
+    uint64_t* latenciesNs;
+    size_t count;
+    size_t capacity;
+    uint64_t bodyBytes;
+    uint64_t okCount;
+    uint64_t errorCount;
+} BenchStats;
+
+static uint64_t MonotonicNs(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t)time.tv_sec * 1000000000ull + (uint64_t)time.tv_nsec;
+}
+
+static int CompareLatencies(const void* a, const void* b)
+{
+    const uint64_t left = *(const uint64_t*)a;
+    const uint64_t right = *(const uint64_t*)b;
+    return left < right ? -1 : (left > right ? 1 : 0);
+}
+
+static void Watch(int epollFd, BenchConnection* connection, int operation)
+{
+    struct epoll_event event = { .events = connection->sending ? EPOLLOUT : EPOLLIN, .data.ptr = connection };
+    epoll_ctl(epollFd, operation, connection->fd, &event);
+}
+
+// Tiles of a square block at zoom 4, so the working set and with it the cache hit rate is controlled by tileCount
+static void PrepareRequest(BenchConnection* connection, int tileCount, uint64_t* random)
+{
+    *random ^= *random << 13;
+    *random ^= *random >> 7;
+    *random ^= *random << 17;
+    int side = 1;
+    while (side * side < tileCount)
+    {
+        side++;
+    }
+    const int tile = (int)(*random % (uint64_t)tileCount);
+    connection->requestSize = (size_t)snprintf(connection->request, sizeof(connection->request),
+        "GET /12345/0.5/0.5/4/%d/%d.png HTTP/1.1\r\nHost: localhost\r\n\r\n", tile % side, tile / side);
+    connection->requestSent = 0;
+    connection->sending = true;
+    connection->bufferSize = 0;
+    connection->inBody = false;
+    connection->sentNs = MonotonicNs();
+}
+
+static void RecordResponse(BenchStats* stats, const BenchConnection* connection)
+{
+    if (stats->count == stats->capacity)
+    {
+        const size_t capacity = stats->capacity > 0 ? stats->capacity + stats->capacity / 2 : 4096;
+        uint64_t* latencies = (uint64_t*)GameGrow(stats->latenciesNs, capacity * sizeof(uint64_t));
+        if (latencies == NULL)
+        {
+            return;
+        }
+        stats->latenciesNs = latencies;
+        stats->capacity = capacity;
+    }
+    stats->latenciesNs[stats->count++] = MonotonicNs() - connection->sentNs;
+    if (connection->status == 200 || connection->status == 304) stats->okCount++;
+    else stats->errorCount++;
+}
+
+// Consumes received bytes, true once the whole response is in
+static bool ReceiveResponse(BenchConnection* connection, BenchStats* stats)
+{
+    if (!connection->inBody)
+    {
+        connection->buffer[connection->bufferSize] = '\0';
+        const char* headEnd = strstr(connection->buffer, "\r\n\r\n");
+        if (headEnd == NULL)
+        {
+            return false;
+        }
+
+        connection->status = 0;
+        sscanf(connection->buffer, "HTTP/1.%*d %d", &connection->status);
+        size_t contentLength = 0;
+        const char* lengthHeader = strstr(connection->buffer, "Content-Length:");
+        if (lengthHeader != NULL && lengthHeader < headEnd)
+        {
+            contentLength = strtoull(lengthHeader + 15, NULL, 10);
+        }
+
+        const size_t headSize = (size_t)(headEnd + 4 - connection->buffer);
+        const size_t bodyReceived = connection->bufferSize - headSize;
+        connection->inBody = true;
+        connection->bodyRemaining = contentLength > bodyReceived ? contentLength - bodyReceived : 0;
+        connection->bufferSize = 0;
+        stats->bodyBytes += bodyReceived;
+    }
+    else
+    {
+        const size_t bodyReceived = connection->bufferSize < connection->bodyRemaining ? connection->bufferSize : connection->bodyRemaining;
+        connection->bodyRemaining -= bodyReceived;
+        connection->bufferSize = 0;
+        stats->bodyBytes += bodyReceived;
+    }
+
+    if (connection->bodyRemaining > 0)
+    {
+        return false;
+    }
+    RecordResponse(stats, connection);
+    return true;
+}
+
+bool TileBenchmarkRun(const TileBenchmarkConfig* config)
+{
+    const int connectionCount = config->connectionCount > 0 ? config->connectionCount : 1;
+    const int tileCount = config->tileCount > 0 ? config->tileCount : 1;
+    BenchConnection* connections = (BenchConnection*)GameCalloc(connectionCount, sizeof(BenchConnection));
+    const int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (connections == NULL || epollFd < 0)
+    {
+        free(connections);
+        if (epollFd >= 0) close(epollFd);
+        return false;
+    }
+
+    uint64_t random = 0x9e3779b97f4a7c15ull;
+    int openCount = 0;
+    for (int i = 0; i < connectionCount; ++i)
+    {
+        connections[i].fd = TileSocketOpen(config->address, false);
+        if (connections[i].fd < 0)
+        {
+            continue;
+        }
+        PrepareRequest(&connections[i], tileCount, &random);
+        Watch(epollFd, &connections[i], EPOLL_CTL_ADD);
+        openCount++;
+    }
+    if (openCount == 0)
+    {
+        TraceLog(LOG_WARNING, "TILES: Could not connect to %s", config->address);
+        free(connections);
+        close(epollFd);
+        return false;
+    }
+
+    BenchStats stats = { 0 };
+    const uint64_t startNs = MonotonicNs();
+    const uint64_t endNs = startNs + (uint64_t)(config->seconds * 1e9);
+    struct epoll_event events[BENCH_MAX_EVENTS];
+    while (openCount > 0 && MonotonicNs() < endNs)
+    {
+        const int eventCount = epoll_wait(epollFd, events, BENCH_MAX_EVENTS, 100);
+        for (int i = 0; i < eventCount; ++i)
+        {
+            BenchConnection* connection = (BenchConnection*)events[i].data.ptr;
+            bool failed = (events[i].events & EPOLLERR) != 0;
+            if (!failed && connection->sending)
+            {
+                const ssize_t sent = send(connection->fd, connection->request + connection->requestSent,
+                    connection->requestSize - connection->requestSent, MSG_NOSIGNAL);
+                failed = sent < 0 && errno != EAGAIN && errno != EINTR;
+                connection->requestSent += sent > 0 ? (size_t)sent : 0;
+                if (connection->requestSent == connection->requestSize)
+                {
+                    connection->sending = false;
+                    Watch(epollFd, connection, EPOLL_CTL_MOD);
+                }
+            }
+            else if (!failed)
+            {
+                const ssize_t received = recv(connection->fd, connection->buffer + connection->bufferSize,
+                    BENCH_BUFFER_SIZE - 1 - connection->bufferSize, 0);
+                failed = received == 0 || (received < 0 && errno != EAGAIN && errno != EINTR);
+                connection->bufferSize += received > 0 ? (size_t)received : 0;
+                if (!failed && ReceiveResponse(connection, &stats))
+                {
+                    PrepareRequest(connection, tileCount, &random);
+                    Watch(epollFd, connection, EPOLL_CTL_MOD);
+                }
+                else if (!connection->inBody && connection->bufferSize == BENCH_BUFFER_SIZE - 1)
+                {
+                    failed = true; // Response head does not fit
+                }
+            }
+
+            if (failed)
+            {
+                epoll_ctl(epollFd, EPOLL_CTL_DEL, connection->fd, NULL);
+                close(connection->fd);
+                connection->fd = -1;
+                stats.errorCount++;
+                openCount--;
+            }
+        }
+    }
+    const double seconds = (double)(MonotonicNs() - startNs) * 1e-9;
+
+    for (int i = 0; i < connectionCount; ++i)
+    {
+        if (connections[i].fd >= 0)
+        {
+            close(connections[i].fd);
+        }
+    }
+    free(connections);
+    close(epollFd);
+
+    uint64_t p50 = 0;
+    uint64_t p99 = 0;
+    if (stats.count > 0)
+    {
+        qsort(stats.latenciesNs, stats.count, sizeof(uint64_t), CompareLatencies);
+        p50 = stats.latenciesNs[stats.count / 2];
+        p99 = stats.latenciesNs[stats.count * 99 / 100];
+    }
+    TraceLog(LOG_INFO, "TILES: %.0f tiles/s over %d connections, %.1f MB/s, latency p50 %.3f ms p99 %.3f ms, %llu errors",
+        (double)stats.okCount / seconds, connectionCount, (double)stats.bodyBytes / seconds / (1 << 20),
+        (double)p50 * 1e-6, (double)p99 * 1e-6, (unsigned long long)stats.errorCount);
+    free(stats.latenciesNs);
+    return stats.okCount > 0;
+}
+
+#else
+
+bool TileBenchmarkRun(const TileBenchmarkConfig* config)
+{
+    (void)config;
+    TraceLog(LOG_WARNING, "TILES: The tile benchmark is only available on Linux");
+    return false;
+}
+
+#endif
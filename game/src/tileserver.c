@@ -0,0 +1,1150 @@
+#include "tileserver.h"
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+#include "raylib.h"
+
+#include "gamealloc.h"
+#include "generator.h"
+
+#if defined(__linux__)
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <strings.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#define TILE_REQUEST_MAX 4096
+#define TILE_MAX_EVENTS 256
+#define TILE_LISTEN_BACKLOG 512
+
+typedef struct TileKey_t
+{
+    uint64_t seed;
+    float horizontalProbability;
+    float verticalProbability;
+    int zoom;
+    int64_t x;
+    int64_t y;
+} TileKey;
+
+typedef struct TileCacheEntry_t
+{
+    TileKey key;
+    uint64_t hash;
+    struct TileCacheEntry_t* bucketNext;
+    struct TileCacheEntry_t* newer;
+    struct TileCacheEntry_t* older;
+    size_t pngSize;
+    uint8_t png[];
+} TileCacheEntry;
+
+// Encoded tiles by URL, least recently used ones are evicted to stay within the byte budget
+typedef struct TileCache_t
+{
+    TileCacheEntry** buckets;
+    size_t bucketMask;
+    TileCacheEntry* newest;
+    TileCacheEntry* oldest;
+    size_t bytes;
+    size_t budget;
+    uint64_t hits;
+    uint64_t misses;
+} TileCache;
+
+typedef struct TileConnection_t
+{
+    int fd;
+    uint32_t watched; // Epoll events currently registered
+    char request[TILE_REQUEST_MAX];
+    size_t requestSize;
+    char* response;
+    size_t responseSize;
+    size_t responseCapacity;
+    size_t responseSent;
+    bool keepAlive;
+    bool headOnly;
+    bool rendering; // A worker holds a job for this connection
+    bool closed;    // Freed at the end of the event batch, or when its job comes back
+    struct TileConnection_t* previous;
+    struct TileConnection_t* next;
+} TileConnection;
+
+typedef struct TileJob_t
+{
+    TileKey key;
+    uint64_t hash;
+    TileConnection* connection;
+    uint8_t* png;
+    size_t pngSize;
+    struct TileJob_t* next;
+} TileJob;
+
+typedef struct TileQueue_t
+{
+    TileJob* head;
+    TileJob* tail;
+} TileQueue;
+
+typedef struct TileServer_t
+{
+    int listenFd;
+    int epollFd;
+    int wakeFd; // Workers write to it when a tile is done
+    bool unixSocket;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t jobReady;
+    TileQueue pending;
+    TileQueue done;
+    bool stopping;
+    pthread_t* workers;
+    int workerCount;
+
+    TileCache cache;
+    TileConnection* connections;
+    TileConnection* closedConnections;
+    uint64_t tilesServed;
+    uint64_t notModified;
+} TileServer;
+
+static volatile sig_atomic_t tileServerStop = 0;
+
+static void StopTileServer(int signal)
+{
+    (void)signal;
+    tileServerStop = 1;
+}
+
+static uint32_t FloatBits(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static bool TileKeyEqual(const TileKey* a, const TileKey* b)
+{
+    return a->seed == b->seed && FloatBits(a->horizontalProbability) == FloatBits(b->horizontalProbability)
+        && FloatBits(a->verticalProbability) == FloatBits(b->verticalProbability) && a->zoom == b->zoom && a->x == b->x && a->y == b->y;
+}
+
+// Also the ETag, tiles are a pure function of their URL
+static uint64_t TileKeyHash(const TileKey* key)
+{
+    uint64_t hash = SplitMix64(key->seed ^ TILE_FORMAT_VERSION);
+    hash = SplitMix64(hash ^ ((uint64_t)FloatBits(key->horizontalProbability) << 32 | FloatBits(key->verticalProbability)));
+    hash = SplitMix64(hash ^ (uint64_t)key->zoom);
+    hash = SplitMix64(hash ^ (uint64_t)key->x);
+    return SplitMix64(hash ^ (uint64_t)key->y);
+}
+
+// Rows of the 1 bit grayscale PNG image, each behind its filter type byte
+#define TILE_ROW_BYTES (1 + TILE_SIZE / 8)
+#define TILE_IMAGE_BYTES (TILE_ROW_BYTES * TILE_SIZE)
+#define TILE_PNG_MAX_SIZE (TILE_IMAGE_BYTES * 9 / 8 + 128) // Every byte a 9 bit literal, plus chunks
+
+static void ClearBits(uint8_t* row, int start, int count)
+{
+    for (int x = start; x < start + count; ++x)
+    {
+        row[x >> 3] &= (uint8_t)~(0x80 >> (x & 7));
+    }
+}
+
+// Black stitches on white, a set bit is white. Column X has vertical stitches on the rows where (Y & 1) == h[X]
+// and row Y has horizontal stitches on the columns where (X & 1) == v[Y], same as the app draws them
+static void RenderTile(const TileKey* key, uint8_t* image)
+{
+    const int cellSize = 1 << key->zoom;
+    const int cells = TILE_SIZE / cellSize;
+    const int64_t firstColumn = key->x * cells;
+    const int64_t firstRow = key->y * cells;
+    for (int y = 0; y < TILE_SIZE; ++y)
+    {
+        image[y * TILE_ROW_BYTES] = 0;
+        memset(image + y * TILE_ROW_BYTES + 1, 0xff, TILE_ROW_BYTES - 1);
+    }
+
+    for (int column = 0; column < cells; ++column)
+    {
+        const int parity = GeneratorStitch(key->seed, SEQUENCE_HORIZONTAL, firstColumn + column, key->horizontalProbability);
+        for (int row = (int)((firstRow + parity) & 1); row < cells; row += 2)
+        {
+            for (int i = 0; i < cellSize; ++i)
+            {
+                ClearBits(image + (row * cellSize + i) * TILE_ROW_BYTES + 1, column * cellSize, 1);
+            }
+        }
+    }
+
+    for (int row = 0; row < cells; ++row)
+    {
+        const int parity = GeneratorStitch(key->seed, SEQUENCE_VERTICAL, firstRow + row, key->verticalProbability);
+        uint8_t* line = image + row * cellSize * TILE_ROW_BYTES + 1;
+        for (int column = (int)((firstColumn + parity) & 1); column < cells; column += 2)
+        {
+            ClearBits(line, column * cellSize, cellSize);
+        }
+    }
+
+    // Up filter from the bottom, repeated rows become zeros
+    for (int y = TILE_SIZE - 1; y > 0; --y)
+    {
+        uint8_t* current = image + y * TILE_ROW_BYTES;
+        const uint8_t* above = current - TILE_ROW_BYTES;
+        current[0] = 2;
+        for (int i = 1; i < TILE_ROW_BYTES; ++i)
+        {
+            current[i] = (uint8_t)(current[i] - above[i]);
+        }
+    }
+}
+
+typedef struct PngWriter_t
+{
+    uint8_t* output;
+    size_t size;
+    uint32_t bits;
+    int bitCount;
+} PngWriter;
+
+static void PutBits(PngWriter* writer, uint32_t value, int count)
+{
+    writer->bits |= value << writer->bitCount;
+    writer->bitCount += count;
+    while (writer->bitCount >= 8)
+    {
+        writer->output[writer->size++] = (uint8_t)writer->bits;
+        writer->bits >>= 8;
+        writer->bitCount -= 8;
+    }
+}
+
+// Huffman codes go out from their top bit
+static void PutCode(PngWriter* writer, uint32_t code, int length)
+{
+    uint32_t reversed = 0;
+    for (int i = 0; i < length; ++i)
+    {
+        reversed |= ((code >> i) & 1) << (length - 1 - i);
+    }
+    PutBits(writer, reversed, length);
+}
+
+static void PutFixedSymbol(PngWriter* writer, int symbol)
+{
+    if (symbol < 144) PutCode(writer, 0x30 + symbol, 8);
+    else if (symbol < 256) PutCode(writer, 0x190 + symbol - 144, 9);
+    else if (symbol < 280) PutCode(writer, symbol - 256, 7);
+    else PutCode(writer, 0xc0 + symbol - 280, 8);
+}
+
+// Match of the previous byte repeated, distance 1 is distance code 0 with no extra bits
+static void PutRepeat(PngWriter* writer, int length)
+{
+    static const int bases[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+    static const int extraBits[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+    int code = 28;
+    while (bases[code] > length)
+    {
+        code--;
+    }
+    PutFixedSymbol(writer, 257 + code);
+    PutBits(writer, (uint32_t)(length - bases[code]), extraBits[code]);
+    PutCode(writer, 0, 5);
+}
+
+static void PutBigEndian(PngWriter* writer, uint32_t value)
+{
+    writer->output[writer->size++] = (uint8_t)(value >> 24);
+    writer->output[writer->size++] = (uint8_t)(value >> 16);
+    writer->output[writer->size++] = (uint8_t)(value >> 8);
+    writer->output[writer->size++] = (uint8_t)value;
+}
+
+static uint32_t crcTable[256]; // Filled before the workers start
+
+static void InitCrcTable(void)
+{
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc & 1) ? 0xedb88320u ^ (crc >> 1) : crc >> 1;
+        }
+        crcTable[i] = crc;
+    }
+}
+
+static uint32_t Crc32(const uint8_t* data, size_t size)
+{
+    uint32_t crc = 0xffffffffu;
+    for (size_t i = 0; i < size; ++i)
+    {
+        crc = crcTable[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    }
+    return crc ^ 0xffffffffu;
+}
+
+static void EndChunk(PngWriter* writer, size_t chunkStart)
+{
+    const uint32_t length = (uint32_t)(writer->size - chunkStart - 8);
+    writer->output[chunkStart] = (uint8_t)(length >> 24);
+    writer->output[chunkStart + 1] = (uint8_t)(length >> 16);
+    writer->output[chunkStart + 2] = (uint8_t)(length >> 8);
+    writer->output[chunkStart + 3] = (uint8_t)length;
+    PutBigEndian(writer, Crc32(writer->output + chunkStart + 4, writer->size - chunkStart - 4));
+}
+
+static size_t BeginChunk(PngWriter* writer, const char* type)
+{
+    const size_t chunkStart = writer->size;
+    writer->size += 4;
+    memcpy(writer->output + writer->size, type, 4);
+    writer->size += 4;
+    return chunkStart;
+}
+
+// Stitch images are runs of equal bytes once filtered, so a single fixed Huffman block that only
+// codes literals and distance 1 repeats compresses them well at a fraction of a generic encoder's cost
+static size_t EncodeTilePng(const uint8_t* image, uint8_t* output)
+{
+    PngWriter writer = { .output = output };
+    static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    memcpy(output, signature, sizeof(signature));
+    writer.size = sizeof(signature);
+
+    size_t chunk = BeginChunk(&writer, "IHDR");
+    PutBigEndian(&writer, TILE_SIZE);
+    PutBigEndian(&writer, TILE_SIZE);
+    const uint8_t header[5] = { 1, 0, 0, 0, 0 }; // 1 bit grayscale, deflate, adaptive filtering, no interlace
+    memcpy(output + writer.size, header, sizeof(header));
+    writer.size += sizeof(header);
+    EndChunk(&writer, chunk);
+
+    chunk = BeginChunk(&writer, "IDAT");
+    output[writer.size++] = 0x78;
+    output[writer.size++] = 0x01;
+    PutBits(&writer, 1, 1); // Final block
+    PutBits(&writer, 1, 2); // Fixed Huffman codes
+    uint32_t adlerLow = 1;
+    uint32_t adlerHigh = 0;
+    for (int i = 0; i < TILE_IMAGE_BYTES;)
+    {
+        int run = 0;
+        while (i > 0 && i + run < TILE_IMAGE_BYTES && run < 258 && image[i + run] == image[i - 1])
+        {
+            run++;
+        }
+        const int count = run >= 3 ? run : 1;
+        if (run >= 3)
+        {
+            PutRepeat(&writer, run);
+        }
+        else
+        {
+            PutFixedSymbol(&writer, image[i]);
+        }
+        for (int j = 0; j < count; ++j)
+        {
+            adlerLow = (adlerLow + image[i + j]) % 65521;
+            adlerHigh = (adlerHigh + adlerLow) % 65521;
+        }
+        i += count;
+    }
+    PutFixedSymbol(&writer, 256);
+    PutBits(&writer, 0, 7); // Flush to a byte boundary
+    writer.bitCount = 0;
+    PutBigEndian(&writer, adlerHigh << 16 | adlerLow);
+    EndChunk(&writer, chunk);
+
+    EndChunk(&writer, BeginChunk(&writer, "IEND"));
+    return writer.size;
+}
+
+static bool CacheInit(TileCache* cache, size_t budget)
+{
+    memset(cache, 0, sizeof(*cache));
+    size_t bucketCount = 256;
+    while (bucketCount < budget / 1024)
+    {
+        bucketCount *= 2;
+    }
+    cache->buckets = (TileCacheEntry**)GameCalloc(bucketCount, sizeof(TileCacheEntry*));
+    cache->bucketMask = bucketCount - 1;
+    cache->budget = budget;
+    return cache->buckets != NULL;
+}
+
+static void CacheUnlinkRecency(TileCache* cache, TileCacheEntry* entry)
+{
+    if (entry->newer != NULL) entry->newer->older = entry->older;
+    else cache->newest = entry->older;
+    if (entry->older != NULL) entry->older->newer = entry->newer;
+    else cache->oldest = entry->newer;
+}
+
+static void CacheLinkNewest(TileCache* cache, TileCacheEntry* entry)
+{
+    entry->newer = NULL;
+    entry->older = cache->newest;
+    if (cache->newest != NULL) cache->newest->newer = entry;
+    else cache->oldest = entry;
+    cache->newest = entry;
+}
+
+static void CacheEvict(TileCache* cache, TileCacheEntry* entry)
+{
+    TileCacheEntry** link = &cache->buckets[entry->hash & cache->bucketMask];
+    while (*link != entry)
+    {
+        link = &(*link)->bucketNext;
+    }
+    *link = entry->bucketNext;
+    CacheUnlinkRecency(cache, entry);
+    cache->bytes -= sizeof(TileCacheEntry) + entry->pngSize;
+    free(entry);
+}
+
+static TileCacheEntry* CacheFind(TileCache* cache, const TileKey* key, uint64_t hash)
+{
+    for (TileCacheEntry* entry = cache->buckets[hash & cache->bucketMask]; entry != NULL; entry = entry->bucketNext)
+    {
+        if (entry->hash == hash && TileKeyEqual(&entry->key, key))
+        {
+            CacheUnlinkRecency(cache, entry);
+            CacheLinkNewest(cache, entry);
+            cache->hits++;
+            return entry;
+        }
+    }
+    cache->misses++;
+    return NULL;
+}
+
+static void CacheInsert(TileCache* cache, const TileKey* key, uint64_t hash, const uint8_t* png, size_t pngSize)
+{
+    const size_t cost = sizeof(TileCacheEntry) + pngSize;
+    if (cost > cache->budget)
+    {
+        return;
+    }
+
+    // Two connections may have asked for the same tile before either was rendered
+    for (TileCacheEntry* entry = cache->buckets[hash & cache->bucketMask]; entry != NULL; entry = entry->bucketNext)
+    {
+        if (entry->hash == hash && TileKeyEqual(&entry->key, key))
+        {
+            return;
+        }
+    }
+
+    while (cache->bytes + cost > cache->budget)
+    {
+        CacheEvict(cache, cache->oldest);
+    }
+
+    TileCacheEntry* entry = (TileCacheEntry*)GameAlloc(cost);
+    if (entry == NULL)
+    {
+        return;
+    }
+    entry->key = *key;
+    entry->hash = hash;
+    entry->pngSize = pngSize;
+    memcpy(entry->png, png, pngSize);
+    entry->bucketNext = cache->buckets[hash & cache->bucketMask];
+    cache->buckets[hash & cache->bucketMask] = entry;
+    CacheLinkNewest(cache, entry);
+    cache->bytes += cost;
+}
+
+static void CacheRelease(TileCache* cache)
+{
+    while (cache->oldest != NULL)
+    {
+        CacheEvict(cache, cache->oldest);
+    }
+    free(cache->buckets);
+    memset(cache, 0, sizeof(*cache));
+}
+
+static void QueuePush(TileQueue* queue, TileJob* job)
+{
+    job->next = NULL;
+    if (queue->tail != NULL) queue->tail->next = job;
+    else queue->head = job;
+    queue->tail = job;
+}
+
+static TileJob* QueuePop(TileQueue* queue)
+{
+    TileJob* job = queue->head;
+    if (job != NULL)
+    {
+        queue->head = job->next;
+        if (queue->head == NULL) queue->tail = NULL;
+    }
+    return job;
+}
+
+static void* TileWorkerMain(void* argument)
+{
+    TileServer* server = (TileServer*)argument;
+    uint8_t* image = (uint8_t*)GameAlloc(TILE_IMAGE_BYTES);
+
+    pthread_mutex_lock(&server->mutex);
+    while (true)
+    {
+        while (!server->stopping && server->pending.head == NULL)
+        {
+            pthread_cond_wait(&server->jobReady, &server->mutex);
+        }
+        if (server->stopping)
+        {
+            break;
+        }
+        TileJob* job = QueuePop(&server->pending);
+        pthread_mutex_unlock(&server->mutex);
+
+        job->png = image != NULL ? (uint8_t*)GameAlloc(TILE_PNG_MAX_SIZE) : NULL;
+        job->pngSize = 0;
+        if (job->png != NULL)
+        {
+            RenderTile(&job->key, image);
+            job->pngSize = EncodeTilePng(image, job->png);
+        }
+
+        pthread_mutex_lock(&server->mutex);
+        QueuePush(&server->done, job);
+        const uint64_t one = 1;
+        (void)!write(server->wakeFd, &one, sizeof(one));
+    }
+    pthread_mutex_unlock(&server->mutex);
+
+    free(image);
+    return NULL;
+}
+
+// Path is /{seed}/{hp}/{vp}/{z}/{x}/{y}.png, anything after a '?' is ignored
+static bool ParseTilePath(const char* path, TileKey* key)
+{
+    char* end;
+    if (*path != '/') return false;
+    key->seed = strtoull(path + 1, &end, 0);
+    if (end == path + 1 || *end != '/') return false;
+    path = end + 1;
+    key->horizontalProbability = strtof(path, &end);
+    if (end == path || *end != '/') return false;
+    path = end + 1;
+    key->verticalProbability = strtof(path, &end);
+    if (end == path || *end != '/') return false;
+    path = end + 1;
+    key->zoom = (int)strtol(path, &end, 10);
+    if (end == path || *end != '/') return false;
+    path = end + 1;
+    key->x = strtoll(path, &end, 10);
+    if (end == path || *end != '/') return false;
+    path = end + 1;
+    key->y = strtoll(path, &end, 10);
+    if (end == path || strncmp(end, ".png", 4) != 0 || (end[4] != '\0' && end[4] != '?')) return false;
+
+    const int64_t maxIndex = INT64_MAX / TILE_SIZE;
+    return key->horizontalProbability >= 0.0f && key->horizontalProbability <= 1.0f
+        && key->verticalProbability >= 0.0f && key->verticalProbability <= 1.0f
+        && key->zoom >= TILE_MIN_ZOOM && key->zoom <= TILE_MAX_ZOOM
+        && key->x >= 0 && key->y >= 0 && key->x <= maxIndex && key->y <= maxIndex;
+}
+
+static bool ReserveResponse(TileConnection* connection, size_t size)
+{
+    if (size <= connection->responseCapacity)
+    {
+        return true;
+    }
+
+    const size_t grown = connection->responseCapacity + connection->responseCapacity / 2;
+    const size_t capacity = grown > size ? grown : size;
+    char* response = (char*)GameGrow(connection->response, capacity);
+    if (response == NULL)
+    {
+        return false;
+    }
+    connection->response = response;
+    connection->responseCapacity = capacity;
+    return true;
+}
+
+static void SetResponse(TileConnection* connection, int status, const char* reason, uint64_t etag, const uint8_t* png, size_t pngSize)
+{
+    char body[64];
+    const uint8_t* content = png;
+    size_t contentSize = pngSize;
+    if (status >= 400)
+    {
+        contentSize = (size_t)snprintf(body, sizeof(body), "%d %s\n", status, reason);
+        content = (const uint8_t*)body;
+    }
+
+    char head[512];
+    int headSize = snprintf(head, sizeof(head), "HTTP/1.1 %d %s\r\nServer: hitomezashi\r\nContent-Length: %zu\r\n", status, reason, contentSize);
+    if (status == 200 || status == 304)
+    {
+        headSize += snprintf(head + headSize, sizeof(head) - headSize,
+            "ETag: \"%016llx\"\r\nCache-Control: public, max-age=31536000, immutable\r\n", (unsigned long long)etag);
+    }
+    headSize += snprintf(head + headSize, sizeof(head) - headSize, "Content-Type: %s\r\nConnection: %s\r\n\r\n",
+        status == 200 ? "image/png" : "text/plain", connection->keepAlive ? "keep-alive" : "close");
+
+    if (connection->headOnly || status == 304)
+    {
+        contentSize = 0;
+    }
+    if (!ReserveResponse(connection, headSize + contentSize))
+    {
+        connection->keepAlive = false;
+        connection->responseSize = 0;
+        return;
+    }
+    memcpy(connection->response, head, headSize);
+    if (contentSize > 0)
+    {
+        memcpy(connection->response + headSize, content, contentSize);
+    }
+    connection->responseSize = headSize + contentSize;
+    connection->responseSent = 0;
+}
+
+static void CloseConnection(TileServer* server, TileConnection* connection)
+{
+    if (connection->closed)
+    {
+        return;
+    }
+
+    connection->closed = true;
+    epoll_ctl(server->epollFd, EPOLL_CTL_DEL, connection->fd, NULL);
+    close(connection->fd);
+    if (connection->previous != NULL) connection->previous->next = connection->next;
+    else server->connections = connection->next;
+    if (connection->next != NULL) connection->next->previous = connection->previous;
+
+    // A connection with a job in flight is freed when the job comes back
+    if (!connection->rendering)
+    {
+        connection->next = server->closedConnections;
+        server->closedConnections = connection;
+    }
+}
+
+static void FreeConnection(TileConnection* connection)
+{
+    free(connection->response);
+    free(connection);
+}
+
+static void WatchConnection(TileServer* server, TileConnection* connection)
+{
+    const bool sending = connection->responseSent < connection->responseSize;
+    const uint32_t events = connection->rendering ? 0 : (sending ? EPOLLOUT : EPOLLIN);
+    if (events != connection->watched)
+    {
+        struct epoll_event event = { .events = events, .data.ptr = connection };
+        epoll_ctl(server->epollFd, EPOLL_CTL_MOD, connection->fd, &event);
+        connection->watched = events;
+    }
+}
+
+// Parses and answers the first buffered request, false while it is still incomplete
+static bool HandleRequest(TileServer* server, TileConnection* connection)
+{
+    connection->request[connection->requestSize] = '\0';
+    char* headEnd = strstr(connection->request, "\r\n\r\n");
+    if (headEnd == NULL)
+    {
+        if (connection->requestSize < TILE_REQUEST_MAX - 1)
+        {
+            return false;
+        }
+        connection->keepAlive = false;
+        connection->headOnly = false;
+        SetResponse(connection, 431, "Request Header Fields Too Large", 0, NULL, 0);
+        connection->requestSize = 0;
+        return true;
+    }
+    *headEnd = '\0';
+
+    // Request line, then the two headers that matter here
+    char method[8] = { 0 };
+    char path[512] = { 0 };
+    int minorVersion = -1;
+    const bool parsed = sscanf(connection->request, "%7s %511s HTTP/1.%d", method, path, &minorVersion) == 3;
+    connection->keepAlive = minorVersion >= 1;
+    char ifNoneMatch[256] = { 0 };
+    for (char* line = strstr(connection->request, "\r\n"); line != NULL; line = strstr(line, "\r\n"))
+    {
+        line += 2;
+        if (strncasecmp(line, "Connection:", 11) == 0)
+        {
+            char* value = line + 11;
+            while (*value == ' ') value++;
+            if (strncasecmp(value, "close", 5) == 0) connection->keepAlive = false;
+            else if (strncasecmp(value, "keep-alive", 10) == 0) connection->keepAlive = true;
+        }
+        else if (strncasecmp(line, "If-None-Match:", 14) == 0)
+        {
+            char* end = strstr(line, "\r\n");
+            const size_t length = end != NULL ? (size_t)(end - line - 14) : strlen(line + 14);
+            memcpy(ifNoneMatch, line + 14, length < sizeof(ifNoneMatch) - 1 ? length : sizeof(ifNoneMatch) - 1);
+        }
+    }
+
+    const size_t consumed = (size_t)(headEnd + 4 - connection->request);
+    memmove(connection->request, connection->request + consumed, connection->requestSize - consumed);
+    connection->requestSize -= consumed;
+
+    connection->headOnly = strcmp(method, "HEAD") == 0;
+    TileKey key;
+    if (!parsed)
+    {
+        connection->keepAlive = false;
+        SetResponse(connection, 400, "Bad Request", 0, NULL, 0);
+        return true;
+    }
+    if (strcmp(method, "GET") != 0 && !connection->headOnly)
+    {
+        SetResponse(connection, 405, "Method Not Allowed", 0, NULL, 0);
+        return true;
+    }
+    if (!ParseTilePath(path, &key))
+    {
+        SetResponse(connection, 404, "Not Found", 0, NULL, 0);
+        return true;
+    }
+
+    const uint64_t hash = TileKeyHash(&key);
+    char etag[32];
+    snprintf(etag, sizeof(etag), "\"%016llx\"", (unsigned long long)hash);
+    if (strstr(ifNoneMatch, etag) != NULL || strchr(ifNoneMatch, '*') != NULL)
+    {
+        server->notModified++;
+        SetResponse(connection, 304, "Not Modified", hash, NULL, 0);
+        return true;
+    }
+
+    const TileCacheEntry* cached = CacheFind(&server->cache, &key, hash);
+    if (cached != NULL)
+    {
+        server->tilesServed++;
+        SetResponse(connection, 200, "OK", hash, cached->png, cached->pngSize);
+        return true;
+    }
+
+    TileJob* job = (TileJob*)GameAlloc(sizeof(TileJob));
+    if (job == NULL)
+    {
+        SetResponse(connection, 503, "Service Unavailable", 0, NULL, 0);
+        return true;
+    }
+    job->key = key;
+    job->hash = hash;
+    job->connection = connection;
+    connection->rendering = true;
+    pthread_mutex_lock(&server->mutex);
+    QueuePush(&server->pending, job);
+    pthread_cond_signal(&server->jobReady);
+    pthread_mutex_unlock(&server->mutex);
+    return true;
+}
+
+// Answers buffered requests until one has to wait for a worker or for the socket to drain
+static void ServeConnection(TileServer* server, TileConnection* connection)
+{
+    while (!connection->rendering)
+    {
+        while (connection->responseSent < connection->responseSize)
+        {
+            const ssize_t sent = send(connection->fd, connection->response + connection->responseSent,
+                connection->responseSize - connection->responseSent, MSG_NOSIGNAL);
+            if (sent > 0)
+            {
+                connection->responseSent += (size_t)sent;
+            }
+            else if (sent < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            {
+                WatchConnection(server, connection);
+                return;
+            }
+            else
+            {
+                CloseConnection(server, connection);
+                return;
+            }
+        }
+
+        if (connection->responseSize > 0)
+        {
+            connection->responseSize = 0;
+            connection->responseSent = 0;
+            if (!connection->keepAlive)
+            {
+                CloseConnection(server, connection);
+                return;
+            }
+        }
+
+        if (!HandleRequest(server, connection))
+        {
+            break;
+        }
+    }
+    WatchConnection(server, connection);
+}
+
+static void ReadConnection(TileServer* server, TileConnection* connection)
+{
+    while (connection->requestSize < TILE_REQUEST_MAX - 1)
+    {
+        const ssize_t received = recv(connection->fd, connection->request + connection->requestSize, TILE_REQUEST_MAX - 1 - connection->requestSize, 0);
+        if (received > 0)
+        {
+            connection->requestSize += (size_t)received;
+        }
+        else if (received < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        else if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            break;
+        }
+        else
+        {
+            CloseConnection(server, connection);
+            return;
+        }
+    }
+    ServeConnection(server, connection);
+}
+
+static void AcceptConnections(TileServer* server)
+{
+    while (true)
+    {
+        const int fd = accept4(server->listenFd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+            {
+                continue;
+            }
+            return;
+        }
+
+        if (!server->unixSocket)
+        {
+            const int noDelay = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        }
+
+        TileConnection* connection = (TileConnection*)GameCalloc(1, sizeof(TileConnection));
+        struct epoll_event event = { .events = EPOLLIN, .data.ptr = connection };
+        if (connection == NULL || epoll_ctl(server->epollFd, EPOLL_CTL_ADD, fd, &event) != 0)
+        {
+            free(connection);
+            close(fd);
+            continue;
+        }
+        connection->fd = fd;
+        connection->watched = EPOLLIN;
+        connection->next = server->connections;
+        if (server->connections != NULL) server->connections->previous = connection;
+        server->connections = connection;
+    }
+}
+
+static void CollectRenderedTiles(TileServer* server)
+{
+    uint64_t count;
+    while (read(server->wakeFd, &count, sizeof(count)) > 0)
+    {
+    }
+
+    pthread_mutex_lock(&server->mutex);
+    TileJob* job = server->done.head;
+    server->done.head = NULL;
+    server->done.tail = NULL;
+    pthread_mutex_unlock(&server->mutex);
+
+    while (job != NULL)
+    {
+        TileJob* next = job->next;
+        TileConnection* connection = job->connection;
+        if (job->png != NULL)
+        {
+            CacheInsert(&server->cache, &job->key, job->hash, job->png, job->pngSize);
+        }
+
+        connection->rendering = false;
+        if (connection->closed)
+        {
+            FreeConnection(connection);
+        }
+        else
+        {
+            if (job->png != NULL)
+            {
+                server->tilesServed++;
+                SetResponse(connection, 200, "OK", job->hash, job->png, job->pngSize);
+            }
+            else
+            {
+                SetResponse(connection, 500, "Internal Server Error", 0, NULL, 0);
+            }
+            ServeConnection(server, connection);
+        }
+
+        free(job->png);
+        free(job);
+        job = next;
+    }
+}
+
+static void FreeClosedConnections(TileServer* server)
+{
+    while (server->closedConnections != NULL)
+    {
+        TileConnection* next = server->closedConnections->next;
+        FreeConnection(server->closedConnections);
+        server->closedConnections = next;
+    }
+}
+
+int TileSocketOpen(const char* address, bool listening)
+{
+    const bool unixSocket = strchr(address, '/') != NULL;
+    struct sockaddr_un unixAddress = { .sun_family = AF_UNIX };
+    struct sockaddr_in inetAddress = { .sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK) };
+    if (unixSocket)
+    {
+        if (strlen(address) >= sizeof(unixAddress.sun_path))
+        {
+            return -1;
+        }
+        strcpy(unixAddress.sun_path, address);
+    }
+    else
+    {
+        const int port = atoi(address);
+        if (port <= 0 || port > 65535)
+        {
+            return -1;
+        }
+        inetAddress.sin_port = htons((uint16_t)port);
+    }
+
+    const int fd = socket(unixSocket ? AF_UNIX : AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    const struct sockaddr* socketAddress = unixSocket ? (const struct sockaddr*)&unixAddress : (const struct sockaddr*)&inetAddress;
+    const socklen_t socketAddressSize = unixSocket ? (socklen_t)sizeof(unixAddress) : (socklen_t)sizeof(inetAddress);
+    const int enabled = 1;
+    bool opened;
+    if (listening)
+    {
+        if (unixSocket)
+        {
+            unlink(address); // Stale socket of a previous run
+        }
+        else
+        {
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enabled, sizeof(enabled));
+        }
+        opened = bind(fd, socketAddress, socketAddressSize) == 0 && listen(fd, TILE_LISTEN_BACKLOG) == 0;
+    }
+    else
+    {
+        if (!unixSocket)
+        {
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enabled, sizeof(enabled));
+        }
+        opened = connect(fd, socketAddress, socketAddressSize) == 0 || errno == EINPROGRESS;
+    }
+
+    if (!opened)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void ReleaseTileServer(TileServer* server)
+{
+    pthread_mutex_lock(&server->mutex);
+    server->stopping = true;
+    pthread_cond_broadcast(&server->jobReady);
+    pthread_mutex_unlock(&server->mutex);
+    for (int i = 0; i < server->workerCount; ++i)
+    {
+        pthread_join(server->workers[i], NULL);
+    }
+    free(server->workers);
+
+    // Jobs that were never collected still own their connections
+    TileQueue* queues[2] = { &server->pending, &server->done };
+    for (int i = 0; i < 2; ++i)
+    {
+        for (TileJob* job = QueuePop(queues[i]); job != NULL; job = QueuePop(queues[i]))
+        {
+            job->connection->rendering = false;
+            if (job->connection->closed)
+            {
+                FreeConnection(job->connection);
+            }
+            free(job->png);
+            free(job);
+        }
+    }
+    while (server->connections != NULL)
+    {
+        CloseConnection(server, server->connections);
+    }
+    FreeClosedConnections(server);
+
+    CacheRelease(&server->cache);
+    pthread_cond_destroy(&server->jobReady);
+    pthread_mutex_destroy(&server->mutex);
+    if (server->wakeFd >= 0) close(server->wakeFd);
+    if (server->epollFd >= 0) close(server->epollFd);
+    if (server->listenFd >= 0) close(server->listenFd);
+}
+
+bool TileServerRun(const TileServerConfig* config)
+{
+    TileServer server = { .listenFd = -1, .epollFd = -1, .wakeFd = -1 };
+    InitCrcTable();
+    pthread_mutex_init(&server.mutex, NULL);
+    pthread_cond_init(&server.jobReady, NULL);
+    server.unixSocket = strchr(config->address, '/') != NULL;
+    server.listenFd = TileSocketOpen(config->address, true);
+    server.epollFd = epoll_create1(EPOLL_CLOEXEC);
+    server.wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    struct epoll_event listenEvent = { .events = EPOLLIN, .data.ptr = &server.listenFd };
+    struct epoll_event wakeEvent = { .events = EPOLLIN, .data.ptr = &server.wakeFd };
+    bool started = server.listenFd >= 0 && server.epollFd >= 0 && server.wakeFd >= 0 && CacheInit(&server.cache, config->cacheBytes)
+        && epoll_ctl(server.epollFd, EPOLL_CTL_ADD, server.listenFd, &listenEvent) == 0
+        && epoll_ctl(server.epollFd, EPOLL_CTL_ADD, server.wakeFd, &wakeEvent) == 0;
+
+    const long cpuCount = sysconf(_SC_NPROCESSORS_ONLN);
+    const int workerCount = config->workerCount > 0 ? config->workerCount : (cpuCount > 0 ? (int)cpuCount : 1);
+    server.workers = started ? (pthread_t*)GameAlloc(workerCount * sizeof(pthread_t)) : NULL;
+    for (int i = 0; started && i < workerCount; ++i)
+    {
+        started = server.workers != NULL && pthread_create(&server.workers[i], NULL, TileWorkerMain, &server) == 0;
+        server.workerCount += started;
+    }
+    if (!started)
+    {
+        TraceLog(LOG_WARNING, "TILES: Failed to start the server on %s", config->address);
+        ReleaseTileServer(&server);
+        return false;
+    }
+
+    struct sigaction stopAction = { .sa_handler = StopTileServer };
+    sigemptyset(&stopAction.sa_mask);
+    sigaction(SIGINT, &stopAction, NULL);
+    sigaction(SIGTERM, &stopAction, NULL);
+    TraceLog(LOG_INFO, "TILES: Serving %dx%d tiles on %s, %d workers, %zu MB cache", TILE_SIZE, TILE_SIZE, config->address,
+        server.workerCount, config->cacheBytes >> 20);
+
+    struct epoll_event events[TILE_MAX_EVENTS];
+    while (!tileServerStop)
+    {
+        const int eventCount = epoll_wait(server.epollFd, events, TILE_MAX_EVENTS, -1);
+        if (eventCount < 0 && errno != EINTR)
+        {
+            break;
+        }
+
+        for (int i = 0; i < eventCount; ++i)
+        {
+            if (events[i].data.ptr == &server.listenFd)
+            {
+                AcceptConnections(&server);
+            }
+            else if (events[i].data.ptr == &server.wakeFd)
+            {
+                CollectRenderedTiles(&server);
+            }
+            else
+            {
+                TileConnection* connection = (TileConnection*)events[i].data.ptr;
+                if (connection->closed)
+                {
+                    continue;
+                }
+                if ((events[i].events & (EPOLLERR | EPOLLHUP)) != 0)
+                {
+                    CloseConnection(&server, connection);
+                }
+                else if ((events[i].events & EPOLLIN) != 0)
+                {
+                    ReadConnection(&server, connection);
+                }
+                else if ((events[i].events & EPOLLOUT) != 0)
+                {
+                    ServeConnection(&server, connection);
+                }
+            }
+        }
+        FreeClosedConnections(&server);
+    }
+
+    TraceLog(LOG_INFO, "TILES: Served %llu tiles, %llu cache hits, %llu misses, %llu not modified",
+        (unsigned long long)server.tilesServed, (unsigned long long)server.cache.hits,
+        (unsigned long long)server.cache.misses, (unsigned long long)server.notModified);
+    ReleaseTileServer(&server);
+    if (server.unixSocket)
+    {
+        unlink(config->address);
+    }
+    tileServerStop = 0;
+    return true;
+}
+
+#else
+
+bool TileServerRun(const TileServerConfig* config)
+{
+    (void)config;
+    TraceLog(LOG_WARNING, "TILES: The tile server is only available on Linux");
+    return false;
+}
+
+int TileSocketOpen(const char* address, bool listening)
+{
+    (void)address;
+    (void)listening;
+    return -1;
+}
+
+#endif
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "stdbool.h"
+#include "stddef.h"
+#include "stdint.h"
+
+// Headless tile server for web backgrounds. Tiles are addressed as /{seed}/{hp}/{vp}/{z}/{x}/{y}.png,
+// where seed is the generator seed as stored in pattern files and z sets the cell size to 2^z pixels.
+// Stitch i of a sequence is GeneratorStitch(seed, axis, i, probability), so any tile is rendered on its
+// own and the same URL always gives the same image, which also makes the ETag a hash of the URL.
+// Only Linux is supported: the server is an epoll loop with a worker pool for rendering and PNG encoding.
+#define TILE_SIZE 256
+#define TILE_MIN_ZOOM 1
+#define TILE_MAX_ZOOM 7
+#define TILE_FORMAT_VERSION 1 // Part of the ETag, bump when the rendering changes
+
+typedef struct TileServerConfig_t
+{
+    const char* address;  // UNIX socket path when it contains a '/', otherwise a loopback TCP port
+    int workerCount;      // 0 for one per CPU
+    size_t cacheBytes;    // Budget of the encoded tile cache
+} TileServerConfig;
+
+typedef struct TileBenchmarkConfig_t
+{
+    const char* address;
+    int connectionCount;  // Each connection keeps one request in flight
+    double seconds;
+    int tileCount;        // Distinct tiles requested, smaller than the cache for a hit benchmark
+} TileBenchmarkConfig;
+
+bool TileServerRun(const TileServerConfig* config); // Blocks until SIGINT or SIGTERM
+bool TileBenchmarkRun(const TileBenchmarkConfig* config);
+
+int TileSocketOpen(const char* address, bool listening); // Non-blocking socket, -1 on failure
@@ -0,0 +1,176 @@
+#include "timeline.h"
+
+#include "stdlib.h"
+#include "string.h"
+
+#include "bits.h"
+#include "gamealloc.h"
+
+static bool StitchAfter(const Timeline* timeline, SequenceAxis axis, int index, uint64_t horizontalSteps, uint64_t verticalSteps)
+{
+    if (axis == SEQUENCE_HORIZONTAL)
+    {
+        const bool othersParity = (verticalSteps & 1) != 0;
+        if ((uint64_t)index < horizontalSteps)
+        {
+            const int64_t origin = timeline->start.horizontalOrigin + (int64_t)horizontalSteps;
+            return GeneratorStitch(timeline->seed, SEQUENCE_HORIZONTAL, index - origin, timeline->horizontalProbability) ^ timeline->start.horizontalFlipped ^ othersParity;
+        }
+        return timeline->horizontalStart[index - horizontalSteps] ^ othersParity;
+    }
+
+    const bool othersParity = (horizontalSteps & 1) != 0;
+    if ((uint64_t)index < verticalSteps)
+    {
+        const int64_t origin = timeline->start.verticalOrigin + (int64_t)verticalSteps;
+        return GeneratorStitch(timeline->seed, SEQUENCE_VERTICAL, index - origin, timeline->verticalProbability) ^ timeline->start.verticalFlipped ^ othersParity;
+    }
+    return timeline->verticalStart[index - verticalSteps] ^ othersParity;
+}
+
+// Same rule as the fill after a scroll: the origin keeps its island when the stitch that moved next to it allows
+static int NextOriginIsland(const Timeline* timeline, int originIsland, SequenceAxis axis, uint64_t horizontalSteps, uint64_t verticalSteps)
+{
+    if (!timeline->colored)
+    {
+        return originIsland;
+    }
+    if (originIsland == 0)
+    {
+        return 2;
+    }
+
+    const int length = axis == SEQUENCE_HORIZONTAL ? timeline->gridWidth : timeline->gridHeight;
+    const bool keep = length > 1 && StitchAfter(timeline, axis, 1, horizontalSteps, verticalSteps);
+    return keep ? originIsland : originIsland ^ 6;
+}
+
+// Horizontal step count and origin island after the given step, from the closest checkpoint before it
+static void Replay(const Timeline* timeline, uint64_t step, uint64_t* horizontalSteps, int* originIsland)
+{
+    const TimelineCheckpoint* checkpoint = &timeline->checkpoints[step / TIMELINE_CHECKPOINT_INTERVAL];
+    *horizontalSteps = checkpoint->horizontalSteps;
+    *originIsland = checkpoint->originIsland;
+    for (uint64_t s = step - step % TIMELINE_CHECKPOINT_INTERVAL; s < step; ++s)
+    {
+        const SequenceAxis axis = BitGet(timeline->axisBits, s) ? SEQUENCE_VERTICAL : SEQUENCE_HORIZONTAL;
+        *horizontalSteps += axis == SEQUENCE_HORIZONTAL;
+        *originIsland = NextOriginIsland(timeline, *originIsland, axis, *horizontalSteps, s + 1 - *horizontalSteps);
+    }
+}
+
+bool TimelineBegin(Timeline* timeline, const TimelinePattern* pattern)
+{
+    TimelineRelease(timeline);
+    timeline->seed = pattern->seed;
+    timeline->horizontalProbability = pattern->horizontalProbability;
+    timeline->verticalProbability = pattern->verticalProbability;
+    timeline->colored = pattern->colored;
+    timeline->diagonal = pattern->diagonal;
+    timeline->start = pattern->state;
+    timeline->gridWidth = pattern->gridWidth;
+    timeline->gridHeight = pattern->gridHeight;
+    timeline->originIsland = pattern->state.originIsland;
+    timeline->stepCapacity = TIMELINE_CHECKPOINT_INTERVAL;
+
+    timeline->horizontalStart = (bool*)GameAlloc(pattern->gridWidth * sizeof(bool));
+    timeline->verticalStart = (bool*)GameAlloc(pattern->gridHeight * sizeof(bool));
+    timeline->axisBits = (uint64_t*)GameAlloc(BitWordCount(timeline->stepCapacity) * sizeof(uint64_t));
+    timeline->checkpoints = (TimelineCheckpoint*)GameAlloc((timeline->stepCapacity / TIMELINE_CHECKPOINT_INTERVAL + 1) * sizeof(TimelineCheckpoint));
+    if (timeline->horizontalStart == NULL || timeline->verticalStart == NULL || timeline->axisBits == NULL || timeline->checkpoints == NULL)
+    {
+        TimelineRelease(timeline);
+        return false;
+    }
+
+    memcpy(timeline->horizontalStart, pattern->horizontalSequence, pattern->gridWidth * sizeof(bool));
+    memcpy(timeline->verticalStart, pattern->verticalSequence, pattern->gridHeight * sizeof(bool));
+    timeline->checkpoints[0] = (TimelineCheckpoint){ .horizontalSteps = 0, .originIsland = pattern->state.originIsland };
+    return true;
+}
+
+void TimelineRelease(Timeline* timeline)
+{
+    free(timeline->horizontalStart);
+    free(timeline->verticalStart);
+    free(timeline->axisBits);
+    free(timeline->checkpoints);
+    memset(timeline, 0, sizeof(*timeline));
+}
+
+bool TimelineAppend(Timeline* timeline, SequenceAxis axis)
+{
+    if (timeline->axisBits == NULL)
+    {
+        return false;
+    }
+
+    if (timeline->stepCount == timeline->stepCapacity)
+    {
+        // Capacity stays a multiple of the checkpoint interval, so the checkpoint array always has room
+        const uint64_t capacity = timeline->stepCapacity * 2;
+        uint64_t* axisBits = (uint64_t*)GameGrow(timeline->axisBits, BitWordCount(capacity) * sizeof(uint64_t));
+        if (axisBits == NULL)
+        {
+            return false;
+        }
+        timeline->axisBits = axisBits;
+
+        TimelineCheckpoint* checkpoints = (TimelineCheckpoint*)GameGrow(timeline->checkpoints, (capacity / TIMELINE_CHECKPOINT_INTERVAL + 1) * sizeof(TimelineCheckpoint));
+        if (checkpoints == NULL)
+        {
+            return false;
+        }
+        timeline->checkpoints = checkpoints;
+        timeline->stepCapacity = capacity;
+    }
+
+    BitSet(timeline->axisBits, timeline->stepCount, axis == SEQUENCE_VERTICAL);
+    timeline->stepCount++;
+    timeline->horizontalSteps += axis == SEQUENCE_HORIZONTAL;
+    timeline->originIsland = NextOriginIsland(timeline, timeline->originIsland, axis, timeline->horizontalSteps, timeline->stepCount - timeline->horizontalSteps);
+    if (timeline->stepCount % TIMELINE_CHECKPOINT_INTERVAL == 0)
+    {
+        timeline->checkpoints[timeline->stepCount / TIMELINE_CHECKPOINT_INTERVAL] = (TimelineCheckpoint){
+            .horizontalSteps = timeline->horizontalSteps,
+            .originIsland = timeline->originIsland,
+        };
+    }
+    return true;
+}
+
+void TimelineTruncate(Timeline* timeline, uint64_t stepCount)
+{
+    if (stepCount < timeline->stepCount)
+    {
+        Replay(timeline, stepCount, &timeline->horizontalSteps, &timeline->originIsland);
+        timeline->stepCount = stepCount;
+    }
+}
+
+TimelineState TimelineSeek(const Timeline* timeline, uint64_t step, bool* horizontalSequence, bool* verticalSequence)
+{
+    step = step < timeline->stepCount ? step : timeline->stepCount;
+    uint64_t horizontalSteps;
+    int originIsland;
+    Replay(timeline, step, &horizontalSteps, &originIsland);
+    const uint64_t verticalSteps = step - horizontalSteps;
+
+    for (int i = 0; i < timeline->gridWidth; ++i)
+    {
+        horizontalSequence[i] = StitchAfter(timeline, SEQUENCE_HORIZONTAL, i, horizontalSteps, verticalSteps);
+    }
+    for (int i = 0; i < timeline->gridHeight; ++i)
+    {
+        verticalSequence[i] = StitchAfter(timeline, SEQUENCE_VERTICAL, i, horizontalSteps, verticalSteps);
+    }
+
+    return (TimelineState){
+        .horizontalOrigin = timeline->start.horizontalOrigin + (int64_t)horizontalSteps,
+        .verticalOrigin = timeline->start.verticalOrigin + (int64_t)verticalSteps,
+        .horizontalFlipped = timeline->start.horizontalFlipped ^ ((verticalSteps & 1) != 0),
+        .verticalFlipped = timeline->start.verticalFlipped ^ ((horizontalSteps & 1) != 0),
+        .diagonalScrollDirection = timeline->diagonal ? timeline->start.diagonalScrollDirection ^ (int)(step & 1) : timeline->start.diagonalScrollDirection,
+        .originIsland = originIsland,
+    };
+}
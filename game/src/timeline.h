@@ -0,0 +1,73 @@
+#pragma once
+
+#include "stdbool.h"
+#include "stdint.h"
+
+#include "generator.h"
+
+// Random access history of scroll steps. A step only shifts one new stitch into a sequence and flips
+// the other one, and new stitches come from the generator, so a step is stored as the single bit of
+// the axis it scrolled. After H horizontal and V vertical steps stitch i of the horizontal sequence is
+//     i < H ? GeneratorStitch(seed, horizontal, i - origin) ^ flipped : start[i - H] ^ (V & 1)
+// and seeking rebuilds the sequences in O(width + height). Only the island of cell (0, 0) depends on
+// every step, it is checkpointed every TIMELINE_CHECKPOINT_INTERVAL steps and replayed from there.
+#define TIMELINE_CHECKPOINT_INTERVAL 4096
+
+typedef struct TimelineState_t
+{
+    int64_t horizontalOrigin;
+    int64_t verticalOrigin;
+    bool horizontalFlipped;
+    bool verticalFlipped;
+    int diagonalScrollDirection;
+    int originIsland; // 0 until the first colored step, then 2 or 4
+} TimelineState;
+
+typedef struct TimelinePattern_t
+{
+    const bool* horizontalSequence;
+    int gridWidth;
+    const bool* verticalSequence;
+    int gridHeight;
+    uint64_t seed;
+    float horizontalProbability;
+    float verticalProbability;
+    bool colored;
+    bool diagonal; // Shift updates alternate the scroll direction, scroll updates keep it
+    TimelineState state;
+} TimelinePattern;
+
+typedef struct TimelineCheckpoint_t
+{
+    uint64_t horizontalSteps;
+    int originIsland;
+} TimelineCheckpoint;
+
+typedef struct Timeline_t
+{
+    uint64_t seed;
+    float horizontalProbability;
+    float verticalProbability;
+    bool colored;
+    bool diagonal;
+    TimelineState start;
+    bool* horizontalStart;
+    int gridWidth;
+    bool* verticalStart;
+    int gridHeight;
+
+    uint64_t* axisBits; // Bit s is set when step s + 1 scrolled the vertical sequence
+    TimelineCheckpoint* checkpoints; // State after every TIMELINE_CHECKPOINT_INTERVAL steps, checkpoint 0 is the start
+    uint64_t stepCount;
+    uint64_t stepCapacity;
+    uint64_t horizontalSteps;
+    int originIsland;
+} Timeline;
+
+bool TimelineBegin(Timeline* timeline, const TimelinePattern* pattern); // Releases any previous history
+void TimelineRelease(Timeline* timeline);
+bool TimelineAppend(Timeline* timeline, SequenceAxis axis);
+void TimelineTruncate(Timeline* timeline, uint64_t stepCount);
+
+// Rebuilds the sequences after the given step into the buffers (gridWidth and gridHeight long)
+TimelineState TimelineSeek(const Timeline* timeline, uint64_t step, bool* horizontalSequence, bool* verticalSequence);
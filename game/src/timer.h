@@ -0,0 +1,6 @@
+#pragma once
+
+#include "stdint.h"
+
+// Monotonic high resolution clock, independent of raylib's GetTime()
+uint64_t GetMonotonicTimeNs(void);
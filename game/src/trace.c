@@ -0,0 +1,189 @@
+#include "trace.h"
+
+#include "stdint.h"
+#include "stdio.h"
+#include "stdlib.h"
+
+#include "gamealloc.h"
+#include "rlgl.h"
+#include "timer.h"
+
+#define TRACE_BUFFER_EVENT_COUNT (1 << 16)
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define TRACE_THREAD_LOCAL __declspec(thread)
+#define AtomicLoadAcquire(ptr) _InterlockedOr((volatile long*)(ptr), 0)
+#define AtomicStoreRelease(ptr, value) _InterlockedExchange((volatile long*)(ptr), (long)(value))
+#define AtomicIncrement(ptr) _InterlockedIncrement((volatile long*)(ptr))
+#define AtomicLoadPointer(ptr) _InterlockedCompareExchangePointer((void* volatile*)(ptr), NULL, NULL)
+#define AtomicCasPointer(ptr, expected, desired) (_InterlockedCompareExchangePointer((void* volatile*)(ptr), (desired), (expected)) == (expected))
+#else
+#define TRACE_THREAD_LOCAL _Thread_local
+#define AtomicLoadAcquire(ptr) __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define AtomicStoreRelease(ptr, value) __atomic_store_n((ptr), (value), __ATOMIC_RELEASE)
+#define AtomicIncrement(ptr) __atomic_add_fetch((ptr), 1, __ATOMIC_RELAXED)
+#define AtomicLoadPointer(ptr) __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define AtomicCasPointer(ptr, expected, desired) __atomic_compare_exchange_n((ptr), &(expected), (desired), false, __ATOMIC_RELEASE, __ATOMIC_RELAXED)
+#endif
+
+typedef struct TraceEvent_t
+{
+    const char* name;
+    uint64_t timestampNs;
+    bool begin;
+} TraceEvent;
+
+// Written only by its owning thread, count is published with release semantics so the dump sees complete events
+typedef struct TraceBuffer_t
+{
+    struct TraceBuffer_t* next;
+    long threadId;
+    long epoch;
+    long count;
+    long dropped;
+    TraceEvent events[TRACE_BUFFER_EVENT_COUNT];
+} TraceBuffer;
+
+volatile bool traceCapturing = false;
+
+static TraceBuffer* traceBuffers = NULL; // Lock-free list of every thread's buffer, only ever pushed to
+static long traceThreadCounter = 0;
+static long traceEpoch = 0;
+static uint64_t traceStartNs = 0;
+static TRACE_THREAD_LOCAL TraceBuffer* threadBuffer = NULL;
+
+static TraceBuffer* AcquireThreadBuffer(void)
+{
+    if (threadBuffer == NULL)
+    {
+        TraceBuffer* buffer = (TraceBuffer*)GameCalloc(1, sizeof(TraceBuffer));
+        if (buffer == NULL)
+        {
+            return NULL;
+        }
+        buffer->threadId = AtomicIncrement(&traceThreadCounter);
+        buffer->epoch = -1;
+
+        for (;;)
+        {
+            TraceBuffer* head = (TraceBuffer*)AtomicLoadPointer(&traceBuffers);
+            buffer->next = head;
+            if (AtomicCasPointer(&traceBuffers, head, buffer))
+            {
+                break;
+            }
+        }
+        threadBuffer = buffer;
+    }
+
+    // A new capture invalidates what the previous one left behind
+    const long epoch = AtomicLoadAcquire(&traceEpoch);
+    if (threadBuffer->epoch != epoch)
+    {
+        threadBuffer->dropped = 0;
+        AtomicStoreRelease(&threadBuffer->count, 0);
+        AtomicStoreRelease(&threadBuffer->epoch, epoch);
+    }
+    return threadBuffer;
+}
+
+void TraceZone(const char* name, bool begin)
+{
+    const uint64_t now = GetMonotonicTimeNs();
+    TraceBuffer* buffer = AcquireThreadBuffer();
+    if (buffer == NULL)
+    {
+        return;
+    }
+
+    const long count = buffer->count;
+    if (count >= TRACE_BUFFER_EVENT_COUNT)
+    {
+        buffer->dropped++;
+        return;
+    }
+    buffer->events[count] = (TraceEvent){ .name = name, .timestampNs = now, .begin = begin };
+    AtomicStoreRelease(&buffer->count, count + 1);
+}
+
+static void RaylibTraceZone(const char* name, bool begin)
+{
+    TraceZone(name, begin);
+}
+
+void TraceStartCapture(void)
+{
+    if (traceCapturing)
+    {
+        return;
+    }
+    traceStartNs = GetMonotonicTimeNs();
+    AtomicIncrement(&traceEpoch);
+    AcquireThreadBuffer(); // The first zone of the starting thread would allocate it in the middle of a frame
+    rlSetTraceZoneCallback(RaylibTraceZone);
+    traceCapturing = true;
+}
+
+static void WriteEscapedName(FILE* file, const char* name)
+{
+    for (const char* c = name; *c != '\0'; ++c)
+    {
+        if (*c == '"' || *c == '\\')
+        {
+            fputc('\\', file);
+        }
+        fputc(*c, file);
+    }
+}
+
+bool TraceStopCapture(const char* fileName)
+{
+    if (!traceCapturing)
+    {
+        return false;
+    }
+    traceCapturing = false;
+    rlSetTraceZoneCallback(NULL);
+
+    FILE* file = fopen(fileName, "w");
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    // NOTE: Worker threads may still be finishing an event, only the published count is read
+    const long epoch = AtomicLoadAcquire(&traceEpoch);
+    bool first = true;
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (TraceBuffer* buffer = (TraceBuffer*)AtomicLoadPointer(&traceBuffers); buffer != NULL; buffer = buffer->next)
+    {
+        if (AtomicLoadAcquire(&buffer->epoch) != epoch)
+        {
+            continue;
+        }
+
+        const long count = AtomicLoadAcquire(&buffer->count);
+        for (long i = 0; i < count; ++i)
+        {
+            const TraceEvent* event = &buffer->events[i];
+            const uint64_t relativeNs = event->timestampNs > traceStartNs ? event->timestampNs - traceStartNs : 0;
+            fprintf(file, "%s{\"name\":\"", first ? "" : ",\n");
+            WriteEscapedName(file, event->name);
+            fprintf(file, "\",\"ph\":\"%c\",\"ts\":%llu.%03llu,\"pid\":1,\"tid\":%ld}",
+                event->begin ? 'B' : 'E',
+                (unsigned long long)(relativeNs / 1000), (unsigned long long)(relativeNs % 1000),
+                buffer->threadId);
+            first = false;
+        }
+        if (buffer->dropped > 0)
+        {
+            fprintf(file, "%s{\"name\":\"dropped %ld events\",\"ph\":\"i\",\"s\":\"t\",\"ts\":0,\"pid\":1,\"tid\":%ld}",
+                first ? "" : ",\n", buffer->dropped, buffer->threadId);
+            first = false;
+        }
+    }
+    fprintf(file, "\n]}\n");
+    fclose(file);
+    return true;
+}
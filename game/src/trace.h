@@ -0,0 +1,23 @@
+#pragma once
+
+#include "stdbool.h"
+
+// Chrome Trace Event recorder, the output loads in chrome://tracing and Perfetto.
+// Events go to per-thread buffers without locks; when no capture is running every
+// marker costs one well predicted branch.
+
+#if defined(__GNUC__) || defined(__clang__)
+#define TRACE_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#else
+#define TRACE_UNLIKELY(x) (x)
+#endif
+
+extern volatile bool traceCapturing;
+
+void TraceZone(const char* name, bool begin); // Name must be a string literal or otherwise outlive the capture
+
+#define TRACE_BEGIN(name) do { if (TRACE_UNLIKELY(traceCapturing)) TraceZone(name, true); } while (0)
+#define TRACE_END(name) do { if (TRACE_UNLIKELY(traceCapturing)) TraceZone(name, false); } while (0)
+
+void TraceStartCapture(void);
+bool TraceStopCapture(const char* fileName); // Stops the capture and writes the JSON file
@@ -0,0 +1,130 @@
+#include "workpool.h"
+
+#include "stdlib.h"
+#include "string.h"
+
+#include "gamealloc.h"
+
+// NOTE: This file must not include raylib.h, windows.h clashes with it
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+typedef HANDLE WorkThread;
+#else
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+typedef pthread_t WorkThread;
+#endif
+
+static void RunJobs(WorkPool* pool)
+{
+    const int threadIndex = (int)WorkPoolAdd(&pool->nextThread, 1) - 1;
+    while (WorkPoolLoad(&pool->cancelled) == 0)
+    {
+        const long jobIndex = WorkPoolAdd(&pool->nextJob, 1) - 1;
+        if (jobIndex >= pool->jobCount)
+        {
+            break;
+        }
+        pool->job(pool->context, (int)jobIndex, threadIndex);
+    }
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI WorkerMain(LPVOID argument)
+{
+    RunJobs((WorkPool*)argument);
+    return 0;
+}
+#else
+static void* WorkerMain(void* argument)
+{
+    RunJobs((WorkPool*)argument);
+    return NULL;
+}
+#endif
+
+int WorkPoolDefaultThreadCount(void)
+{
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    const int count = (int)info.dwNumberOfProcessors;
+#else
+    const int count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return count < 1 ? 1 : (count > WORK_POOL_MAX_THREADS ? WORK_POOL_MAX_THREADS : count);
+}
+
+bool WorkPoolStart(WorkPool* pool, int threadCount, int jobCount, WorkPoolJob job, void* context)
+{
+    memset(pool, 0, sizeof(*pool));
+    threadCount = threadCount > 0 ? threadCount : WorkPoolDefaultThreadCount();
+    threadCount = threadCount < jobCount ? threadCount : jobCount;
+    WorkThread* threads = (WorkThread*)GameAlloc((threadCount > 0 ? threadCount : 1) * sizeof(WorkThread));
+    if (threads == NULL)
+    {
+        return false;
+    }
+
+    pool->threads = threads;
+    pool->job = job;
+    pool->context = context;
+    pool->jobCount = jobCount;
+    for (int i = 0; i < threadCount; ++i)
+    {
+#if defined(_WIN32)
+        threads[i] = CreateThread(NULL, 0, WorkerMain, pool, 0, NULL);
+        const bool started = threads[i] != NULL;
+#else
+        const bool started = pthread_create(&threads[i], NULL, WorkerMain, pool) == 0;
+#endif
+        if (!started)
+        {
+            break;
+        }
+        pool->threadCount++;
+    }
+
+    if (pool->threadCount == 0 && jobCount > 0)
+    {
+        free(threads);
+        pool->threads = NULL;
+        return false;
+    }
+    return true;
+}
+
+void WorkPoolWait(WorkPool* pool, bool cancel)
+{
+    if (cancel)
+    {
+        WorkPoolAdd(&pool->cancelled, 1);
+    }
+
+    WorkThread* threads = (WorkThread*)pool->threads;
+    for (int i = 0; i < pool->threadCount; ++i)
+    {
+#if defined(_WIN32)
+        WaitForSingleObject(threads[i], INFINITE);
+        CloseHandle(threads[i]);
+#else
+        pthread_join(threads[i], NULL);
+#endif
+    }
+    free(threads);
+    pool->threads = NULL;
+    pool->threadCount = 0;
+}
+
+void WorkPoolSleep(int milliseconds)
+{
+#if defined(_WIN32)
+    Sleep((DWORD)milliseconds);
+#else
+    const struct timespec duration = { milliseconds / 1000, (long)(milliseconds % 1000) * 1000000L };
+    nanosleep(&duration, NULL);
+#endif
+}
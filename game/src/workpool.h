@@ -0,0 +1,36 @@
+#pragma once
+
+#include "stdbool.h"
+#include "stdint.h"
+
+// Fire-and-forget parallel loop: the workers of a batch pull job indices from a shared counter until
+// all are taken, so uneven jobs balance on their own. Callers track finished work with WorkPoolAdd.
+#define WORK_POOL_MAX_THREADS 64
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define WorkPoolAdd(ptr, value) (_InterlockedExchangeAdd((volatile long*)(ptr), (long)(value)) + (long)(value))
+#define WorkPoolLoad(ptr) _InterlockedOr((volatile long*)(ptr), 0)
+#else
+#define WorkPoolAdd(ptr, value) __atomic_add_fetch((ptr), (value), __ATOMIC_ACQ_REL)
+#define WorkPoolLoad(ptr) __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#endif
+
+typedef void (*WorkPoolJob)(void* context, int jobIndex, int threadIndex); // threadIndex is below the thread count, for per-thread scratch
+
+typedef struct WorkPool_t
+{
+    void* threads; // Platform thread handles
+    int threadCount;
+    WorkPoolJob job;
+    void* context;
+    int jobCount;
+    volatile long nextJob;
+    volatile long nextThread;
+    volatile long cancelled;
+} WorkPool;
+
+int WorkPoolDefaultThreadCount(void); // One per CPU
+bool WorkPoolStart(WorkPool* pool, int threadCount, int jobCount, WorkPoolJob job, void* context); // Returns at once
+void WorkPoolWait(WorkPool* pool, bool cancel); // Joins the workers, cancelling skips the jobs not started yet
+void WorkPoolSleep(int milliseconds); // For threads that poll for finished jobs
@@ -29,6 +29,18 @@ newoption
     default = "opengl33"
 }
 
+newoption
+{
+    trigger = "backend",
+    value = "PLATFORM",
+    description = "raylib platform backend",
+    allowed = {
+        { "glfw", "Desktop window through GLFW"},
+        { "headless", "Offscreen EGL context, no window (Linux, for CI benchmarks)"}
+    },
+    default = "glfw"
+}
+
 function string.starts(String,Start)
     return string.sub(String,1,string.len(Start))==Start
 end
@@ -62,6 +62,9 @@
 #define SUPPORT_SCREEN_CAPTURE          1
 // Allow automatic gif recording of current screen pressing CTRL+F12, defined in KeyCallback()
 #define SUPPORT_GIF_RECORDING           1
+// Read back screenshots and gif frames asynchronously (pixel buffers + fences) and encode them on a separate thread
+// NOTE: Requires OpenGL 3.3 for asynchronous readback, other backends read back synchronously but still encode on the thread
+#define SUPPORT_ASYNC_SCREEN_CAPTURE    1
 // Support CompressData() and DecompressData() functions
 #define SUPPORT_COMPRESSION_API         1
 // Support automatic generated events, loading and recording of those events when required
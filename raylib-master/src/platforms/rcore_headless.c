@@ -0,0 +1,793 @@
+/**********************************************************************************************
+*
+*   rcore_headless - Functions to manage window, graphics device and inputs
+*
+*   PLATFORM: HEADLESS
+*       - Linux (Mesa llvmpipe/softpipe or any EGL driver with pbuffer support)
+*
+*   LIMITATIONS:
+*       - No window and no real input devices, input comes from an automation events file
+*       - Single virtual monitor of the size of the framebuffer
+*       - Clipboard, cursor and window placement functions are no-ops
+*
+*   POSSIBLE IMPROVEMENTS:
+*       - Render into a FBO on a surfaceless context, for drivers without pbuffers
+*
+*   ADDITIONAL NOTES:
+*       - TRACELOG() function is located in raylib [utils] module
+*       - GetTime() returns a virtual clock that advances a fixed step on every SwapScreenBuffer(),
+*         so frames run back to back and the program sees the same times on every run
+*       - WaitTime() advances the virtual clock instead of sleeping
+*       - Random seed is fixed, GetRandomValue() returns the same sequence on every run
+*
+*   CONFIGURATION (environment variables, read on InitWindow()):
+*       RAYLIB_HEADLESS_FRAMES
+*           Number of frames to run, WindowShouldClose() returns true after that (0: until the program exits)
+*       RAYLIB_HEADLESS_FPS
+*           Virtual clock rate, defaults to the target set with SetTargetFPS() or 60 if none
+*       RAYLIB_HEADLESS_INPUT
+*           Automation events file (text, as saved by ExportAutomationEventList()), events are played
+*           before the frame they were recorded on
+*       RAYLIB_HEADLESS_LOG
+*           CSV file receiving one line per frame: frame, virtual time, wall time and framebuffer hash
+*       RAYLIB_HEADLESS_HASH_INTERVAL
+*           Hash the framebuffer every N frames of the log (default 1, 0 disables readback)
+*
+*   DEPENDENCIES:
+*       - EGL: Context and pbuffer surface creation (EGL_MESA_platform_surfaceless when available)
+*       - gestures: Gestures system for touch-ready devices (or simulated from mouse inputs)
+*
+*
+*   LICENSE: zlib/libpng
+*
+*   Copyright (c) 2013-2024 Ramon Santamaria (@raysan5) and contributors
+*
+*   This software is provided "as-is", without any express or implied warranty. In no event
+*   will the authors be held liable for any damages arising from the use of this software.
+*
+*   Permission is granted to anyone to use this software for any purpose, including commercial
+*   applications, and to alter it and redistribute it freely, subject to the following restrictions:
+*
+*     1. The origin of this software must not be misrepresented; you must not claim that you
+*     wrote the original software. If you use this software in a product, an acknowledgment
+*     in the product documentation would be appreciated but is not required.
+*
+*     2. Altered source versions must be plainly marked as such, and must not be misrepresented
+*     as being the original software.
+*
+*     3. This notice may not be removed or altered from any source distribution.
+*
+**********************************************************************************************/
+
+// NOTE: glad embeds its own khrplatform.h without KHRONOS_APIENTRY, required by EGL headers
+#ifndef KHRONOS_APIENTRY
+    #define KHRONOS_APIENTRY
+#endif
+
+#define EGL_NO_X11                  // Avoid X11 headers from eglplatform.h
+#include <EGL/egl.h>                // Native platform windowing system interface
+#include <EGL/eglext.h>             // EGL extensions
+
+#include <stdlib.h>                 // Required for: getenv(), atoi(), atof(), qsort()
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+    #define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+
+//----------------------------------------------------------------------------------
+// Types and Structures Definition
+//----------------------------------------------------------------------------------
+typedef struct {
+    // Display data
+    EGLDisplay device;                  // Native display device (surfaceless or default)
+    EGLSurface surface;                 // Pbuffer surface, the default framebuffer
+    EGLContext context;                 // Graphic context, mode in which drawing can be done
+    EGLConfig config;                   // Graphic config
+
+    // Virtual clock
+    unsigned long long int clockNs;     // Virtual time since InitTimer()
+    unsigned long long int stepNs;      // Fixed step per frame, 0 to follow the target FPS
+
+    // Scripted input
+    AutomationEventList events;         // Events to play
+    unsigned int nextEvent;             // First event not played yet
+
+    // Frame log
+    unsigned int frameLimit;            // Frames to run, 0 for no limit
+    int hashInterval;                   // Frames between framebuffer hashes, 0 for none
+    FILE *logFile;                      // Per frame CSV, NULL when not requested
+    unsigned long long int frameStart;  // Wall time at the end of the previous frame
+    double *frameTimes;                 // Wall time of every frame, in seconds
+    unsigned int frameTimeCount;
+    unsigned int frameTimeCapacity;
+    unsigned char *pixels;              // Readback buffer, reused across frames
+} PlatformData;
+
+//----------------------------------------------------------------------------------
+// Global Variables Definition
+//----------------------------------------------------------------------------------
+extern CoreData CORE;                   // Global CORE state context
+
+static PlatformData platform = { 0 };   // Platform specific data
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions Declaration
+//----------------------------------------------------------------------------------
+int InitPlatform(void);          // Initialize platform (graphics, inputs and more)
+void ClosePlatform(void);        // Close platform
+
+static bool CreatePbufferSurface(int width, int height);    // Create and bind the surface that backs the default framebuffer
+static void AdvanceVirtualClock(double seconds);            // Move the virtual clock forward (used by WaitTime())
+static void RecordFrame(void);                              // Record frame time and framebuffer hash
+static int CompareDoubles(const void *a, const void *b);     // Compare frame times, for qsort()
+static unsigned long long int GetWallTimeNs(void);          // Real monotonic time, for frame time measures
+
+//----------------------------------------------------------------------------------
+// Module Functions Declaration
+//----------------------------------------------------------------------------------
+// NOTE: Functions declaration is provided by raylib.h
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition: Window and Graphics Device
+//----------------------------------------------------------------------------------
+
+// Check if application should close
+bool WindowShouldClose(void)
+{
+    if ((platform.frameLimit > 0) && (CORE.Time.frameCounter >= platform.frameLimit)) CORE.Window.shouldClose = true;
+
+    if (CORE.Window.ready) return CORE.Window.shouldClose;
+    else return true;
+}
+
+// Toggle fullscreen mode
+void ToggleFullscreen(void)
+{
+    TRACELOG(LOG_WARNING, "ToggleFullscreen() not available on target platform");
+}
+
+// Toggle borderless windowed mode
+void ToggleBorderlessWindowed(void)
+{
+    TRACELOG(LOG_WARNING, "ToggleBorderlessWindowed() not available on target platform");
+}
+
+// Set window state: maximized, if resizable
+void MaximizeWindow(void)
+{
+    TRACELOG(LOG_WARNING, "MaximizeWindow() not available on target platform");
+}
+
+// Set window state: minimized
+void MinimizeWindow(void)
+{
+    TRACELOG(LOG_WARNING, "MinimizeWindow() not available on target platform");
+}
+
+// Set window state: not minimized/maximized
+void RestoreWindow(void)
+{
+    TRACELOG(LOG_WARNING, "RestoreWindow() not available on target platform");
+}
+
+// Set window configuration state using flags
+// NOTE: There is no window, flags are only registered
+void SetWindowState(unsigned int flags)
+{
+    CORE.Window.flags |= flags;
+}
+
+// Clear window configuration state flags
+void ClearWindowState(unsigned int flags)
+{
+    CORE.Window.flags &= ~flags;
+}
+
+// Set icon for window
+void SetWindowIcon(Image image)
+{
+    TRACELOG(LOG_WARNING, "SetWindowIcon() not available on target platform");
+}
+
+// Set icon for window
+void SetWindowIcons(Image *images, int count)
+{
+    TRACELOG(LOG_WARNING, "SetWindowIcons() not available on target platform");
+}
+
+// Set title for window
+void SetWindowTitle(const char *title)
+{
+    CORE.Window.title = title;
+}
+
+// Set window position on screen (windowed mode)
+void SetWindowPosition(int x, int y)
+{
+    CORE.Window.position.x = x;
+    CORE.Window.position.y = y;
+}
+
+// Set monitor for the current window
+void SetWindowMonitor(int monitor)
+{
+    TRACELOG(LOG_WARNING, "SetWindowMonitor() not available on target platform");
+}
+
+// Set window minimum dimensions (FLAG_WINDOW_RESIZABLE)
+void SetWindowMinSize(int width, int height)
+{
+    CORE.Window.screenMin.width = width;
+    CORE.Window.screenMin.height = height;
+}
+
+// Set window maximum dimensions (FLAG_WINDOW_RESIZABLE)
+void SetWindowMaxSize(int width, int height)
+{
+    CORE.Window.screenMax.width = width;
+    CORE.Window.screenMax.height = height;
+}
+
+// Set window dimensions
+// NOTE: The pbuffer is recreated, IsWindowResized() reports it on the next frame
+void SetWindowSize(int width, int height)
+{
+    if ((width <= 0) || (height <= 0)) return;
+    if ((width == CORE.Window.screen.width) && (height == CORE.Window.screen.height)) return;
+
+    if (!CreatePbufferSurface(width, height))
+    {
+        TRACELOG(LOG_WARNING, "DISPLAY: Failed to resize pbuffer surface to %i x %i", width, height);
+        return;
+    }
+
+    CORE.Window.screen.width = width;
+    CORE.Window.screen.height = height;
+    CORE.Window.display.width = width;
+    CORE.Window.display.height = height;
+    CORE.Window.resizedLastFrame = true;
+
+    SetupViewport(width, height);
+    CORE.Window.currentFbo.width = width;
+    CORE.Window.currentFbo.height = height;
+}
+
+// Set window opacity, value opacity is between 0.0 and 1.0
+void SetWindowOpacity(float opacity)
+{
+    TRACELOG(LOG_WARNING, "SetWindowOpacity() not available on target platform");
+}
+
+// Set window focused
+void SetWindowFocused(void)
+{
+    // There is only one window and it always has focus
+}
+
+// Get native window handle
+void *GetWindowHandle(void)
+{
+    return NULL;
+}
+
+// Get number of monitors
+int GetMonitorCount(void)
+{
+    return 1;
+}
+
+// Get number of monitors
+int GetCurrentMonitor(void)
+{
+    return 0;
+}
+
+// Get selected monitor position
+Vector2 GetMonitorPosition(int monitor)
+{
+    return (Vector2){ 0, 0 };
+}
+
+// Get selected monitor width (currently used by monitor)
+int GetMonitorWidth(int monitor)
+{
+    return CORE.Window.display.width;
+}
+
+// Get selected monitor height (currently used by monitor)
+int GetMonitorHeight(int monitor)
+{
+    return CORE.Window.display.height;
+}
+
+// Get selected monitor physical width in millimetres
+int GetMonitorPhysicalWidth(int monitor)
+{
+    TRACELOG(LOG_WARNING, "GetMonitorPhysicalWidth() not implemented on target platform");
+    return 0;
+}
+
+// Get selected monitor physical height in millimetres
+int GetMonitorPhysicalHeight(int monitor)
+{
+    TRACELOG(LOG_WARNING, "GetMonitorPhysicalHeight() not implemented on target platform");
+    return 0;
+}
+
+// Get selected monitor refresh rate
+int GetMonitorRefreshRate(int monitor)
+{
+    return (int)(1e9/(double)((platform.stepNs > 0)? platform.stepNs : 1000000000ULL/60) + 0.5);
+}
+
+// Get the human-readable, UTF-8 encoded name of the selected monitor
+const char *GetMonitorName(int monitor)
+{
+    return "Headless";
+}
+
+// Get window position XY on monitor
+Vector2 GetWindowPosition(void)
+{
+    return (Vector2){ (float)CORE.Window.position.x, (float)CORE.Window.position.y };
+}
+
+// Get window scale DPI factor for current monitor
+Vector2 GetWindowScaleDPI(void)
+{
+    return (Vector2){ 1.0f, 1.0f };
+}
+
+// Set clipboard text content
+void SetClipboardText(const char *text)
+{
+    TRACELOG(LOG_WARNING, "SetClipboardText() not implemented on target platform");
+}
+
+// Get clipboard text content
+const char *GetClipboardText(void)
+{
+    TRACELOG(LOG_WARNING, "GetClipboardText() not implemented on target platform");
+    return NULL;
+}
+
+// Show mouse cursor
+void ShowCursor(void)
+{
+    CORE.Input.Mouse.cursorHidden = false;
+}
+
+// Hides mouse cursor
+void HideCursor(void)
+{
+    CORE.Input.Mouse.cursorHidden = true;
+}
+
+// Enables cursor (unlock cursor)
+void EnableCursor(void)
+{
+    // Set cursor position in the middle
+    SetMousePosition(CORE.Window.screen.width/2, CORE.Window.screen.height/2);
+
+    CORE.Input.Mouse.cursorHidden = false;
+}
+
+// Disables cursor (lock cursor)
+void DisableCursor(void)
+{
+    // Set cursor position in the middle
+    SetMousePosition(CORE.Window.screen.width/2, CORE.Window.screen.height/2);
+
+    CORE.Input.Mouse.cursorHidden = true;
+}
+
+// Swap back buffer with front buffer (screen drawing)
+// NOTE: Frame time is measured here, after the GPU finished the frame, then the virtual clock moves one step
+void SwapScreenBuffer(void)
+{
+    RecordFrame();
+
+    eglSwapBuffers(platform.device, platform.surface);
+
+    unsigned long long int stepNs = platform.stepNs;
+    if (stepNs == 0) stepNs = (CORE.Time.target > 0.0)? (unsigned long long int)(CORE.Time.target*1e9 + 0.5) : 1000000000ULL/60;
+    platform.clockNs += stepNs;
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition: Misc
+//----------------------------------------------------------------------------------
+
+// Get elapsed time measure in seconds since InitTimer()
+// NOTE: Virtual clock, see SwapScreenBuffer() and WaitTime()
+double GetTime(void)
+{
+    return (double)platform.clockNs*1e-9;
+}
+
+// Open URL with default system browser (if available)
+void OpenURL(const char *url)
+{
+    TRACELOG(LOG_WARNING, "OpenURL() not available on target platform");
+}
+
+//----------------------------------------------------------------------------------
+// Module Functions Definition: Inputs
+//----------------------------------------------------------------------------------
+
+// Set internal gamepad mappings
+int SetGamepadMappings(const char *mappings)
+{
+    TRACELOG(LOG_WARNING, "SetGamepadMappings() not implemented on target platform");
+    return 0;
+}
+
+// Set mouse position XY
+void SetMousePosition(int x, int y)
+{
+    CORE.Input.Mouse.currentPosition = (Vector2){ (float)x, (float)y };
+    CORE.Input.Mouse.previousPosition = CORE.Input.Mouse.currentPosition;
+}
+
+// Set mouse cursor
+void SetMouseCursor(int cursor)
+{
+    CORE.Input.Mouse.cursor = cursor;
+}
+
+// Register all input events
+// NOTE: Input comes from the automation events file, events recorded on frame N
+// are played here at the end of frame N - 1, so frame N sees the recorded state
+void PollInputEvents(void)
+{
+#if defined(SUPPORT_GESTURES_SYSTEM)
+    // NOTE: Gestures update must be called every frame to reset gestures correctly
+    // because ProcessGestureEvent() is just called on an event, not every frame
+    UpdateGestures();
+#endif
+
+    // Reset keys/chars pressed registered
+    CORE.Input.Keyboard.keyPressedQueueCount = 0;
+    CORE.Input.Keyboard.charPressedQueueCount = 0;
+
+    // Reset last gamepad button/axis registered state
+    CORE.Input.Gamepad.lastButtonPressed = 0; // GAMEPAD_BUTTON_UNKNOWN
+
+    // Reset window resized flag, a resize event below sets it again
+    CORE.Window.resizedLastFrame = false;
+
+    // Register previous keys states
+    for (int i = 0; i < MAX_KEYBOARD_KEYS; i++)
+    {
+        CORE.Input.Keyboard.previousKeyState[i] = CORE.Input.Keyboard.currentKeyState[i];
+        CORE.Input.Keyboard.keyRepeatInFrame[i] = 0;
+    }
+
+    // Register previous mouse states
+    for (int i = 0; i < MAX_MOUSE_BUTTONS; i++) CORE.Input.Mouse.previousButtonState[i] = CORE.Input.Mouse.currentButtonState[i];
+
+    // Register previous mouse wheel state
+    CORE.Input.Mouse.previousWheelMove = CORE.Input.Mouse.currentWheelMove;
+    CORE.Input.Mouse.currentWheelMove = (Vector2){ 0.0f, 0.0f };
+
+    // Register previous mouse position
+    CORE.Input.Mouse.previousPosition = CORE.Input.Mouse.currentPosition;
+
+    // Register previous touch states
+    for (int i = 0; i < MAX_TOUCH_POINTS; i++) CORE.Input.Touch.previousTouchState[i] = CORE.Input.Touch.currentTouchState[i];
+
+    // Play the events of the next frame
+    const unsigned int nextFrame = CORE.Time.frameCounter + 1;
+    while ((platform.nextEvent < platform.events.count) && (platform.events.events[platform.nextEvent].frame <= nextFrame))
+    {
+        PlayAutomationEvent(platform.events.events[platform.nextEvent]);
+        platform.nextEvent++;
+    }
+
+    // Map mouse position to touch position for convenience
+    CORE.Input.Touch.position[0] = CORE.Input.Mouse.currentPosition;
+}
+
+//----------------------------------------------------------------------------------
+// Module Internal Functions Definition
+//----------------------------------------------------------------------------------
+
+// Initialize platform: graphics, inputs and more
+int InitPlatform(void)
+{
+    // Read run configuration
+    //----------------------------------------------------------------------------
+    const char *frames = getenv("RAYLIB_HEADLESS_FRAMES");
+    const char *fps = getenv("RAYLIB_HEADLESS_FPS");
+    const char *input = getenv("RAYLIB_HEADLESS_INPUT");
+    const char *log = getenv("RAYLIB_HEADLESS_LOG");
+    const char *hashInterval = getenv("RAYLIB_HEADLESS_HASH_INTERVAL");
+
+    platform.frameLimit = (frames != NULL)? (unsigned int)atoi(frames) : 0;
+    platform.stepNs = ((fps != NULL) && (atof(fps) > 0.0))? (unsigned long long int)(1e9/atof(fps) + 0.5) : 0;
+    platform.hashInterval = (hashInterval != NULL)? atoi(hashInterval) : 1;
+
+    if ((log != NULL) && (log[0] != '\0'))
+    {
+        platform.logFile = fopen(log, "wt");
+        if (platform.logFile == NULL) TRACELOG(LOG_WARNING, "HEADLESS: Failed to open frame log file: %s", log);
+        else fprintf(platform.logFile, "frame,time,frame_ms,hash\n");
+    }
+    //----------------------------------------------------------------------------
+
+    // Initialize graphic device: pbuffer surface on an EGL display
+    //----------------------------------------------------------------------------
+    if (CORE.Window.screen.width <= 0) CORE.Window.screen.width = 1280;
+    if (CORE.Window.screen.height <= 0) CORE.Window.screen.height = 720;
+    CORE.Window.display.width = CORE.Window.screen.width;
+    CORE.Window.display.height = CORE.Window.screen.height;
+
+    // Prefer the Mesa surfaceless platform, it needs neither a display server nor a DRM device
+    const char *clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    PFNEGLGETPLATFORMDISPLAYEXTPROC eglGetPlatformDisplayEXT = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+
+    platform.device = EGL_NO_DISPLAY;
+    if ((clientExtensions != NULL) && (strstr(clientExtensions, "EGL_MESA_platform_surfaceless") != NULL) && (eglGetPlatformDisplayEXT != NULL))
+    {
+        platform.device = eglGetPlatformDisplayEXT(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+    }
+    if (platform.device == EGL_NO_DISPLAY) platform.device = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+    if ((platform.device == EGL_NO_DISPLAY) || (eglInitialize(platform.device, NULL, NULL) == EGL_FALSE))
+    {
+        TRACELOG(LOG_WARNING, "DISPLAY: Failed to initialize EGL device");
+        return -1;
+    }
+
+    const int glVersion = rlGetVersion();
+    const bool glesApi = (glVersion == RL_OPENGL_ES_20) || (glVersion == RL_OPENGL_ES_30);
+
+    EGLint samples = 0;
+    EGLint sampleBuffer = 0;
+    if (CORE.Window.flags & FLAG_MSAA_4X_HINT)
+    {
+        samples = 4;
+        sampleBuffer = 1;
+        TRACELOG(LOG_INFO, "DISPLAY: Trying to enable MSAA x4");
+    }
+
+    const EGLint framebufferAttribs[] =
+    {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,  // Offscreen surface
+        EGL_RENDERABLE_TYPE, glesApi? ((glVersion == RL_OPENGL_ES_30)? EGL_OPENGL_ES3_BIT : EGL_OPENGL_ES2_BIT) : EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8,            // RED color bit depth
+        EGL_GREEN_SIZE, 8,          // GREEN color bit depth
+        EGL_BLUE_SIZE, 8,           // BLUE color bit depth
+        EGL_ALPHA_SIZE, 8,          // ALPHA bit depth
+        EGL_DEPTH_SIZE, 24,         // Depth buffer size (Required to use Depth testing!)
+        EGL_SAMPLE_BUFFERS, sampleBuffer,   // Activate MSAA
+        EGL_SAMPLES, samples,       // 4x Antialiasing if activated
+        EGL_NONE
+    };
+
+    EGLint numConfigs = 0;
+    if ((eglChooseConfig(platform.device, framebufferAttribs, &platform.config, 1, &numConfigs) == EGL_FALSE) || (numConfigs < 1))
+    {
+        TRACELOG(LOG_WARNING, "DISPLAY: Failed to get a pbuffer EGL config");
+        return -1;
+    }
+
+    // Request the context matching the rlgl backend: core profile for 3.3/4.3, compatibility for 1.1/2.1
+    EGLint contextAttribs[16] = { 0 };
+    int attribCount = 0;
+    if (glesApi)
+    {
+        contextAttribs[attribCount++] = EGL_CONTEXT_CLIENT_VERSION;
+        contextAttribs[attribCount++] = (glVersion == RL_OPENGL_ES_30)? 3 : 2;
+    }
+    else if ((glVersion == RL_OPENGL_33) || (glVersion == RL_OPENGL_43))
+    {
+        contextAttribs[attribCount++] = EGL_CONTEXT_MAJOR_VERSION;
+        contextAttribs[attribCount++] = (glVersion == RL_OPENGL_43)? 4 : 3;
+        contextAttribs[attribCount++] = EGL_CONTEXT_MINOR_VERSION;
+        contextAttribs[attribCount++] = 3;
+        contextAttribs[attribCount++] = EGL_CONTEXT_OPENGL_PROFILE_MASK;
+        contextAttribs[attribCount++] = EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT;
+    }
+    contextAttribs[attribCount++] = EGL_NONE;
+
+    eglBindAPI(glesApi? EGL_OPENGL_ES_API : EGL_OPENGL_API);
+
+    platform.context = eglCreateContext(platform.device, platform.config, EGL_NO_CONTEXT, contextAttribs);
+    if (platform.context == EGL_NO_CONTEXT)
+    {
+        TRACELOG(LOG_WARNING, "DISPLAY: Failed to create EGL context");
+        return -1;
+    }
+
+    if (!CreatePbufferSurface(CORE.Window.screen.width, CORE.Window.screen.height))
+    {
+        TRACELOG(LOG_FATAL, "PLATFORM: Failed to initialize graphics device");
+        return -1;
+    }
+
+    // Frames are not presented anywhere, never wait for a vertical sync
+    eglSwapInterval(platform.device, 0);
+
+    CORE.Window.ready = true;
+
+    CORE.Window.render.width = CORE.Window.screen.width;
+    CORE.Window.render.height = CORE.Window.screen.height;
+    CORE.Window.currentFbo.width = CORE.Window.render.width;
+    CORE.Window.currentFbo.height = CORE.Window.render.height;
+
+    TRACELOG(LOG_INFO, "DISPLAY: Device initialized successfully");
+    TRACELOG(LOG_INFO, "    > Display size: %i x %i", CORE.Window.display.width, CORE.Window.display.height);
+    TRACELOG(LOG_INFO, "    > Screen size:  %i x %i", CORE.Window.screen.width, CORE.Window.screen.height);
+    TRACELOG(LOG_INFO, "    > Render size:  %i x %i", CORE.Window.render.width, CORE.Window.render.height);
+    TRACELOG(LOG_INFO, "    > Viewport offsets: %i, %i", CORE.Window.renderOffset.x, CORE.Window.renderOffset.y);
+    //----------------------------------------------------------------------------
+
+    // Load OpenGL extensions
+    // NOTE: GL procedures address loader is required to load extensions
+    //----------------------------------------------------------------------------
+    rlLoadExtensions(eglGetProcAddress);
+    //----------------------------------------------------------------------------
+
+    // Initialize input events system: scripted automation events
+    //----------------------------------------------------------------------------
+    if ((input != NULL) && (input[0] != '\0'))
+    {
+        platform.events = LoadAutomationEventList(input);
+        TRACELOG(LOG_INFO, "HEADLESS: Playing %u input events from %s", platform.events.count, input);
+    }
+    //----------------------------------------------------------------------------
+
+    // Initialize timing system
+    //----------------------------------------------------------------------------
+    InitTimer();
+    platform.clockNs = 0;
+    platform.frameStart = GetWallTimeNs();
+    //----------------------------------------------------------------------------
+
+    // Initialize storage system
+    //----------------------------------------------------------------------------
+    CORE.Storage.basePath = GetWorkingDirectory();
+    //----------------------------------------------------------------------------
+
+    TRACELOG(LOG_INFO, "PLATFORM: HEADLESS: Initialized successfully");
+
+    return 0;
+}
+
+// Close platform
+void ClosePlatform(void)
+{
+    // Frame time summary
+    if (platform.frameTimeCount > 0)
+    {
+        double total = 0.0;
+        for (unsigned int i = 0; i < platform.frameTimeCount; i++) total += platform.frameTimes[i];
+
+        qsort(platform.frameTimes, platform.frameTimeCount, sizeof(double), CompareDoubles);
+
+        TRACELOG(LOG_INFO, "HEADLESS: %u frames in %.3f s, %.1f fps, frame time mean %.3f ms, p50 %.3f ms, p99 %.3f ms, max %.3f ms",
+            platform.frameTimeCount, total, (double)platform.frameTimeCount/total, total*1000.0/platform.frameTimeCount,
+            platform.frameTimes[platform.frameTimeCount/2]*1000.0, platform.frameTimes[(platform.frameTimeCount*99)/100]*1000.0,
+            platform.frameTimes[platform.frameTimeCount - 1]*1000.0);
+    }
+
+    if (platform.logFile != NULL) fclose(platform.logFile);
+    if (platform.events.events != NULL) UnloadAutomationEventList(platform.events);
+    RL_FREE(platform.frameTimes);
+    RL_FREE(platform.pixels);
+
+    if (platform.device != EGL_NO_DISPLAY)
+    {
+        eglMakeCurrent(platform.device, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+
+        if (platform.surface != EGL_NO_SURFACE) eglDestroySurface(platform.device, platform.surface);
+        if (platform.context != EGL_NO_CONTEXT) eglDestroyContext(platform.device, platform.context);
+
+        eglTerminate(platform.device);
+    }
+
+    memset(&platform, 0, sizeof(platform));
+}
+
+// Create and bind the surface that backs the default framebuffer
+static bool CreatePbufferSurface(int width, int height)
+{
+    const EGLint surfaceAttribs[] =
+    {
+        EGL_WIDTH, width,
+        EGL_HEIGHT, height,
+        EGL_NONE
+    };
+
+    EGLSurface surface = eglCreatePbufferSurface(platform.device, platform.config, surfaceAttribs);
+    if (surface == EGL_NO_SURFACE) return false;
+
+    if (eglMakeCurrent(platform.device, surface, surface, platform.context) == EGL_FALSE)
+    {
+        eglDestroySurface(platform.device, surface);
+        if (platform.surface != EGL_NO_SURFACE) eglMakeCurrent(platform.device, platform.surface, platform.surface, platform.context);
+        return false;
+    }
+
+    if (platform.surface != EGL_NO_SURFACE) eglDestroySurface(platform.device, platform.surface);
+    platform.surface = surface;
+
+    RL_FREE(platform.pixels);
+    platform.pixels = NULL;
+
+    return true;
+}
+
+// Move the virtual clock forward
+static void AdvanceVirtualClock(double seconds)
+{
+    platform.clockNs += (unsigned long long int)(seconds*1e9);
+}
+
+// Record frame time and framebuffer hash
+// NOTE: Readback and hashing happen after the measure and are not counted in any frame
+static void RecordFrame(void)
+{
+    glFinish();     // The frame is done once the GPU finished it
+
+    const unsigned long long int now = GetWallTimeNs();
+    const double frameTime = (double)(now - platform.frameStart)*1e-9;
+
+    if (platform.frameTimeCount == platform.frameTimeCapacity)
+    {
+        const unsigned int capacity = (platform.frameTimeCapacity > 0)? platform.frameTimeCapacity + platform.frameTimeCapacity/2 : 1024;
+        double *frameTimes = (double *)RL_REALLOC(platform.frameTimes, capacity*sizeof(double));
+        if (frameTimes != NULL)
+        {
+            platform.frameTimes = frameTimes;
+            platform.frameTimeCapacity = capacity;
+        }
+    }
+    if (platform.frameTimeCount < platform.frameTimeCapacity) platform.frameTimes[platform.frameTimeCount++] = frameTime;
+
+    if (platform.logFile != NULL)
+    {
+        const unsigned int frame = CORE.Time.frameCounter;
+        fprintf(platform.logFile, "%u,%.6f,%.3f,", frame, GetTime(), frameTime*1000.0);
+
+        if ((platform.hashInterval > 0) && ((frame%platform.hashInterval) == 0))
+        {
+            const int width = CORE.Window.render.width;
+            const int height = CORE.Window.render.height;
+            if (platform.pixels == NULL) platform.pixels = (unsigned char *)RL_MALLOC(width*height*4);
+
+            glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, platform.pixels);
+
+            // FNV-1a 64 over the bottom-up RGBA rows
+            unsigned long long int hash = 0xcbf29ce484222325ULL;
+            for (int i = 0; i < width*height*4; i++) hash = (hash ^ platform.pixels[i])*0x100000001b3ULL;
+
+            fprintf(platform.logFile, "%016llx", hash);
+        }
+
+        fprintf(platform.logFile, "\n");
+    }
+
+    platform.frameStart = GetWallTimeNs();
+}
+
+// Compare frame times, for qsort()
+static int CompareDoubles(const void *a, const void *b)
+{
+    const double left = *(const double *)a;
+    const double right = *(const double *)b;
+
+    return (left < right)? -1 : ((left > right)? 1 : 0);
+}
+
+// Real monotonic time, for frame time measures
+static unsigned long long int GetWallTimeNs(void)
+{
+    struct timespec ts = { 0 };
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (unsigned long long int)ts.tv_sec*1000000000LLU + (unsigned long long int)ts.tv_nsec;
+}
+
+// EOF
@@ -19,6 +19,8 @@
 *           - Linux DRM subsystem (KMS mode)
 *       > PLATFORM_ANDROID:
 *           - Android (ARM, ARM64)
+*       > PLATFORM_HEADLESS:
+*           - Linux offscreen EGL context, no window (CI benchmarks and regression tests)
 *
 *   CONFIGURATION:
 *       #define SUPPORT_DEFAULT_FONT (default)
@@ -47,6 +49,9 @@
 *       #define SUPPORT_GIF_RECORDING
 *           Allow automatic gif recording of current screen pressing CTRL+F12, defined in KeyCallback()
 *
+*       #define SUPPORT_ASYNC_SCREEN_CAPTURE
+*           Read back screenshots and gif frames asynchronously and encode them on a separate thread
+*
 *       #define SUPPORT_COMPRESSION_API
 *           Support CompressData() and DecompressData() functions, those functions use zlib implementation
 *           provided by stb_image and stb_image_write libraries, so, those libraries must be enabled on textures module
@@ -135,6 +140,10 @@
     #include "external/msf_gif.h"   // GIF recording functionality
 #endif
 
+#if defined(SUPPORT_ASYNC_SCREEN_CAPTURE) && (defined(PLATFORM_WEB) || !defined(SUPPORT_SCREEN_CAPTURE))
+    #undef SUPPORT_ASYNC_SCREEN_CAPTURE     // No threads available on web
+#endif
+
 #if defined(SUPPORT_COMPRESSION_API)
     #define SINFL_IMPLEMENTATION
     #define SINFL_NO_SIMD
@@ -367,9 +376,88 @@ static int screenshotCounter = 0;    // Screenshots counter
 #if defined(SUPPORT_GIF_RECORDING)
 unsigned int gifFrameCounter = 0;    // GIF frames counter
 bool gifRecording = false;           // GIF recording state
+#if !defined(SUPPORT_ASYNC_SCREEN_CAPTURE)
+static unsigned char *gifFrameData = NULL; // GIF frame readback buffer, reused between frames
+static int gifFrameDataSize = 0;     // GIF frame readback buffer size
+#endif
 MsfGifState gifState = { 0 };        // MSGIF context state
 #endif
 
+#if defined(SUPPORT_ASYNC_SCREEN_CAPTURE)
+#ifndef CAPTURE_READBACK_SLOTS
+    #define CAPTURE_READBACK_SLOTS          3       // Readbacks in flight, collected one or two frames after being issued
+#endif
+#ifndef CAPTURE_QUEUE_SIZE
+    #define CAPTURE_QUEUE_SIZE              8       // Captured frames waiting for the encoder thread
+#endif
+
+// Screen capture job, processed by the encoder thread
+typedef enum CaptureJobType {
+    CAPTURE_JOB_SCREENSHOT = 0,     // Encode PNG and save it to fileName
+    CAPTURE_JOB_GIF_BEGIN,          // Begin GIF recording of width x height
+    CAPTURE_JOB_GIF_FRAME,          // Add GIF frame with delay (centiseconds)
+    CAPTURE_JOB_GIF_END,            // End GIF recording and save it to fileName
+    CAPTURE_JOB_GIF_CANCEL,         // End GIF recording discarding it
+    CAPTURE_JOB_QUIT                // Stop encoder thread
+} CaptureJobType;
+
+typedef struct CaptureJob {
+    int type;                       // Job type (CaptureJobType)
+    unsigned char *data;            // Frame pixels (RGBA, top-down), owned by the job
+    int width;                      // Frame width
+    int height;                     // Frame height
+    int delay;                      // GIF frame delay in centiseconds
+    char fileName[512];             // Output file path
+} CaptureJob;
+
+// Readback slot, pixels are copied out once the GPU signals the fence
+typedef struct CaptureSlot {
+    unsigned int pbo;               // Pixel pack buffer id
+    int size;                       // Pixel pack buffer size in bytes
+    void *fence;                    // Fence inserted after the readback
+    bool pending;                   // Readback issued and not collected yet
+    CaptureJob job;                 // Job queued when the readback is collected
+} CaptureSlot;
+
+#if defined(_WIN32)
+// NOTE: Declared here to avoid including windows.h (kernel32.lib linkage required)
+// SRWLOCK and CONDITION_VARIABLE are a single pointer, zero initialized
+__declspec(dllimport) void *__stdcall CreateThread(void *threadAttributes, size_t stackSize, unsigned long (__stdcall *startAddress)(void *), void *parameter, unsigned long creationFlags, unsigned long *threadId);
+__declspec(dllimport) unsigned long __stdcall WaitForSingleObject(void *handle, unsigned long milliseconds);
+__declspec(dllimport) int __stdcall CloseHandle(void *handle);
+__declspec(dllimport) void __stdcall AcquireSRWLockExclusive(void **srwLock);
+__declspec(dllimport) void __stdcall ReleaseSRWLockExclusive(void **srwLock);
+__declspec(dllimport) int __stdcall SleepConditionVariableSRW(void **conditionVariable, void **srwLock, unsigned long milliseconds, unsigned long flags);
+__declspec(dllimport) void __stdcall WakeConditionVariable(void **conditionVariable);
+
+typedef void *CaptureThread;
+typedef void *CaptureMutex;
+typedef void *CaptureCondition;
+#else
+    #include <pthread.h>            // Required for: pthread_create(), pthread_mutex_lock(), pthread_cond_wait()
+
+typedef pthread_t CaptureThread;
+typedef pthread_mutex_t CaptureMutex;
+typedef pthread_cond_t CaptureCondition;
+#endif
+
+static struct {
+    CaptureSlot slots[CAPTURE_READBACK_SLOTS];  // Readback ring, nextSlot is the oldest one
+    int nextSlot;
+
+    CaptureJob queue[CAPTURE_QUEUE_SIZE];       // Bounded queue to the encoder thread
+    int queueHead;
+    int queueCount;
+    CaptureMutex mutex;
+    CaptureCondition notEmpty;
+    CaptureCondition notFull;
+
+    CaptureThread thread;
+    bool threadRunning;
+    unsigned int droppedFrames;                 // GIF frames dropped because the GPU or the encoder fell behind
+} capture = { 0 };
+#endif
+
 #if defined(SUPPORT_AUTOMATION_EVENTS)
 // Automation events type
 typedef enum AutomationEventType {
@@ -482,6 +570,14 @@ static void ScanDirectoryFilesRecursively(const char *basePath, FilePathList *li
 static void RecordAutomationEvent(void); // Record frame events (to internal events array)
 #endif
 
+#if defined(SUPPORT_ASYNC_SCREEN_CAPTURE)
+static void InitScreenCapture(void);                        // Start encoder thread
+static void CloseScreenCapture(void);                       // Flush pending captures and stop encoder thread
+static void RequestScreenCapture(CaptureJob job);           // Start asynchronous readback of current screen for a capture job
+static void UpdateScreenCapture(bool wait);                 // Collect finished readbacks (in order) and queue them for encoding
+static bool PushCaptureJob(CaptureJob job, bool wait);      // Push job to encoder queue, if not waiting fails when queue is full
+#endif
+
 #if defined(_WIN32)
 // NOTE: We declare Sleep() function symbol to avoid including windows.h (kernel32.lib linkage required)
 void __stdcall Sleep(unsigned long msTimeout);              // Required for: WaitTime()
@@ -502,6 +598,8 @@ const char *TextFormat(const char *text, ...);              // Formatting of tex
     #include "platforms/rcore_drm.c"
 #elif defined(PLATFORM_ANDROID)
     #include "platforms/rcore_android.c"
+#elif defined(PLATFORM_HEADLESS)
+    #include "platforms/rcore_headless.c"
 #else
     // TODO: Include your custom platform backend!
     // i.e software rendering backend or console backend!
@@ -570,6 +668,8 @@ void InitWindow(int width, int height, const char *title)
     TRACELOG(LOG_INFO, "Platform backend: NATIVE DRM");
 #elif defined(PLATFORM_ANDROID)
     TRACELOG(LOG_INFO, "Platform backend: ANDROID");
+#elif defined(PLATFORM_HEADLESS)
+    TRACELOG(LOG_INFO, "Platform backend: HEADLESS (EGL)");
 #else
     // TODO: Include your custom platform backend!
     // i.e software rendering backend or console backend!
@@ -672,19 +772,40 @@ void InitWindow(int width, int height, const char *title)
     CORE.Window.shouldClose = false;
 
     // Initialize random seed
+#if defined(PLATFORM_HEADLESS)
+    SetRandomSeed(0);   // Same sequence on every run, like the virtual clock
+#else
     SetRandomSeed((unsigned int)time(NULL));
+#endif
 }
 
 // Close window and unload OpenGL context
 void CloseWindow(void)
 {
-#if defined(SUPPORT_GIF_RECORDING)
+#if defined(SUPPORT_ASYNC_SCREEN_CAPTURE)
+    UpdateScreenCapture(true);  // Pending readbacks require the GL context
+
+    #if defined(SUPPORT_GIF_RECORDING)
+    if (gifRecording)
+    {
+        CaptureJob cancel = { .type = CAPTURE_JOB_GIF_CANCEL };
+        PushCaptureJob(cancel, true);
+        gifRecording = false;
+    }
+    #endif
+
+    CloseScreenCapture();
+#elif defined(SUPPORT_GIF_RECORDING)
     if (gifRecording)
     {
         MsfGifResult result = msf_gif_end(&gifState);
         msf_gif_free(result);
         gifRecording = false;
     }
+
+    RL_FREE(gifFrameData);
+    gifFrameData = NULL;
+    gifFrameDataSize = 0;
 #endif
 
 #if defined(SUPPORT_MODULE_RTEXT) && defined(SUPPORT_DEFAULT_FONT)
@@ -857,20 +978,36 @@ void EndDrawing(void)
         // NOTE: We record one gif frame depending on the desired gif framerate
         if (gifFrameCounter > 1000/GIF_RECORD_FRAMERATE)
         {
-            // Get image data for the current frame (from backbuffer)
-            // NOTE: This process is quite slow... :(
             Vector2 scale = GetWindowScaleDPI();
-            unsigned char *screenData = rlReadScreenPixels((int)((float)CORE.Window.render.width*scale.x), (int)((float)CORE.Window.render.height*scale.y));
+        #if defined(SUPPORT_ASYNC_SCREEN_CAPTURE)
+            // Read back asynchronously, frame is encoded on the capture thread once the GPU is done
+            CaptureJob frame = { .type = CAPTURE_JOB_GIF_FRAME };
+            frame.width = (int)((float)CORE.Window.render.width*scale.x);
+            frame.height = (int)((float)CORE.Window.render.height*scale.y);
+            frame.delay = gifFrameCounter/10;
+            RequestScreenCapture(frame);
+            gifFrameCounter -= 1000/GIF_RECORD_FRAMERATE;
+        #else
+            // Get image data for the current frame (from backbuffer), into a buffer kept for the whole recording
+            int frameWidth = (int)((float)CORE.Window.render.width*scale.x);
+            int frameHeight = (int)((float)CORE.Window.render.height*scale.y);
+            if (gifFrameDataSize != frameWidth*frameHeight*4)
+            {
+                RL_FREE(gifFrameData);
+                gifFrameDataSize = frameWidth*frameHeight*4;
+                gifFrameData = (unsigned char *)RL_MALLOC(gifFrameDataSize);
+            }
+            unsigned char *screenData = gifFrameData;
+            rlReadScreenPixelsRec(0, 0, frameWidth, frameHeight, screenData);
 
             #ifndef GIF_RECORD_BITRATE
             #define GIF_RECORD_BITRATE 16
             #endif
 
             // Add the frame to the gif recording, given how many frames have passed in centiseconds
-            msf_gif_frame(&gifState, screenData, gifFrameCounter/10, GIF_RECORD_BITRATE, (int)((float)CORE.Window.render.width*scale.x)*4);
+            msf_gif_frame(&gifState, screenData, gifFrameCounter/10, GIF_RECORD_BITRATE, frameWidth*4);
             gifFrameCounter -= 1000/GIF_RECORD_FRAMERATE;
-
-            RL_FREE(screenData);    // Free image data
+        #endif
         }
 
     #if defined(SUPPORT_MODULE_RSHAPES) && defined(SUPPORT_MODULE_RTEXT)
@@ -886,12 +1023,18 @@ void EndDrawing(void)
     }
 #endif
 
+#if defined(SUPPORT_ASYNC_SCREEN_CAPTURE)
+    UpdateScreenCapture(false);     // Queue finished readbacks for encoding, never stalls
+#endif
+
 #if defined(SUPPORT_AUTOMATION_EVENTS)
     if (automationEventRecording) RecordAutomationEvent();    // Event recording
 #endif
 
 #if !defined(SUPPORT_CUSTOM_FRAME_CONTROL)
+    RL_TRACE_ZONE_BEGIN("SwapScreenBuffer");
     SwapScreenBuffer();                  // Copy back buffer to front buffer (screen)
+    RL_TRACE_ZONE_END("SwapScreenBuffer");
 
     // Frame time control system
     CORE.Time.current = GetTime();
@@ -925,11 +1068,25 @@ void EndDrawing(void)
             {
                 gifRecording = false;
 
+            #if defined(SUPPORT_ASYNC_SCREEN_CAPTURE)
+                UpdateScreenCapture(true);  // Frames still in flight belong to this recording
+
+                CaptureJob end = { .type = CAPTURE_JOB_GIF_END };
+                strncpy(end.fileName, TextFormat("%s/screenrec%03i.gif", CORE.Storage.basePath, screenshotCounter), sizeof(end.fileName) - 1);
+                PushCaptureJob(end, true);
+
+                if (capture.droppedFrames > 0) TRACELOG(LOG_WARNING, "SYSTEM: Animated GIF recording dropped %u frames", capture.droppedFrames);
+            #else
                 MsfGifResult result = msf_gif_end(&gifState);
 
                 SaveFileData(TextFormat("%s/screenrec%03i.gif", CORE.Storage.basePath, screenshotCounter), result.data, (unsigned int)result.dataSize);
                 msf_gif_free(result);
 
+                RL_FREE(gifFrameData);
+                gifFrameData = NULL;
+                gifFrameDataSize = 0;
+            #endif
+
                 TRACELOG(LOG_INFO, "SYSTEM: Finish animated GIF recording");
             }
             else
@@ -938,7 +1095,17 @@ void EndDrawing(void)
                 gifFrameCounter = 0;
 
                 Vector2 scale = GetWindowScaleDPI();
+            #if defined(SUPPORT_ASYNC_SCREEN_CAPTURE)
+                InitScreenCapture();
+
+                CaptureJob begin = { .type = CAPTURE_JOB_GIF_BEGIN };
+                begin.width = (int)((float)CORE.Window.render.width*scale.x);
+                begin.height = (int)((float)CORE.Window.render.height*scale.y);
+                PushCaptureJob(begin, true);
+                capture.droppedFrames = 0;
+            #else
                 msf_gif_begin(&gifState, (int)((float)CORE.Window.render.width*scale.x), (int)((float)CORE.Window.render.height*scale.y));
+            #endif
                 screenshotCounter++;
 
                 TRACELOG(LOG_INFO, "SYSTEM: Start animated GIF recording: %s", TextFormat("screenrec%03i.gif", screenshotCounter));
@@ -1663,6 +1830,11 @@ void WaitTime(double seconds)
 {
     if (seconds < 0) return;
 
+#if defined(PLATFORM_HEADLESS)
+    // NOTE: Headless platform runs on a virtual clock, waiting just moves it forward
+    AdvanceVirtualClock(seconds);
+#else
+
 #if defined(SUPPORT_BUSY_WAIT_LOOP) || defined(SUPPORT_PARTIALBUSY_WAIT_LOOP)
     double destinationTime = GetTime() + seconds;
 #endif
@@ -1698,6 +1870,7 @@ void WaitTime(double seconds)
         while (GetTime() < destinationTime) { }
     #endif
 #endif
+#endif  // PLATFORM_HEADLESS
 }
 
 //----------------------------------------------------------------------------------
@@ -1804,6 +1977,21 @@ void TakeScreenshot(const char *fileName)
     if (strchr(fileName, '\'') != NULL) { TRACELOG(LOG_WARNING, "SYSTEM: Provided fileName could be potentially malicious, avoid [\'] character"); return; }
 
     Vector2 scale = GetWindowScaleDPI();
+
+#if defined(SUPPORT_ASYNC_SCREEN_CAPTURE)
+    // PNG screenshots are read back asynchronously and encoded on the capture thread
+    // NOTE: Screen contents are captured at call time, the file is written some frames later
+    if (IsFileExtension(fileName, ".png"))
+    {
+        CaptureJob screenshot = { .type = CAPTURE_JOB_SCREENSHOT };
+        screenshot.width = (int)((float)CORE.Window.render.width*scale.x);
+        screenshot.height = (int)((float)CORE.Window.render.height*scale.y);
+        strncpy(screenshot.fileName, TextFormat("%s/%s", CORE.Storage.basePath, GetFileName(fileName)), sizeof(screenshot.fileName) - 1);
+        RequestScreenCapture(screenshot);
+        return;
+    }
+#endif
+
     unsigned char *imgData = rlReadScreenPixels((int)((float)CORE.Window.render.width*scale.x), (int)((float)CORE.Window.render.height*scale.y));
     Image image = { imgData, (int)((float)CORE.Window.render.width*scale.x), (int)((float)CORE.Window.render.height*scale.y), 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
 
@@ -1820,6 +2008,18 @@ void TakeScreenshot(const char *fileName)
 #endif
 }
 
+// Read screen region into caller buffer, no allocation and no CPU-side copy
+// NOTE: rec is given in render pixels (screen size scaled by DPI), origin at top-left,
+// and must lie inside the screen; pixels must hold rec.width*rec.height*4 bytes (4-byte aligned)
+void ReadScreenPixels(Rectangle rec, unsigned char *pixels)
+{
+    Vector2 scale = GetWindowScaleDPI();
+    int renderHeight = (int)((float)CORE.Window.render.height*scale.y);
+
+    rlDrawRenderBatchActive();      // Pending shapes must reach the framebuffer first
+    rlReadScreenPixelsRec((int)rec.x, renderHeight - (int)rec.y - (int)rec.height, (int)rec.width, (int)rec.height, pixels);
+}
+
 // Setup window configuration flags (view FLAGS)
 // NOTE: This function is expected to be called before window creation,
 // because it sets up some flags for the window creation process.
@@ -2633,8 +2833,8 @@ void PlayAutomationEvent(AutomationEvent event)
             } break;
             case INPUT_MOUSE_WHEEL_MOTION:  // param[0]: x delta, param[1]: y delta
             {
-                CORE.Input.Mouse.currentWheelMove.x = (float)event.params[0]; break;
-                CORE.Input.Mouse.currentWheelMove.y = (float)event.params[1]; break;
+                CORE.Input.Mouse.currentWheelMove.x = (float)event.params[0];
+                CORE.Input.Mouse.currentWheelMove.y = (float)event.params[1];
             } break;
             case INPUT_TOUCH_UP: CORE.Input.Touch.currentTouchState[event.params[0]] = false; break;            // param[0]: id
             case INPUT_TOUCH_DOWN: CORE.Input.Touch.currentTouchState[event.params[0]] = true; break;           // param[0]: id
@@ -3570,6 +3770,291 @@ static void RecordAutomationEvent(void)
 }
 #endif
 
+#if defined(SUPPORT_ASYNC_SCREEN_CAPTURE)
+static void LockCaptureMutex(void)
+{
+#if defined(_WIN32)
+    AcquireSRWLockExclusive(&capture.mutex);
+#else
+    pthread_mutex_lock(&capture.mutex);
+#endif
+}
+
+static void UnlockCaptureMutex(void)
+{
+#if defined(_WIN32)
+    ReleaseSRWLockExclusive(&capture.mutex);
+#else
+    pthread_mutex_unlock(&capture.mutex);
+#endif
+}
+
+static void WaitCaptureCondition(CaptureCondition *condition)
+{
+#if defined(_WIN32)
+    SleepConditionVariableSRW(condition, &capture.mutex, 0xFFFFFFFF, 0);
+#else
+    pthread_cond_wait(condition, &capture.mutex);
+#endif
+}
+
+static void SignalCaptureCondition(CaptureCondition *condition)
+{
+#if defined(_WIN32)
+    WakeConditionVariable(condition);
+#else
+    pthread_cond_signal(condition);
+#endif
+}
+
+// Encode one capture job, runs on the encoder thread
+// NOTE: Only thread-safe raylib functions can be used here (no TextFormat(), no GL calls)
+static void ProcessCaptureJob(CaptureJob *job)
+{
+    switch (job->type)
+    {
+        case CAPTURE_JOB_SCREENSHOT:
+        {
+#if defined(SUPPORT_MODULE_RTEXTURES)
+            Image image = { job->data, job->width, job->height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+            int fileDataSize = 0;
+            unsigned char *fileData = ExportImageToMemory(image, ".png", &fileDataSize);    // WARNING: Module required: rtextures
+
+            if ((fileData != NULL) && SaveFileData(job->fileName, fileData, fileDataSize)) TRACELOG(LOG_INFO, "SYSTEM: [%s] Screenshot taken successfully", job->fileName);
+            else TRACELOG(LOG_WARNING, "SYSTEM: [%s] Screenshot could not be saved", job->fileName);
+
+            RL_FREE(fileData);
+#endif
+        } break;
+#if defined(SUPPORT_GIF_RECORDING)
+        case CAPTURE_JOB_GIF_BEGIN: msf_gif_begin(&gifState, job->width, job->height); break;
+        case CAPTURE_JOB_GIF_FRAME:
+        {
+            #ifndef GIF_RECORD_BITRATE
+            #define GIF_RECORD_BITRATE 16
+            #endif
+
+            msf_gif_frame(&gifState, job->data, job->delay, GIF_RECORD_BITRATE, job->width*4);
+        } break;
+        case CAPTURE_JOB_GIF_END:
+        {
+            MsfGifResult result = msf_gif_end(&gifState);
+            SaveFileData(job->fileName, result.data, (unsigned int)result.dataSize);
+            msf_gif_free(result);
+        } break;
+        case CAPTURE_JOB_GIF_CANCEL:
+        {
+            MsfGifResult result = msf_gif_end(&gifState);
+            msf_gif_free(result);
+        } break;
+#endif
+        default: break;
+    }
+
+    RL_FREE(job->data);
+    job->data = NULL;
+}
+
+#if defined(_WIN32)
+static unsigned long __stdcall CaptureThreadMain(void *arg)
+#else
+static void *CaptureThreadMain(void *arg)
+#endif
+{
+    (void)arg;
+    bool quit = false;
+
+    while (!quit)
+    {
+        LockCaptureMutex();
+        while (capture.queueCount == 0) WaitCaptureCondition(&capture.notEmpty);
+        CaptureJob job = capture.queue[capture.queueHead];
+        capture.queueHead = (capture.queueHead + 1)%CAPTURE_QUEUE_SIZE;
+        capture.queueCount--;
+        SignalCaptureCondition(&capture.notFull);
+        UnlockCaptureMutex();
+
+        quit = (job.type == CAPTURE_JOB_QUIT);
+        ProcessCaptureJob(&job);
+    }
+
+    return 0;
+}
+
+// Start encoder thread
+static void InitScreenCapture(void)
+{
+    if (capture.threadRunning) return;
+
+#if defined(_WIN32)
+    capture.thread = CreateThread(NULL, 0, CaptureThreadMain, NULL, 0, NULL);
+    capture.threadRunning = (capture.thread != NULL);
+#else
+    pthread_mutex_init(&capture.mutex, NULL);
+    pthread_cond_init(&capture.notEmpty, NULL);
+    pthread_cond_init(&capture.notFull, NULL);
+    capture.threadRunning = (pthread_create(&capture.thread, NULL, CaptureThreadMain, NULL) == 0);
+#endif
+
+    if (!capture.threadRunning) TRACELOG(LOG_WARNING, "SYSTEM: Failed to start screen capture encoder thread, capture runs synchronously");
+}
+
+// Flush pending captures and stop encoder thread
+static void CloseScreenCapture(void)
+{
+    UpdateScreenCapture(true);
+
+    if (capture.threadRunning)
+    {
+        CaptureJob quit = { .type = CAPTURE_JOB_QUIT };
+        PushCaptureJob(quit, true);
+
+#if defined(_WIN32)
+        WaitForSingleObject(capture.thread, 0xFFFFFFFF);
+        CloseHandle(capture.thread);
+#else
+        pthread_join(capture.thread, NULL);
+        pthread_cond_destroy(&capture.notFull);
+        pthread_cond_destroy(&capture.notEmpty);
+        pthread_mutex_destroy(&capture.mutex);
+#endif
+        capture.threadRunning = false;
+    }
+
+    for (int i = 0; i < CAPTURE_READBACK_SLOTS; i++)
+    {
+        if (capture.slots[i].pbo != 0) rlUnloadPixelBuffer(capture.slots[i].pbo);
+        capture.slots[i].pbo = 0;
+        capture.slots[i].size = 0;
+    }
+}
+
+// Push job to encoder queue, if not waiting fails when queue is full
+// NOTE: Without encoder thread the job is processed right away
+static bool PushCaptureJob(CaptureJob job, bool wait)
+{
+    if (!capture.threadRunning)
+    {
+        ProcessCaptureJob(&job);
+        return true;
+    }
+
+    LockCaptureMutex();
+    if (!wait && (capture.queueCount == CAPTURE_QUEUE_SIZE))
+    {
+        UnlockCaptureMutex();
+        return false;
+    }
+
+    while (capture.queueCount == CAPTURE_QUEUE_SIZE) WaitCaptureCondition(&capture.notFull);
+    capture.queue[(capture.queueHead + capture.queueCount)%CAPTURE_QUEUE_SIZE] = job;
+    capture.queueCount++;
+    SignalCaptureCondition(&capture.notEmpty);
+    UnlockCaptureMutex();
+
+    return true;
+}
+
+// Queue captured frame, GIF frames are dropped (and counted) when the encoder falls behind
+static void QueueCapturedFrame(CaptureJob job)
+{
+    if (!PushCaptureJob(job, job.type != CAPTURE_JOB_GIF_FRAME))
+    {
+        RL_FREE(job.data);
+        capture.droppedFrames++;
+    }
+}
+
+// Copy readback into a top-down image with opaque alpha
+static unsigned char *CopyFlippedPixels(const unsigned char *pixels, int width, int height)
+{
+    unsigned char *data = (unsigned char *)RL_MALLOC(width*height*4);
+    if (data == NULL) return NULL;
+
+    const int stride = width*4;
+    for (int y = 0; y < height; y++) memcpy(data + (height - 1 - y)*stride, pixels + y*stride, stride);
+
+    // NOTE: Alpha value has already been applied to RGB in framebuffer, we don't need it
+    const unsigned char alphaBytes[4] = { 0, 0, 0, 255 };
+    unsigned int alphaMask = 0;
+    memcpy(&alphaMask, alphaBytes, 4);
+    for (int i = 0; i < width*height; i++) ((unsigned int *)data)[i] |= alphaMask;
+
+    return data;
+}
+
+// Collect readback slot if the GPU is done with it (or waiting for it), returns false if still in flight
+static bool CollectCaptureSlot(CaptureSlot *slot, bool wait)
+{
+    if (!wait && !rlIsFenceSignaled(slot->fence)) return false;
+
+    const unsigned char *pixels = (const unsigned char *)rlMapPixelBuffer(slot->pbo, slot->size);
+    if (pixels != NULL)
+    {
+        slot->job.data = CopyFlippedPixels(pixels, slot->job.width, slot->job.height);
+        rlUnmapPixelBuffer(slot->pbo);
+    }
+    rlUnloadFence(slot->fence);
+    slot->fence = NULL;
+    slot->pending = false;
+
+    if (slot->job.data != NULL) QueueCapturedFrame(slot->job);
+    else TRACELOG(LOG_WARNING, "SYSTEM: Failed to read back screen capture");
+
+    return true;
+}
+
+// Collect finished readbacks (in order) and queue them for encoding
+static void UpdateScreenCapture(bool wait)
+{
+    for (int i = 0; i < CAPTURE_READBACK_SLOTS; i++)
+    {
+        CaptureSlot *slot = &capture.slots[(capture.nextSlot + i)%CAPTURE_READBACK_SLOTS];
+        if (slot->pending && !CollectCaptureSlot(slot, wait)) break;    // Keep frames ordered
+    }
+}
+
+// Start asynchronous readback of current screen for a capture job
+static void RequestScreenCapture(CaptureJob job)
+{
+    InitScreenCapture();
+
+    if (!rlIsPixelBufferSupported())
+    {
+        job.data = rlReadScreenPixels(job.width, job.height);
+        QueueCapturedFrame(job);
+        return;
+    }
+
+    CaptureSlot *slot = &capture.slots[capture.nextSlot];
+    if (slot->pending)
+    {
+        // All readbacks still in flight, GIF frames are dropped instead of stalling the frame
+        if (job.type == CAPTURE_JOB_GIF_FRAME && !rlIsFenceSignaled(slot->fence))
+        {
+            capture.droppedFrames++;
+            return;
+        }
+
+        UpdateScreenCapture(true);
+    }
+
+    const int size = job.width*job.height*4;
+    if (slot->size != size)
+    {
+        if (slot->pbo != 0) rlUnloadPixelBuffer(slot->pbo);
+        slot->pbo = rlLoadPixelBuffer(size);
+        slot->size = size;
+    }
+
+    rlReadScreenPixelsToBuffer(slot->pbo, job.width, job.height);
+    slot->fence = rlLoadFence();
+    slot->job = job;
+    slot->pending = true;
+    capture.nextSlot = (capture.nextSlot + 1)%CAPTURE_READBACK_SLOTS;
+}
+#endif  // SUPPORT_ASYNC_SCREEN_CAPTURE
+
 #if !defined(SUPPORT_MODULE_RTEXT)
 // Formatting of text with variables to 'embed'
 // WARNING: String returned will expire after this function is called MAX_TEXTFORMAT_BUFFERS times
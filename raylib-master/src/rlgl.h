@@ -387,6 +387,15 @@ typedef struct rlRenderBatch {
     float currentDepth;         // Current depth value for next draw
 } rlRenderBatch;
 
+// Render batch statistics, accumulated on every batch draw until reset
+typedef struct rlRenderStats {
+    int drawCalls;              // Number of draw calls submitted to the GPU
+    int vertexCount;            // Number of vertices uploaded and drawn
+} rlRenderStats;
+
+// Trace zone callback, called on begin/end of expensive internal operations (batch draw, buffers swap)
+typedef void (*rlTraceZoneCallback)(const char *name, bool begin);
+
 // OpenGL version
 typedef enum {
     RL_OPENGL_11 = 1,           // OpenGL 1.1
@@ -683,6 +692,9 @@ RLAPI void rlDrawRenderBatch(rlRenderBatch *batch);     // Draw render batch dat
 RLAPI void rlSetRenderBatchActive(rlRenderBatch *batch); // Set the active render batch for rlgl (NULL for default internal)
 RLAPI void rlDrawRenderBatchActive(void);               // Update and draw internal render batch
 RLAPI bool rlCheckRenderBatchLimit(int vCount);         // Check internal buffer overflow for a given number of vertex
+RLAPI rlRenderStats rlGetRenderStats(void);             // Get render batch statistics accumulated since last reset
+RLAPI void rlResetRenderStats(void);                    // Reset render batch statistics
+RLAPI void rlSetTraceZoneCallback(rlTraceZoneCallback callback); // Set trace zone callback (NULL to disable)
 
 RLAPI void rlSetTexture(unsigned int id);               // Set current texture for render batch and check buffers limits
 
@@ -715,6 +727,27 @@ RLAPI void rlUnloadTexture(unsigned int id);                              // Unl
 RLAPI void rlGenTextureMipmaps(unsigned int id, int width, int height, int format, int *mipmaps); // Generate mipmap data for selected texture
 RLAPI void *rlReadTexturePixels(unsigned int id, int width, int height, int format); // Read texture pixel data
 RLAPI unsigned char *rlReadScreenPixels(int width, int height);           // Read screen pixel data (color buffer)
+RLAPI void rlReadScreenPixelsRec(int x, int y, int width, int height, unsigned char *data); // Read screen pixel region into buffer (RGBA, top-down, opaque)
+
+// Asynchronous readback: pixel pack buffers (pbo) and fences, only supported on OpenGL 3.3+
+RLAPI bool rlIsPixelBufferSupported(void);                                // Check if asynchronous pixel readback is supported
+RLAPI unsigned int rlLoadPixelBuffer(int size);                           // Load pixel pack buffer for asynchronous readback
+RLAPI void rlUnloadPixelBuffer(unsigned int id);                          // Unload pixel pack buffer
+RLAPI void rlReadScreenPixelsToBuffer(unsigned int id, int width, int height); // Start reading screen pixels (RGBA, bottom-up) into pixel buffer
+RLAPI void *rlMapPixelBuffer(unsigned int id, int size);                  // Map pixel buffer for reading (blocks until readback completes)
+RLAPI void rlUnmapPixelBuffer(unsigned int id);                           // Unmap pixel buffer
+RLAPI void *rlLoadFence(void);                                            // Insert a fence after the commands issued so far
+RLAPI bool rlIsFenceSignaled(void *fence);                                // Check if GPU reached the fence (non-blocking)
+RLAPI void rlUnloadFence(void *fence);                                    // Unload fence
+
+// GPU timer queries, only supported on OpenGL 3.3+ (or ARB_timer_query)
+RLAPI bool rlIsTimerQuerySupported(void);                                 // Check if GPU timer queries are supported
+RLAPI unsigned int rlLoadTimerQuery(void);                                // Load timer query object
+RLAPI void rlUnloadTimerQuery(unsigned int id);                           // Unload timer query object
+RLAPI void rlBeginTimerQuery(unsigned int id);                            // Start measuring GPU time of the following commands (one query active at a time)
+RLAPI void rlEndTimerQuery(void);                                         // Stop measuring GPU time
+RLAPI bool rlIsTimerQueryReady(unsigned int id);                          // Check if query result is available (non-blocking)
+RLAPI unsigned long long int rlGetTimerQueryResult(unsigned int id);      // Get measured GPU time in nanoseconds (blocks until available)
 
 // Framebuffer management (fbo)
 RLAPI unsigned int rlLoadFramebuffer(void);                               // Load an empty framebuffer
@@ -1030,6 +1063,8 @@ typedef struct rlglData {
         int framebufferWidth;               // Current framebuffer width
         int framebufferHeight;              // Current framebuffer height
 
+        rlRenderStats stats;                // Render batch statistics (draw calls, vertices)
+
     } State;            // Renderer state
     struct {
         bool vao;                           // VAO support (OpenGL ES2 could not support VAO extension) (GL_ARB_vertex_array_object)
@@ -1066,6 +1101,12 @@ typedef void *(*rlglLoadProc)(const char *name);   // OpenGL extension functions
 static rlglData RLGL = { 0 };
 #endif  // GRAPHICS_API_OPENGL_33 || GRAPHICS_API_OPENGL_ES2
 
+static rlTraceZoneCallback rlTraceZone = NULL;      // Trace zone callback, NULL when tracing is disabled
+
+// NOTE: Tracing disabled costs a single branch on a NULL callback
+#define RL_TRACE_ZONE_BEGIN(name) do { if (rlTraceZone != NULL) rlTraceZone(name, true); } while (0)
+#define RL_TRACE_ZONE_END(name) do { if (rlTraceZone != NULL) rlTraceZone(name, false); } while (0)
+
 #if defined(GRAPHICS_API_OPENGL_ES2) && !defined(GRAPHICS_API_OPENGL_ES3)
 // NOTE: VAO functionality is exposed through extensions (OES)
 static PFNGLGENVERTEXARRAYSOESPROC glGenVertexArrays = NULL;
@@ -2765,6 +2806,8 @@ void rlUnloadRenderBatch(rlRenderBatch batch)
 void rlDrawRenderBatch(rlRenderBatch *batch)
 {
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    RL_TRACE_ZONE_BEGIN("rlDrawRenderBatch");
+
     // Update batch vertex buffers
     //------------------------------------------------------------------------------------------------------------
     // NOTE: If there is not vertex data, buffers doesn't need to be updated (vertexCount > 0)
@@ -2886,6 +2929,9 @@ void rlDrawRenderBatch(rlRenderBatch *batch)
             // NOTE: Batch system accumulates calls by texture0 changes, additional textures are enabled for all the draw calls
             glActiveTexture(GL_TEXTURE0);
 
+            RLGL.State.stats.drawCalls += batch->drawCounter;
+            RLGL.State.stats.vertexCount += RLGL.State.vertexCounter;
+
             for (int i = 0, vertexOffset = 0; i < batch->drawCounter; i++)
             {
                 // Bind current draw call texture, activated as GL_TEXTURE0 and Bound to sampler2D texture0 by default
@@ -2956,6 +3002,8 @@ void rlDrawRenderBatch(rlRenderBatch *batch)
     // Change to next buffer in the list (in case of multi-buffering)
     batch->currentBuffer++;
     if (batch->currentBuffer >= batch->bufferCount) batch->currentBuffer = 0;
+
+    RL_TRACE_ZONE_END("rlDrawRenderBatch");
 #endif
 }
 
@@ -2978,6 +3026,31 @@ void rlDrawRenderBatchActive(void)
 #endif
 }
 
+// Get render batch statistics accumulated since last reset
+rlRenderStats rlGetRenderStats(void)
+{
+    rlRenderStats stats = { 0 };
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    stats = RLGL.State.stats;
+#endif
+    return stats;
+}
+
+// Reset render batch statistics
+void rlResetRenderStats(void)
+{
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    RLGL.State.stats.drawCalls = 0;
+    RLGL.State.stats.vertexCount = 0;
+#endif
+}
+
+// Set trace zone callback (NULL to disable)
+void rlSetTraceZoneCallback(rlTraceZoneCallback callback)
+{
+    rlTraceZone = callback;
+}
+
 // Check internal buffer overflow for a given number of vertex
 // and force a rlRenderBatch draw call if required
 bool rlCheckRenderBatchLimit(int vCount)
@@ -3486,30 +3559,248 @@ void *rlReadTexturePixels(unsigned int id, int width, int height, int format)
 // Read screen pixel data (color buffer)
 unsigned char *rlReadScreenPixels(int width, int height)
 {
-    unsigned char *screenData = (unsigned char *)RL_CALLOC(width*height*4, sizeof(unsigned char));
+    unsigned char *imgData = (unsigned char *)RL_MALLOC(width*height*4*sizeof(unsigned char));
+    if (imgData != NULL) rlReadScreenPixelsRec(0, 0, width, height, imgData);
 
+    return imgData;     // NOTE: image data should be freed
+}
+
+// Read screen pixel region into buffer (width*height*4 bytes, 4-byte aligned)
+// NOTE: x, y are framebuffer coordinates (origin at bottom-left), data is returned top-down
+void rlReadScreenPixelsRec(int x, int y, int width, int height, unsigned char *data)
+{
     // NOTE 1: glReadPixels returns image flipped vertically -> (0,0) is the bottom left corner of the framebuffer
     // NOTE 2: We are getting alpha channel! Be careful, it can be transparent if not cleared properly!
-    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, screenData);
+    glReadPixels(x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data);
 
-    // Flip image vertically!
-    unsigned char *imgData = (unsigned char *)RL_MALLOC(width*height*4*sizeof(unsigned char));
+    // Alpha byte of an RGBA pixel read as a 32bit word, independent of endianness
+    const unsigned char alphaBytes[4] = { 0, 0, 0, 255 };
+    unsigned int alphaMask = 0;
+    memcpy(&alphaMask, alphaBytes, 4);
 
-    for (int y = height - 1; y >= 0; y--)
+    // Flip image vertically in place, swapping whole lines through a small stack buffer
+    const int stride = width*4;
+    unsigned char swap[1024];
+
+    for (int top = 0, bottom = height - 1; top <= bottom; top++, bottom--)
     {
-        for (int x = 0; x < (width*4); x++)
+        unsigned char *topLine = data + top*stride;
+        unsigned char *bottomLine = data + bottom*stride;
+
+        for (int offset = 0; (top < bottom) && (offset < stride); offset += (int)sizeof(swap))
         {
-            imgData[((height - 1) - y)*width*4 + x] = screenData[(y*width*4) + x];  // Flip line
+            int size = ((stride - offset) < (int)sizeof(swap))? (stride - offset) : (int)sizeof(swap);
+            memcpy(swap, topLine + offset, size);
+            memcpy(topLine + offset, bottomLine + offset, size);
+            memcpy(bottomLine + offset, swap, size);
+        }
 
-            // Set alpha component value to 255 (no trasparent image retrieval)
-            // NOTE: Alpha value has already been applied to RGB in framebuffer, we don't need it!
-            if (((x + 1)%4) == 0) imgData[((height - 1) - y)*width*4 + x] = 255;
+        // Set alpha component value to 255 (no trasparent image retrieval)
+        // NOTE: Alpha value has already been applied to RGB in framebuffer, we don't need it!
+        unsigned int *topPixels = (unsigned int *)topLine;
+        unsigned int *bottomPixels = (unsigned int *)bottomLine;
+        for (int i = 0; i < width; i++)
+        {
+            topPixels[i] |= alphaMask;
+            bottomPixels[i] |= alphaMask;
         }
     }
+}
+
+// Check if asynchronous pixel readback is supported
+bool rlIsPixelBufferSupported(void)
+{
+#if defined(GRAPHICS_API_OPENGL_33)
+    return true;
+#else
+    return false;
+#endif
+}
 
-    RL_FREE(screenData);
+// Load pixel pack buffer for asynchronous readback
+unsigned int rlLoadPixelBuffer(int size)
+{
+    unsigned int id = 0;
 
-    return imgData;     // NOTE: image data should be freed
+#if defined(GRAPHICS_API_OPENGL_33)
+    glGenBuffers(1, &id);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, id);
+    glBufferData(GL_PIXEL_PACK_BUFFER, size, NULL, GL_STREAM_READ);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+#endif
+
+    return id;
+}
+
+// Unload pixel pack buffer
+void rlUnloadPixelBuffer(unsigned int id)
+{
+#if defined(GRAPHICS_API_OPENGL_33)
+    glDeleteBuffers(1, &id);
+#endif
+}
+
+// Start reading screen pixels into pixel buffer
+// NOTE: glReadPixels() returns immediately when a pack buffer is bound, data is
+// bottom-up (OpenGL convention) and must be flipped by the reader
+void rlReadScreenPixelsToBuffer(unsigned int id, int width, int height)
+{
+#if defined(GRAPHICS_API_OPENGL_33)
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, id);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+#endif
+}
+
+// Map pixel buffer for reading
+void *rlMapPixelBuffer(unsigned int id, int size)
+{
+    void *data = NULL;
+
+#if defined(GRAPHICS_API_OPENGL_33)
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, id);
+    data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+#endif
+
+    return data;
+}
+
+// Unmap pixel buffer
+void rlUnmapPixelBuffer(unsigned int id)
+{
+#if defined(GRAPHICS_API_OPENGL_33)
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, id);
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+#endif
+}
+
+// Insert a fence after the commands issued so far
+void *rlLoadFence(void)
+{
+    void *fence = NULL;
+
+#if defined(GRAPHICS_API_OPENGL_33)
+    fence = (void *)glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+#endif
+
+    return fence;
+}
+
+// Check if GPU reached the fence (non-blocking)
+bool rlIsFenceSignaled(void *fence)
+{
+    bool signaled = true;
+
+#if defined(GRAPHICS_API_OPENGL_33)
+    if (fence != NULL)
+    {
+        // NOTE: Flush is required, otherwise the fence could never reach the GPU
+        GLenum result = glClientWaitSync((GLsync)fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        signaled = (result == GL_ALREADY_SIGNALED) || (result == GL_CONDITION_SATISFIED);
+    }
+#endif
+
+    return signaled;
+}
+
+// Unload fence
+void rlUnloadFence(void *fence)
+{
+#if defined(GRAPHICS_API_OPENGL_33)
+    if (fence != NULL) glDeleteSync((GLsync)fence);
+#endif
+}
+
+// Check if GPU timer queries are supported
+bool rlIsTimerQuerySupported(void)
+{
+#if defined(GRAPHICS_API_OPENGL_33)
+    return (GLAD_GL_VERSION_3_3 || GLAD_GL_ARB_timer_query);
+#else
+    return false;
+#endif
+}
+
+// Load timer query object
+unsigned int rlLoadTimerQuery(void)
+{
+    unsigned int id = 0;
+
+#if defined(GRAPHICS_API_OPENGL_33)
+    if (rlIsTimerQuerySupported()) glGenQueries(1, &id);
+#endif
+
+    return id;
+}
+
+// Unload timer query object
+void rlUnloadTimerQuery(unsigned int id)
+{
+#if defined(GRAPHICS_API_OPENGL_33)
+    if (id > 0) glDeleteQueries(1, &id);
+#endif
+}
+
+// Start measuring GPU time of the following commands
+// NOTE: Pending render batch is drawn first, so it is not counted in the query
+void rlBeginTimerQuery(unsigned int id)
+{
+#if defined(GRAPHICS_API_OPENGL_33)
+    if (id > 0)
+    {
+        rlDrawRenderBatchActive();
+        glBeginQuery(GL_TIME_ELAPSED, id);
+    }
+#endif
+}
+
+// Stop measuring GPU time
+// NOTE: Pending render batch is drawn first, so it is counted in the query
+void rlEndTimerQuery(void)
+{
+#if defined(GRAPHICS_API_OPENGL_33)
+    if (rlIsTimerQuerySupported())
+    {
+        rlDrawRenderBatchActive();
+        glEndQuery(GL_TIME_ELAPSED);
+    }
+#endif
+}
+
+// Check if query result is available (non-blocking)
+bool rlIsTimerQueryReady(unsigned int id)
+{
+    bool ready = true;
+
+#if defined(GRAPHICS_API_OPENGL_33)
+    if (id > 0)
+    {
+        GLint available = 0;
+        glGetQueryObjectiv(id, GL_QUERY_RESULT_AVAILABLE, &available);
+        ready = (available != 0);
+    }
+#endif
+
+    return ready;
+}
+
+// Get measured GPU time in nanoseconds
+unsigned long long int rlGetTimerQueryResult(unsigned int id)
+{
+    unsigned long long int time = 0;
+
+#if defined(GRAPHICS_API_OPENGL_33)
+    if (id > 0)
+    {
+        GLuint64 result = 0;
+        glGetQueryObjectui64v(id, GL_QUERY_RESULT, &result);
+        time = (unsigned long long int)result;
+    }
+#endif
+
+    return time;
 }
 
 // Framebuffer management (fbo)
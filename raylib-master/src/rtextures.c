@@ -265,6 +265,12 @@ extern void LoadFontDefault(void);          // [Module: text] Loads default font
 static float HalfToFloat(unsigned short x);
 static unsigned short FloatToHalf(float x);
 static Vector4 *LoadImageDataNormalized(Image image);       // Load pixel data from image as Vector4 array (float normalized)
+static bool ImageFormatDirect(Image *image, int newFormat); // Convert between 8bit formats without float intermediate, returns false if not supported
+static int GetImageDrawPixel(const Image *dst, Color color, unsigned char *pixel); // Get color in image format, returns bytes per pixel (0 if not drawable)
+static inline void SetImagePixel(Image *dst, int x, int y, const unsigned char *pixel, int bytesPerPixel); // Set pixel already converted to image format
+static void FillImageSpans(Image *dst, int posX, int posY, int width, int height, const unsigned char *pixel, int bytesPerPixel); // Fill rectangle (inside image) with pixel
+static void FillImageRectangle(Image *dst, Rectangle rec, const unsigned char *pixel, int bytesPerPixel); // Clip rectangle to image and fill it with pixel
+static void DrawImageLine(Image *dst, int startPosX, int startPosY, int endPosX, int endPosY, const unsigned char *pixel, int bytesPerPixel); // Draw line with pixel
 
 //----------------------------------------------------------------------------------
 // Module Functions Definition
@@ -1330,6 +1336,9 @@ void ImageFormat(Image *image, int newFormat)
 
     if ((newFormat != 0) && (image->format != newFormat))
     {
+        // Conversions between 8bit formats use integer kernels, the rest go through normalized floats
+        if (ImageFormatDirect(image, newFormat)) return;
+
         if ((image->format < PIXELFORMAT_COMPRESSED_DXT1_RGB) && (newFormat < PIXELFORMAT_COMPRESSED_DXT1_RGB))
         {
             Vector4 *pixels = LoadImageDataNormalized(*image);     // Supports 8 to 32 bit per channel
@@ -3223,17 +3232,11 @@ void ImageClearBackground(Image *dst, Color color)
     // Security check to avoid program crash
     if ((dst->data == NULL) || (dst->width == 0) || (dst->height == 0)) return;
 
-    // Fill in first pixel based on image format
-    ImageDrawPixel(dst, 0, 0, color);
-
-    unsigned char *pSrcPixel = (unsigned char *)dst->data;
-    int bytesPerPixel = GetPixelDataSize(1, 1, dst->format);
+    // Convert color to image format once, then fill rows with wide stores
+    unsigned char pixel[16] = { 0 };
+    int bytesPerPixel = GetImageDrawPixel(dst, color, pixel);
 
-    // Repeat the first pixel data throughout the image
-    for (int i = 1; i < dst->width*dst->height; i++)
-    {
-        memcpy(pSrcPixel + i*bytesPerPixel, pSrcPixel, bytesPerPixel);
-    }
+    if (bytesPerPixel > 0) FillImageSpans(dst, 0, 0, dst->width, dst->height, pixel, bytesPerPixel);
 }
 
 // Draw pixel within an image
@@ -3386,91 +3389,22 @@ void ImageDrawPixelV(Image *dst, Vector2 position, Color color)
 // Draw line within an image
 void ImageDrawLine(Image *dst, int startPosX, int startPosY, int endPosX, int endPosY, Color color)
 {
-    // Using Bresenham's algorithm as described in
-    // Drawing Lines with Pixels - Joshua Scott - March 2012
-    // https://classic.csunplugged.org/wp-content/uploads/2014/12/Lines.pdf
-
-    int changeInX = (endPosX - startPosX);
-    int absChangeInX = (changeInX < 0)? -changeInX : changeInX;
-    int changeInY = (endPosY - startPosY);
-    int absChangeInY = (changeInY < 0)? -changeInY : changeInY;
-
-    int startU, startV, endU, stepV; // Substitutions, either U = X, V = Y or vice versa. See loop at end of function
-    //int endV;     // Not needed but left for better understanding, check code below
-    int A, B, P;    // See linked paper above, explained down in the main loop
-    int reversedXY = (absChangeInY < absChangeInX);
-
-    if (reversedXY)
-    {
-        A = 2*absChangeInY;
-        B = A - 2*absChangeInX;
-        P = A - absChangeInX;
-
-        if (changeInX > 0)
-        {
-            startU = startPosX;
-            startV = startPosY;
-            endU = endPosX;
-            //endV = endPosY;
-        }
-        else
-        {
-            startU = endPosX;
-            startV = endPosY;
-            endU = startPosX;
-            //endV = startPosY;
-
-            // Since start and end are reversed
-            changeInX = -changeInX;
-            changeInY = -changeInY;
-        }
-
-        stepV = (changeInY < 0)? -1 : 1;
-
-        ImageDrawPixel(dst, startU, startV, color);     // At this point they are correctly ordered...
-    }
-    else
-    {
-        A = 2*absChangeInX;
-        B = A - 2*absChangeInY;
-        P = A - absChangeInY;
-
-        if (changeInY > 0)
-        {
-            startU = startPosY;
-            startV = startPosX;
-            endU = endPosY;
-            //endV = endPosX;
-        }
-        else
-        {
-            startU = endPosY;
-            startV = endPosX;
-            endU = startPosY;
-            //endV = startPosX;
-
-            // Since start and end are reversed
-            changeInX = -changeInX;
-            changeInY = -changeInY;
-        }
+    unsigned char pixel[16] = { 0 };
+    int bytesPerPixel = GetImageDrawPixel(dst, color, pixel);
 
-        stepV = (changeInX < 0)? -1 : 1;
+    if (bytesPerPixel > 0) DrawImageLine(dst, startPosX, startPosY, endPosX, endPosY, pixel, bytesPerPixel);
+}
 
-        ImageDrawPixel(dst, startV, startU, color);     // ... but need to be reversed here. Repeated in the main loop below
-    }
+// Draw lines within an image, one line per pair of points (color converted only once)
+void ImageDrawLines(Image *dst, const Vector2 *points, int pointCount, Color color)
+{
+    unsigned char pixel[16] = { 0 };
+    int bytesPerPixel = GetImageDrawPixel(dst, color, pixel);
+    if ((bytesPerPixel == 0) || (points == NULL)) return;
 
-    // We already drew the start point. If we started at startU + 0, the line would be crooked and too short
-    for (int u = startU + 1, v = startV; u <= endU; u++)
+    for (int i = 0; (i + 1) < pointCount; i += 2)
     {
-        if (P >= 0)
-        {
-            v += stepV;     // Adjusts whenever we stray too far from the direct line. Details in the linked paper above
-            P += B;         // Remembers that we corrected our path
-        }
-        else P += A;        // Remembers how far we are from the direct line
-
-        if (reversedXY) ImageDrawPixel(dst, u, v, color);
-        else ImageDrawPixel(dst, v, u, color);
+        DrawImageLine(dst, (int)points[i].x, (int)points[i].y, (int)points[i + 1].x, (int)points[i + 1].y, pixel, bytesPerPixel);
     }
 }
 
@@ -3562,43 +3496,23 @@ void ImageDrawRectangleRec(Image *dst, Rectangle rec, Color color)
     // Security check to avoid program crash
     if ((dst->data == NULL) || (dst->width == 0) || (dst->height == 0)) return;
 
-    // Security check to avoid drawing out of bounds in case of bad user data
-    if (rec.x < 0) { rec.width += rec.x; rec.x = 0; }
-    if (rec.y < 0) { rec.height += rec.y; rec.y = 0; }
-    if (rec.width < 0) rec.width = 0;
-    if (rec.height < 0) rec.height = 0;
-
-    // Clamp the size the the image bounds
-    if ((rec.x + rec.width) >= dst->width) rec.width = dst->width - rec.x;
-    if ((rec.y + rec.height) >= dst->height) rec.height = dst->height - rec.y;
-
-    // Check if the rect is even inside the image
-    if ((rec.x >= dst->width) || (rec.y >= dst->height)) return;
-    if (((rec.x + rec.width) <= 0) || (rec.y + rec.height <= 0)) return;
+    unsigned char pixel[16] = { 0 };
+    int bytesPerPixel = GetImageDrawPixel(dst, color, pixel);
 
-    int sy = (int)rec.y;
-    int sx = (int)rec.x;
-
-    int bytesPerPixel = GetPixelDataSize(1, 1, dst->format);
-
-    // Fill in the first pixel of the first row based on image format
-    ImageDrawPixel(dst, sx, sy, color);
+    if (bytesPerPixel > 0) FillImageRectangle(dst, rec, pixel, bytesPerPixel);
+}
 
-    int bytesOffset = ((sy*dst->width) + sx)*bytesPerPixel;
-    unsigned char *pSrcPixel = (unsigned char *)dst->data + bytesOffset;
+// Draw rectangles within an image (color converted only once)
+void ImageDrawRectangles(Image *dst, const Rectangle *recs, int count, Color color)
+{
+    // Security check to avoid program crash
+    if ((dst->data == NULL) || (dst->width == 0) || (dst->height == 0) || (recs == NULL)) return;
 
-    // Repeat the first pixel data throughout the row
-    for (int x = 1; x < (int)rec.width; x++)
-    {
-        memcpy(pSrcPixel + x*bytesPerPixel, pSrcPixel, bytesPerPixel);
-    }
+    unsigned char pixel[16] = { 0 };
+    int bytesPerPixel = GetImageDrawPixel(dst, color, pixel);
+    if (bytesPerPixel == 0) return;
 
-    // Repeat the first row data for all other rows
-    int bytesPerRow = bytesPerPixel * (int)rec.width;
-    for (int y = 1; y < (int)rec.height; y++)
-    {
-        memcpy(pSrcPixel + (y*dst->width)*bytesPerPixel, pSrcPixel, bytesPerRow);
-    }
+    for (int i = 0; i < count; i++) FillImageRectangle(dst, recs[i], pixel, bytesPerPixel);
 }
 
 // Draw rectangle lines within an image
@@ -4997,6 +4911,294 @@ int GetPixelDataSize(int width, int height, int format)
 //----------------------------------------------------------------------------------
 // Module specific Functions Definition
 //----------------------------------------------------------------------------------
+// Convert image data between 8bit per channel formats (GRAYSCALE, GRAY_ALPHA, R8G8B8, R8G8B8A8)
+// NOTE: Integer kernels read source and write the new buffer directly, no float intermediate,
+// plain loops over separate buffers the compiler can vectorize; grayscale uses 16bit fixed-point
+// weights (0.299, 0.587, 0.114), same as float path except rounding of a few colors off by one
+static bool ImageFormatDirect(Image *image, int newFormat)
+{
+    int format = image->format;
+    bool source8bit = (format == PIXELFORMAT_UNCOMPRESSED_GRAYSCALE) || (format == PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA) ||
+                      (format == PIXELFORMAT_UNCOMPRESSED_R8G8B8) || (format == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    bool target8bit = (newFormat == PIXELFORMAT_UNCOMPRESSED_GRAYSCALE) || (newFormat == PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA) ||
+                      (newFormat == PIXELFORMAT_UNCOMPRESSED_R8G8B8) || (newFormat == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    if (!source8bit || !target8bit) return false;
+
+    // NOTE: Size computed in bytes, GetPixelDataSize() counts bits and overflows past 64 Mpixels at 32bpp
+    int pixelCount = image->width*image->height;
+    unsigned char *output = (unsigned char *)RL_MALLOC((size_t)pixelCount*GetPixelDataSize(1, 1, newFormat));
+    if (output == NULL) return false;
+
+    const unsigned char *src = (const unsigned char *)image->data;
+    unsigned char *dst = output;
+
+    #define GRAY_FROM_RGB(p) (unsigned char)((src[p]*19595 + src[(p) + 1]*38470 + src[(p) + 2]*7471) >> 16)
+
+    switch (newFormat)
+    {
+        case PIXELFORMAT_UNCOMPRESSED_GRAYSCALE:
+        {
+            if (format == PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA) for (int i = 0; i < pixelCount; i++) dst[i] = src[i*2];
+            else if (format == PIXELFORMAT_UNCOMPRESSED_R8G8B8) for (int i = 0; i < pixelCount; i++) dst[i] = GRAY_FROM_RGB(i*3);
+            else for (int i = 0; i < pixelCount; i++) dst[i] = GRAY_FROM_RGB(i*4);
+        } break;
+        case PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA:
+        {
+            if (format == PIXELFORMAT_UNCOMPRESSED_GRAYSCALE) for (int i = 0; i < pixelCount; i++) { dst[i*2] = src[i]; dst[i*2 + 1] = 255; }
+            else if (format == PIXELFORMAT_UNCOMPRESSED_R8G8B8) for (int i = 0; i < pixelCount; i++) { dst[i*2] = GRAY_FROM_RGB(i*3); dst[i*2 + 1] = 255; }
+            else for (int i = 0; i < pixelCount; i++) { dst[i*2] = GRAY_FROM_RGB(i*4); dst[i*2 + 1] = src[i*4 + 3]; }
+        } break;
+        case PIXELFORMAT_UNCOMPRESSED_R8G8B8:
+        {
+            if (format == PIXELFORMAT_UNCOMPRESSED_GRAYSCALE) for (int i = 0; i < pixelCount; i++) { dst[i*3] = src[i]; dst[i*3 + 1] = src[i]; dst[i*3 + 2] = src[i]; }
+            else if (format == PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA) for (int i = 0; i < pixelCount; i++) { dst[i*3] = src[i*2]; dst[i*3 + 1] = src[i*2]; dst[i*3 + 2] = src[i*2]; }
+            else for (int i = 0; i < pixelCount; i++) { dst[i*3] = src[i*4]; dst[i*3 + 1] = src[i*4 + 1]; dst[i*3 + 2] = src[i*4 + 2]; }
+        } break;
+        case PIXELFORMAT_UNCOMPRESSED_R8G8B8A8:
+        {
+            // Gray is spread to RGB with one multiply per pixel, bytes are placed independently of endianness
+            const unsigned char grayBytes[4] = { 1, 1, 1, 0 };
+            const unsigned char alphaBytes[4] = { 0, 0, 0, 1 };
+            unsigned int grayUnit = 0;
+            unsigned int alphaUnit = 0;
+            memcpy(&grayUnit, grayBytes, 4);
+            memcpy(&alphaUnit, alphaBytes, 4);
+            unsigned int *dstPixels = (unsigned int *)dst;
+
+            if (format == PIXELFORMAT_UNCOMPRESSED_GRAYSCALE) for (int i = 0; i < pixelCount; i++) dstPixels[i] = src[i]*grayUnit | 255*alphaUnit;
+            else if (format == PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA) for (int i = 0; i < pixelCount; i++) dstPixels[i] = src[i*2]*grayUnit | src[i*2 + 1]*alphaUnit;
+            else for (int i = 0; i < pixelCount; i++) { dst[i*4] = src[i*3]; dst[i*4 + 1] = src[i*3 + 1]; dst[i*4 + 2] = src[i*3 + 2]; dst[i*4 + 3] = 255; }
+        } break;
+        default: break;
+    }
+
+    #undef GRAY_FROM_RGB
+
+    RL_FREE(image->data);      // WARNING! We loose mipmaps data --> Regenerated at the end...
+    image->data = output;
+    image->format = newFormat;
+
+    // In case original image had mipmaps, generate mipmaps for formatted image
+    // NOTE: Original mipmaps are replaced by new ones, if custom mipmaps were used, they are lost
+    if (image->mipmaps > 1)
+    {
+        image->mipmaps = 1;
+    #if defined(SUPPORT_IMAGE_MANIPULATION)
+        ImageMipmaps(image);
+    #endif
+    }
+
+    return true;
+}
+
+// Get color converted to image format, returns bytes per pixel (0 if image can not be drawn)
+// NOTE: Conversion goes through ImageDrawPixel() on a single pixel, so it matches it for every format
+static int GetImageDrawPixel(const Image *dst, Color color, unsigned char *pixel)
+{
+    if ((dst->data == NULL) || (dst->width <= 0) || (dst->height <= 0)) return 0;
+    if (dst->format >= PIXELFORMAT_COMPRESSED_DXT1_RGB) return 0;
+
+    Image single = { pixel, 1, 1, 1, dst->format };
+    ImageDrawPixel(&single, 0, 0, color);
+
+    return GetPixelDataSize(1, 1, dst->format);
+}
+
+// Set pixel already converted to image format, out of bounds pixels are skipped
+static inline void SetImagePixel(Image *dst, int x, int y, const unsigned char *pixel, int bytesPerPixel)
+{
+    if ((x < 0) || (x >= dst->width) || (y < 0) || (y >= dst->height)) return;
+
+    unsigned char *target = (unsigned char *)dst->data + ((size_t)y*dst->width + x)*bytesPerPixel;
+    if (bytesPerPixel == 4) memcpy(target, pixel, 4);
+    else if (bytesPerPixel == 1) target[0] = pixel[0];
+    else memcpy(target, pixel, bytesPerPixel);
+}
+
+// Fill rectangle with pixel, rectangle must be inside the image
+// NOTE: Common pixel sizes are stored as whole words on every row (loops the compiler can vectorize,
+// and no per-row call for the narrow spans of vertical lines), other sizes fill the first row
+// doubling the filled part on every copy and repeat it for the rest of rows
+static void FillImageSpans(Image *dst, int posX, int posY, int width, int height, const unsigned char *pixel, int bytesPerPixel)
+{
+    if ((width <= 0) || (height <= 0)) return;
+
+    int stride = dst->width*bytesPerPixel;
+    unsigned char *row = (unsigned char *)dst->data + (size_t)posY*stride + (size_t)posX*bytesPerPixel;
+
+    switch (bytesPerPixel)
+    {
+        case 1:
+        {
+            for (int y = 0; y < height; y++, row += stride)
+            {
+                if (width == 1) row[0] = pixel[0];
+                else memset(row, pixel[0], width);
+            }
+        } break;
+        case 2:
+        {
+            unsigned short value = 0;
+            memcpy(&value, pixel, 2);
+            for (int y = 0; y < height; y++, row += stride)
+            {
+                unsigned short *span = (unsigned short *)row;
+                for (int x = 0; x < width; x++) span[x] = value;
+            }
+        } break;
+        case 4:
+        {
+            unsigned int value = 0;
+            memcpy(&value, pixel, 4);
+            for (int y = 0; y < height; y++, row += stride)
+            {
+                unsigned int *span = (unsigned int *)row;
+                for (int x = 0; x < width; x++) span[x] = value;
+            }
+        } break;
+        default:
+        {
+            memcpy(row, pixel, bytesPerPixel);
+            for (int filled = 1; filled < width; filled *= 2)
+            {
+                int count = ((width - filled) < filled)? (width - filled) : filled;
+                memcpy(row + filled*bytesPerPixel, row, count*bytesPerPixel);
+            }
+
+            for (int y = 1; y < height; y++) memcpy(row + (size_t)y*stride, row, width*bytesPerPixel);
+        } break;
+    }
+}
+
+// Clip rectangle to image and fill it with pixel
+static void FillImageRectangle(Image *dst, Rectangle rec, const unsigned char *pixel, int bytesPerPixel)
+{
+    // Security check to avoid drawing out of bounds in case of bad user data
+    if (rec.x < 0) { rec.width += rec.x; rec.x = 0; }
+    if (rec.y < 0) { rec.height += rec.y; rec.y = 0; }
+    if (rec.width < 0) rec.width = 0;
+    if (rec.height < 0) rec.height = 0;
+
+    // Clamp the size the the image bounds
+    if ((rec.x + rec.width) >= dst->width) rec.width = dst->width - rec.x;
+    if ((rec.y + rec.height) >= dst->height) rec.height = dst->height - rec.y;
+
+    // Check if the rect is even inside the image
+    if ((rec.x >= dst->width) || (rec.y >= dst->height)) return;
+    if (((rec.x + rec.width) <= 0) || (rec.y + rec.height <= 0)) return;
+
+    FillImageSpans(dst, (int)rec.x, (int)rec.y, (int)rec.width, (int)rec.height, pixel, bytesPerPixel);
+}
+
+// Draw line with pixel, axis-aligned lines are filled as spans
+static void DrawImageLine(Image *dst, int startPosX, int startPosY, int endPosX, int endPosY, const unsigned char *pixel, int bytesPerPixel)
+{
+    if ((startPosY == endPosY) || (startPosX == endPosX))
+    {
+        int minX = (startPosX < endPosX)? startPosX : endPosX;
+        int minY = (startPosY < endPosY)? startPosY : endPosY;
+        int maxX = (startPosX < endPosX)? endPosX : startPosX;
+        int maxY = (startPosY < endPosY)? endPosY : startPosY;
+
+        if ((maxX < 0) || (maxY < 0) || (minX >= dst->width) || (minY >= dst->height)) return;
+        if (minX < 0) minX = 0;
+        if (minY < 0) minY = 0;
+        if (maxX >= dst->width) maxX = dst->width - 1;
+        if (maxY >= dst->height) maxY = dst->height - 1;
+
+        FillImageSpans(dst, minX, minY, maxX - minX + 1, maxY - minY + 1, pixel, bytesPerPixel);
+        return;
+    }
+
+    // Using Bresenham's algorithm as described in
+    // Drawing Lines with Pixels - Joshua Scott - March 2012
+    // https://classic.csunplugged.org/wp-content/uploads/2014/12/Lines.pdf
+
+    int changeInX = (endPosX - startPosX);
+    int absChangeInX = (changeInX < 0)? -changeInX : changeInX;
+    int changeInY = (endPosY - startPosY);
+    int absChangeInY = (changeInY < 0)? -changeInY : changeInY;
+
+    int startU, startV, endU, stepV; // Substitutions, either U = X, V = Y or vice versa. See loop at end of function
+    //int endV;     // Not needed but left for better understanding, check code below
+    int A, B, P;    // See linked paper above, explained down in the main loop
+    int reversedXY = (absChangeInY < absChangeInX);
+
+    if (reversedXY)
+    {
+        A = 2*absChangeInY;
+        B = A - 2*absChangeInX;
+        P = A - absChangeInX;
+
+        if (changeInX > 0)
+        {
+            startU = startPosX;
+            startV = startPosY;
+            endU = endPosX;
+            //endV = endPosY;
+        }
+        else
+        {
+            startU = endPosX;
+            startV = endPosY;
+            endU = startPosX;
+            //endV = startPosY;
+
+            // Since start and end are reversed
+            changeInX = -changeInX;
+            changeInY = -changeInY;
+        }
+
+        stepV = (changeInY < 0)? -1 : 1;
+
+        SetImagePixel(dst, startU, startV, pixel, bytesPerPixel);     // At this point they are correctly ordered...
+    }
+    else
+    {
+        A = 2*absChangeInX;
+        B = A - 2*absChangeInY;
+        P = A - absChangeInY;
+
+        if (changeInY > 0)
+        {
+            startU = startPosY;
+            startV = startPosX;
+            endU = endPosY;
+            //endV = endPosX;
+        }
+        else
+        {
+            startU = endPosY;
+            startV = endPosX;
+            endU = startPosY;
+            //endV = startPosX;
+
+            // Since start and end are reversed
+            changeInX = -changeInX;
+            changeInY = -changeInY;
+        }
+
+        stepV = (changeInX < 0)? -1 : 1;
+
+        SetImagePixel(dst, startV, startU, pixel, bytesPerPixel);     // ... but need to be reversed here. Repeated in the main loop below
+    }
+
+    // We already drew the start point. If we started at startU + 0, the line would be crooked and too short
+    for (int u = startU + 1, v = startV; u <= endU; u++)
+    {
+        if (P >= 0)
+        {
+            v += stepV;     // Adjusts whenever we stray too far from the direct line. Details in the linked paper above
+            P += B;         // Remembers that we corrected our path
+        }
+        else P += A;        // Remembers how far we are from the direct line
+
+        if (reversedXY) SetImagePixel(dst, u, v, pixel, bytesPerPixel);
+        else SetImagePixel(dst, v, u, pixel, bytesPerPixel);
+    }
+}
+
+
 // From https://stackoverflow.com/questions/1659440/32-bit-to-16-bit-floating-point-conversion/60047308#60047308
 
 static float HalfToFloat(unsigned short x) {
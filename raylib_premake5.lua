@@ -16,7 +16,11 @@
 --  3. This notice may not be removed or altered from any source distribution.
 
 function platform_defines()
-    defines{"PLATFORM_DESKTOP"}
+    filter {"options:backend=glfw"}
+        defines{"PLATFORM_DESKTOP"}
+
+    filter {"options:backend=headless"}
+        defines{"PLATFORM_HEADLESS"}
 
     filter {"options:graphics=opengl43"}
         defines{"GRAPHICS_API_OPENGL_43"}
@@ -80,7 +84,13 @@ function link_raylib()
         libdirs {"../bin/%{cfg.buildcfg}"}
 
     filter "system:linux"
-        links {"pthread", "m", "dl", "rt", "X11"}
+        links {"pthread", "m", "dl", "rt"}
+
+    filter {"system:linux", "options:backend=glfw"}
+        links {"X11"}
+
+    filter {"system:linux", "options:backend=headless"}
+        links {"EGL"}
 
     filter "system:macosx"
         links {"OpenGL.framework", "Cocoa.framework", "IOKit.framework", "CoreFoundation.framework", "CoreAudio.framework", "CoreVideo.framework", "AudioToolbox.framework"}
@@ -128,6 +138,9 @@ project "raylib"
 
     removefiles {raylib_dir .. "/src/rcore_*.c"}
 
+    filter {"options:backend=headless"}
+        removefiles {raylib_dir .. "/src/rglfw.c"}
+
     filter { "system:macosx", "files:" .. raylib_dir .. "/src/rglfw.c" }
         compileas "Objective-C"
 